@@ -0,0 +1,72 @@
+// Read-only asset archive, see archive.h.
+
+#include "archive.h"
+#include <string.h>
+
+_Static_assert(sizeof(archive_header_t) == 12 && sizeof(archive_entry_t) == 48,
+               "layout must match tools/archive.py");
+
+static bool in_archive(uint32_t size, uint32_t offset, uint32_t bytes)
+{
+    return offset <= size && bytes <= size - offset && (offset & 3) == 0;
+}
+
+bool archive_open(archive_t *a, const void *base)
+{
+    const archive_header_t *h = (const archive_header_t *)base;
+    if (h->magic != ARCHIVE_MAGIC || h->version != ARCHIVE_VERSION)
+        return false;
+    uint32_t index = sizeof(*h) + h->count * (uint32_t)sizeof(archive_entry_t);
+    if (index > h->size)
+        return false;
+    const archive_entry_t *entries = (const archive_entry_t *)(h + 1);
+    // Checked once here, so lookups can trust the index.
+    for (unsigned i = 0; i < h->count; ++i)
+    {
+        const archive_entry_t *e = &entries[i];
+        if (e->name[ARCHIVE_NAME_MAX - 1] != '\0' || e->format >= ASSET_FORMAT_COUNT ||
+            e->pack > ASSET_PACK_QOI || !in_archive(h->size, e->offset, e->size) ||
+            !in_archive(h->size, e->palette_offset, e->palette_size * 2u) ||
+            (e->pack == ASSET_PACK_NONE && (uint64_t)e->stride * e->height > e->size))
+            return false;
+        if (i > 0 && strcmp(entries[i - 1].name, e->name) >= 0)
+            return false;
+    }
+    a->base = (const uint8_t *)base;
+    a->entries = entries;
+    a->count = h->count;
+    return true;
+}
+
+const archive_entry_t *archive_find(const archive_t *a, const char *name)
+{
+    unsigned lo = 0, hi = a->count;
+    while (lo < hi)
+    {
+        unsigned mid = (lo + hi) / 2;
+        int c = strncmp(name, a->entries[mid].name, ARCHIVE_NAME_MAX);
+        if (c == 0)
+            return &a->entries[mid];
+        if (c < 0)
+            hi = mid;
+        else
+            lo = mid + 1;
+    }
+    return NULL;
+}
+
+bool archive_image(const archive_t *a, const archive_entry_t *e, asset_image_t *image)
+{
+    if (!e)
+        return false;
+    image->data = a->base + e->offset;
+    image->size = e->size;
+    image->width = e->width;
+    image->height = e->height;
+    image->stride = e->stride;
+    image->format = e->format;
+    image->pack = e->pack;
+    image->palette_size = e->palette_size;
+    image->palette = e->palette_size ? (const uint16_t *)(a->base + e->palette_offset) : NULL;
+    return true;
+}
@@ -0,0 +1,79 @@
+// Read-only archive of image assets, looked up by name at runtime.
+
+// tools/archive.py packs any number of images into one file, which is
+// written to its own region of flash (see README.md) and read in place
+// through XIP: archive_image() fills in an asset_image_t pointing at the
+// pixels in flash, so nothing is copied, and the same firmware can show
+// whatever screens the archive holds. Images packed with -p rle or qoi are
+// read with asset_read_line()/asset_unpack() as usual.
+//
+// The archive starts with an archive_header_t, followed by its
+// archive_entry_t index sorted by name, then the pixel data and palettes,
+// each 4-byte aligned. Offsets are from the start of the archive and all
+// fields are little-endian. Like asset.c this only depends on the C
+// library.
+//
+//   archive_t a;
+//   asset_image_t image;
+//   if (archive_open(&a, (const void *)(XIP_BASE + ARCHIVE_FLASH_OFFSET)) &&
+//       archive_image(&a, archive_find(&a, "mario"), &image))
+//       ...
+
+#ifndef _ARCHIVE_H
+#define _ARCHIVE_H
+
+#include "asset.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ARCHIVE_MAGIC 0x41495644u // "DVIA"
+#define ARCHIVE_VERSION 1
+#define ARCHIVE_NAME_MAX 24       // including the terminating NUL
+
+typedef struct
+{
+    uint32_t magic;   // ARCHIVE_MAGIC
+    uint16_t version; // ARCHIVE_VERSION
+    uint16_t count;   // entries in the index
+    uint32_t size;    // bytes in the whole archive
+} archive_header_t;
+
+typedef struct
+{
+    char name[ARCHIVE_NAME_MAX]; // NUL-padded
+    uint32_t offset;             // of the pixel data
+    uint32_t size;               // bytes of pixel data
+    uint16_t width;
+    uint16_t height;
+    uint32_t stride;             // bytes per unpacked line
+    uint8_t format;              // asset_format_t
+    uint8_t pack;                // asset_pack_t
+    uint16_t palette_size;       // RGB565 entries, 0 for direct colour
+    uint32_t palette_offset;
+} archive_entry_t;
+
+typedef struct
+{
+    const uint8_t *base;
+    const archive_entry_t *entries;
+    unsigned count;
+} archive_t;
+
+// Check the archive at base and its index. Returns false if there is no
+// archive there or its index does not fit in it.
+bool archive_open(archive_t *a, const void *base);
+
+// The entry called name, or NULL.
+const archive_entry_t *archive_find(const archive_t *a, const char *name);
+
+// Describe entry e (which may be NULL) as an image whose pixels and palette
+// stay in the archive. Returns false for a NULL entry.
+bool archive_image(const archive_t *a, const archive_entry_t *e, asset_image_t *image);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,346 @@
+// Image asset reader and QOI encoder, see asset.h.
+
+#include "asset.h"
+#include <string.h>
+
+static unsigned unit_bytes(const asset_image_t *image)
+{
+    return image->format == ASSET_FORMAT_RGB565 ? 2 : 1;
+}
+
+static void reader_rewind(asset_reader_t *r)
+{
+    r->next = r->image->data;
+    r->line = 0;
+    r->qoi_prev = 0;
+    r->qoi_run = 0;
+    memset(r->qoi_index, 0, sizeof(r->qoi_index));
+}
+
+void asset_reader_init(asset_reader_t *r, const asset_image_t *image)
+{
+    r->image = image;
+    reader_rewind(r);
+}
+
+static bool unpack_rle_line(asset_reader_t *r, uint8_t *dst)
+{
+    const asset_image_t *image = r->image;
+    const uint8_t *src = r->next;
+    const uint8_t *end = image->data + image->size;
+    const unsigned unit = unit_bytes(image);
+    uint8_t *out = dst;
+    uint8_t *out_end = dst + image->stride;
+
+    while (out < out_end)
+    {
+        if (src >= end)
+            return false;
+        unsigned c = *src++;
+        unsigned n = c < 128 ? c + 1 : c - 126;
+        size_t bytes = (size_t)n * unit;
+        if (bytes > (size_t)(out_end - out))
+            return false;
+        if (c < 128)
+        {
+            if (bytes > (size_t)(end - src))
+                return false;
+            memcpy(out, src, bytes);
+            src += bytes;
+            out += bytes;
+        }
+        else
+        {
+            if (unit > (size_t)(end - src))
+                return false;
+            if (unit == 1)
+            {
+                memset(out, *src, n);
+                out += n;
+            }
+            else
+            {
+                for (unsigned i = 0; i < n; ++i, out += 2)
+                    memcpy(out, src, 2);
+            }
+            src += unit;
+        }
+    }
+    r->next = src;
+    return true;
+}
+
+// RGB565 p with each channel moved by a delta, wrapping.
+static unsigned rgb565_add(unsigned p, int dr, int dg, int db)
+{
+    return (((p >> 11) + dr) & 31) << 11 | (((p >> 5) + dg) & 63) << 5 | ((p + db) & 31);
+}
+
+// Apply a QOI 01xxxxxx op to p.
+static unsigned qoi_diff(unsigned p, unsigned op, asset_format_t format)
+{
+    int dr = (int)(op >> 4 & 3) - 2, dg = (int)(op >> 2 & 3) - 2, db = (int)(op & 3) - 2;
+    switch (format)
+    {
+    case ASSET_FORMAT_RGB565:
+        return rgb565_add(p, dr, dg, db);
+    case ASSET_FORMAT_RGB332:
+        return (((p >> 5) + dr) & 7) << 5 | (((p >> 2) + dg) & 7) << 2 | ((p + db) & 3);
+    default:
+        return (p + (op & 63) - 32) & 255;
+    }
+}
+
+// Apply a QOI 10gggggg rrrrbbbb op to RGB565 p.
+static unsigned qoi_luma(unsigned p, unsigned op, unsigned rb)
+{
+    int dg = (int)(op & 63) - 32;
+    return rgb565_add(p, (dg >> 1) + (int)(rb >> 4) - 8, dg, (dg >> 1) + (int)(rb & 15) - 8);
+}
+
+static bool unpack_qoi_line(asset_reader_t *r, uint8_t *dst)
+{
+    const asset_image_t *image = r->image;
+    const uint8_t *src = r->next;
+    const uint8_t *end = image->data + image->size;
+    const asset_format_t format = (asset_format_t)image->format;
+    const unsigned unit = unit_bytes(image);
+    const unsigned n = image->stride / unit;
+    uint16_t *index = r->qoi_index;
+    unsigned p = r->qoi_prev;
+    unsigned run = r->qoi_run;
+    unsigned x = 0;
+
+    while (x < n)
+    {
+        if (run)
+        {
+            unsigned k = run < n - x ? run : n - x;
+            if (unit == 1)
+            {
+                memset(dst + x, p, k);
+            }
+            else
+            {
+                uint16_t *out = (uint16_t *)dst + x;
+                for (unsigned i = 0; i < k; ++i)
+                    out[i] = p;
+            }
+            x += k;
+            run -= k;
+            continue;
+        }
+        if (src >= end)
+            return false;
+        unsigned op = *src++;
+        switch (op >> 6)
+        {
+        case 0:
+            p = index[op];
+            break;
+        case 1:
+            p = qoi_diff(p, op, format);
+            index[asset_qoi_hash(p)] = p;
+            break;
+        case 2:
+            if (unit == 1 || src >= end)
+                return false;
+            p = qoi_luma(p, op, *src++);
+            index[asset_qoi_hash(p)] = p;
+            break;
+        default:
+            if (op < 0xfe)
+            {
+                run = (op & 63) + 1;
+                continue;
+            }
+            if (op == 0xff || unit > (size_t)(end - src))
+                return false;
+            p = unit == 1 ? src[0] : src[0] | src[1] << 8;
+            src += unit;
+            index[asset_qoi_hash(p)] = p;
+            break;
+        }
+        if (unit == 1)
+            dst[x++] = p;
+        else
+            ((uint16_t *)dst)[x++] = p;
+    }
+    r->next = src;
+    r->qoi_prev = p;
+    r->qoi_run = run;
+    return true;
+}
+
+bool asset_read_line(asset_reader_t *r, void *dst)
+{
+    const asset_image_t *image = r->image;
+    bool ok = true;
+
+    if (image->pack == ASSET_PACK_RLE)
+    {
+        ok = unpack_rle_line(r, (uint8_t *)dst);
+    }
+    else if (image->pack == ASSET_PACK_QOI)
+    {
+        ok = unpack_qoi_line(r, (uint8_t *)dst);
+    }
+    else
+    {
+        memcpy(dst, r->next, image->stride);
+        r->next += image->stride;
+    }
+
+    if (!ok || ++r->line == image->height)
+        reader_rewind(r);
+    return ok;
+}
+
+bool asset_unpack(const asset_image_t *image, void *dst)
+{
+    asset_reader_t r;
+    asset_reader_init(&r, image);
+    uint8_t *out = (uint8_t *)dst;
+    for (unsigned y = 0; y < image->height; ++y, out += image->stride)
+    {
+        if (!asset_read_line(&r, out))
+            return false;
+    }
+    return true;
+}
+
+void asset_expand_indexed(const asset_image_t *image, const uint8_t *src, uint16_t *dst)
+{
+    const uint16_t *pal = image->palette;
+    if (image->format == ASSET_FORMAT_PAL4)
+    {
+        for (unsigned x = 0; x < image->width; x += 2)
+        {
+            uint8_t b = *src++;
+            dst[x] = pal[b & 0xf];
+            if (x + 1 < image->width)
+                dst[x + 1] = pal[b >> 4];
+        }
+    }
+    else
+    {
+        for (unsigned x = 0; x < image->width; ++x)
+            dst[x] = pal[src[x]];
+    }
+}
+
+void asset_qoi_encoder_init(asset_qoi_encoder_t *e, asset_format_t format)
+{
+    e->format = format;
+    e->prev = 0;
+    e->run = 0;
+    memset(e->index, 0, sizeof(e->index));
+}
+
+// d as a signed value of bits bits.
+static int wrap(int d, unsigned bits)
+{
+    int half = 1 << (bits - 1);
+    return ((d + half) & (2 * half - 1)) - half;
+}
+
+// Write the 01 or 10 op taking p to u, if there is one.
+static size_t qoi_delta(unsigned p, unsigned u, asset_format_t format, uint8_t *dst)
+{
+    if (format == ASSET_FORMAT_RGB565)
+    {
+        int dr = wrap((int)(u >> 11) - (int)(p >> 11), 5);
+        int dg = wrap((int)(u >> 5) - (int)(p >> 5), 6);
+        int db = wrap((int)u - (int)p, 5);
+        if (dr >= -2 && dr < 2 && dg >= -2 && dg < 2 && db >= -2 && db < 2)
+        {
+            dst[0] = 0x40 | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2);
+            return 1;
+        }
+        dr = wrap(dr - (dg >> 1), 5);
+        db = wrap(db - (dg >> 1), 5);
+        if (dr < -8 || dr >= 8 || db < -8 || db >= 8)
+            return 0;
+        dst[0] = 0x80 | (dg + 32);
+        dst[1] = (dr + 8) << 4 | (db + 8);
+        return 2;
+    }
+    if (format == ASSET_FORMAT_RGB332)
+    {
+        int dr = wrap((int)(u >> 5) - (int)(p >> 5), 3);
+        int dg = wrap((int)(u >> 2) - (int)(p >> 2), 3);
+        int db = wrap((int)u - (int)p, 2);
+        if (dr < -2 || dr >= 2 || dg < -2 || dg >= 2)
+            return 0;
+        dst[0] = 0x40 | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2);
+        return 1;
+    }
+    int d = wrap((int)u - (int)p, 8);
+    if (d < -32 || d >= 32)
+        return 0;
+    dst[0] = 0x40 | (d + 32);
+    return 1;
+}
+
+size_t asset_qoi_encode(asset_qoi_encoder_t *e, const void *src, uint32_t bytes, uint8_t *dst)
+{
+    const asset_format_t format = (asset_format_t)e->format;
+    const bool wide = format == ASSET_FORMAT_RGB565;
+    const uint32_t n = wide ? bytes / 2 : bytes;
+    uint8_t *out = dst;
+    unsigned p = e->prev;
+    unsigned run = e->run;
+
+    for (uint32_t x = 0; x < n; ++x)
+    {
+        unsigned u = wide ? ((const uint16_t *)src)[x] : ((const uint8_t *)src)[x];
+        if (u == p)
+        {
+            if (++run == 62)
+            {
+                *out++ = 0xc0 | 61;
+                run = 0;
+            }
+            continue;
+        }
+        if (run)
+        {
+            *out++ = 0xc0 | (run - 1);
+            run = 0;
+        }
+        unsigned h = asset_qoi_hash(u);
+        if (e->index[h] == u)
+        {
+            *out++ = h;
+        }
+        else
+        {
+            e->index[h] = u;
+            size_t k = qoi_delta(p, u, format, out);
+            if (k)
+            {
+                out += k;
+            }
+            else
+            {
+                *out++ = 0xfe;
+                *out++ = u;
+                if (wide)
+                    *out++ = u >> 8;
+            }
+        }
+        p = u;
+    }
+    e->prev = p;
+    e->run = run;
+    return out - dst;
+}
+
+size_t asset_qoi_encode_end(asset_qoi_encoder_t *e, uint8_t *dst)
+{
+    if (!e->run)
+        return 0;
+    dst[0] = 0xc0 | (e->run - 1);
+    e->run = 0;
+    return 1;
+}
@@ -0,0 +1,134 @@
+// Image assets produced by tools/imgconv.py.
+
+// The converter writes each image as a raw binary plus a small header with
+// its metadata; asset_embed() in assets/CMakeLists.txt links the binary in
+// with .incbin. Pixels are stored line by line in one of the formats below,
+// either as is or packed with a per-line run-length code, and read back a
+// line at a time with an asset_reader_t.
+//
+// ASSET_PACK_QOI is a variant of QOI (qoiformat.org) over the same pixel
+// units, for images that must stay compressed in flash: it codes the whole
+// image as one stream, so it usually packs much better than the per-line
+// run-length code, and still unpacks a line at a time.
+//
+// This file and asset.c only depend on the C library, so they can be built
+// and tested on the host.
+
+#ifndef _ASSET_H
+#define _ASSET_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The direct colour formats match dvi_format_t.
+typedef enum
+{
+    ASSET_FORMAT_RGB332, // 8 bpp
+    ASSET_FORMAT_RGB565, // 16 bpp little-endian
+    ASSET_FORMAT_PAL8,   // 8 bpp index into an RGB565 palette
+    ASSET_FORMAT_PAL4,   // 4 bpp index, first pixel in the low nibble
+    ASSET_FORMAT_COUNT
+} asset_format_t;
+
+typedef enum
+{
+    ASSET_PACK_NONE,
+    // Each line is coded separately as runs of pixel units (2 bytes for
+    // RGB565, otherwise 1 byte). A control byte c < 128 is followed by c + 1
+    // literal units; c >= 128 by one unit repeated c - 126 times.
+    ASSET_PACK_RLE,
+    // The padded lines are coded as one stream of pixel units, carrying the
+    // previous unit p (initially 0) and a table of 64 recently seen units
+    // (initially 0), indexed by asset_qoi_hash(). Each op yields one or more
+    // units:
+    //   00iiiiii      table[i]
+    //   01xxxxxx      p changed by small steps: for RGB565 and RGB332, bits
+    //                 5:4, 3:2 and 1:0 are R, G and B deltas + 2, each
+    //                 wrapping within its channel; for PAL8 and PAL4,
+    //                 p + xxxxxx - 32 modulo 256
+    //   10gggggg rrrrbbbb
+    //                 RGB565 only: green delta dg = gggggg - 32, red and
+    //                 blue deltas (dg >> 1) + rrrr - 8 and (dg >> 1) + bbbb - 8
+    //   11rrrrrr      rrrrrr + 1 copies of p, for rrrrrr < 62; runs go on
+    //                 across lines
+    //   0xfe u        the unit u follows, little-endian
+    // Every unit produced by 01, 10 and 0xfe is written to the table;
+    // 0xff is reserved.
+    ASSET_PACK_QOI,
+} asset_pack_t;
+
+// Table slot of a QOI unit.
+static inline unsigned asset_qoi_hash(unsigned unit)
+{
+    return (unit * 2654435761u) >> 26;
+}
+
+typedef struct
+{
+    const uint8_t *data;
+    uint32_t size;   // bytes at data
+    uint16_t width;
+    uint16_t height;
+    uint32_t stride; // bytes per unpacked line, a multiple of 4
+    uint8_t format;  // asset_format_t
+    uint8_t pack;    // asset_pack_t
+    uint16_t palette_size;
+    const uint16_t *palette; // RGB565, NULL for direct colour
+} asset_image_t;
+
+// Reads the lines of an image in order, unpacking as needed.
+typedef struct
+{
+    const asset_image_t *image;
+    const uint8_t *next; // start of the next line's data
+    unsigned line;       // index of the next line
+    // ASSET_PACK_QOI state, carried from line to line
+    uint16_t qoi_prev;
+    uint16_t qoi_run; // copies of qoi_prev still to write
+    uint16_t qoi_index[64];
+} asset_reader_t;
+
+void asset_reader_init(asset_reader_t *r, const asset_image_t *image);
+
+// Unpack the next line into dst (image->stride bytes, 2-byte aligned for
+// RGB565) and advance, wrapping to the first line after the last. Returns
+// false if the packed data is malformed; dst is then undefined and the
+// reader restarts at line 0.
+bool asset_read_line(asset_reader_t *r, void *dst);
+
+// Unpack the whole image into dst (stride * height bytes).
+bool asset_unpack(const asset_image_t *image, void *dst);
+
+// Expand width pixels of a PAL8/PAL4 line to RGB565.
+void asset_expand_indexed(const asset_image_t *image, const uint8_t *src, uint16_t *dst);
+
+// ASSET_PACK_QOI encoder, fed any number of whole units at a time. It makes
+// the same choices as tools/imgconv.py, so both give the same bytes.
+typedef struct
+{
+    uint8_t format; // asset_format_t
+    uint16_t prev;
+    uint16_t run; // copies of prev not yet written
+    uint16_t index[64];
+} asset_qoi_encoder_t;
+
+void asset_qoi_encoder_init(asset_qoi_encoder_t *e, asset_format_t format);
+
+// Code bytes bytes of pixel units from src (2-byte aligned for RGB565) into
+// dst, which needs room for 2 * bytes + 1. Returns the bytes written; a run
+// still going at the end is held back for the next call.
+size_t asset_qoi_encode(asset_qoi_encoder_t *e, const void *src, uint32_t bytes, uint8_t *dst);
+
+// End the stream, writing the held back run if any (at most one byte).
+size_t asset_qoi_encode_end(asset_qoi_encoder_t *e, uint8_t *dst);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
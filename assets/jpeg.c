@@ -0,0 +1,562 @@
+// Baseline JPEG decoder, see jpeg.h.
+
+#include "jpeg.h"
+#include <string.h>
+
+// Natural order index of each zigzag position.
+static const uint8_t zigzag[64] = {
+    0, 1, 8, 16, 9, 2, 3, 10,
+    17, 24, 32, 25, 18, 11, 4, 5,
+    12, 19, 26, 33, 40, 48, 41, 34,
+    27, 20, 13, 6, 7, 14, 21, 28,
+    35, 42, 49, 56, 57, 50, 43, 36,
+    29, 22, 15, 23, 30, 37, 44, 51,
+    58, 59, 52, 45, 38, 31, 39, 46,
+    53, 60, 61, 54, 47, 55, 62, 63,
+};
+
+static unsigned be16(const uint8_t *p)
+{
+    return (unsigned)p[0] << 8 | p[1];
+}
+
+// ----------------------------------------------------------------------------
+// Headers
+
+static bool read_dqt(jpeg_decoder_t *d, const uint8_t *p, unsigned len)
+{
+    while (len > 0)
+    {
+        unsigned pq = p[0] >> 4, tq = p[0] & 15;
+        unsigned bytes = 1 + 64 * (pq + 1);
+        if (pq > 1 || tq > 3 || len < bytes)
+            return false;
+        for (unsigned k = 0; k < 64; ++k)
+            d->qt[tq][k] = pq ? be16(p + 1 + 2 * k) : p[1 + k];
+        p += bytes;
+        len -= bytes;
+    }
+    return true;
+}
+
+static bool build_huffman(jpeg_huffman_t *h, const uint8_t counts[16], const uint8_t *values, unsigned n)
+{
+    memset(h->lookup_len, 0, sizeof(h->lookup_len));
+    memcpy(h->values, values, n);
+    unsigned code = 0, k = 0;
+    for (unsigned len = 1; len <= 16; ++len)
+    {
+        h->valptr[len] = (int32_t)k - (int32_t)code;
+        for (unsigned i = 0; i < counts[len - 1]; ++i, ++code, ++k)
+        {
+            if (len <= 8)
+            {
+                unsigned first = code << (8 - len);
+                for (unsigned j = 0; j < 1u << (8 - len); ++j)
+                {
+                    h->lookup_len[first + j] = len;
+                    h->lookup_val[first + j] = values[k];
+                }
+            }
+        }
+        h->maxcode[len] = counts[len - 1] ? (int32_t)code - 1 : -1;
+        // All-ones codes are reserved, so a full length is malformed.
+        if (code >= 1u << len)
+            return false;
+        code <<= 1;
+    }
+    return true;
+}
+
+static bool read_dht(jpeg_decoder_t *d, const uint8_t *p, unsigned len)
+{
+    while (len > 0)
+    {
+        if (len < 17)
+            return false;
+        unsigned tc = p[0] >> 4, th = p[0] & 15;
+        unsigned n = 0;
+        for (unsigned i = 0; i < 16; ++i)
+            n += p[1 + i];
+        if (tc > 1 || th > 1 || n > 256 || len < 17 + n)
+            return false;
+        if (!build_huffman(tc ? &d->ac[th] : &d->dc[th], p + 1, p + 17, n))
+            return false;
+        p += 17 + n;
+        len -= 17 + n;
+    }
+    return true;
+}
+
+static bool read_sof(jpeg_decoder_t *d, const uint8_t *p, unsigned len)
+{
+    if (len < 6)
+        return false;
+    d->height = be16(p + 1);
+    d->width = be16(p + 3);
+    d->components = p[5];
+    // A zero height would come later in a DNL marker.
+    if (p[0] != 8 || !d->width || !d->height || (d->components != 1 && d->components != 3) ||
+        len < 6 + 3u * d->components)
+        return false;
+    d->hmax = d->vmax = 1;
+    for (unsigned i = 0; i < d->components; ++i)
+    {
+        jpeg_component_t *c = &d->comp[i];
+        c->id = p[6 + 3 * i];
+        c->h = p[7 + 3 * i] >> 4;
+        c->v = p[7 + 3 * i] & 15;
+        c->tq = p[8 + 3 * i];
+        if (c->tq > 3 || c->h < 1 || c->h > 2 || c->v < 1 || c->v > 2)
+            return false;
+        // Chroma must be at the lowest rate.
+        if (i > 0 && (c->h != 1 || c->v != 1))
+            return false;
+    }
+    if (d->components == 1)
+        d->comp[0].h = d->comp[0].v = 1;
+    d->hmax = d->comp[0].h;
+    d->vmax = d->comp[0].v;
+    d->mcus_x = (d->width + 8 * d->hmax - 1) / (8 * d->hmax);
+    d->mcus_y = (d->height + 8 * d->vmax - 1) / (8 * d->vmax);
+    return true;
+}
+
+static bool read_sos(jpeg_decoder_t *d, const uint8_t *p, unsigned len)
+{
+    // Only a single scan interleaving every component.
+    if (len < 1 || p[0] != d->components || len < 4 + 2u * p[0])
+        return false;
+    for (unsigned i = 0; i < d->components; ++i)
+    {
+        jpeg_component_t *c = &d->comp[i];
+        if (p[1 + 2 * i] != c->id)
+            return false;
+        c->td = p[2 + 2 * i] >> 4;
+        c->ta = p[2 + 2 * i] & 15;
+        if (c->td > 1 || c->ta > 1)
+            return false;
+        c->dc_pred = 0;
+    }
+    const uint8_t *s = p + 1 + 2 * d->components;
+    return s[0] == 0 && s[1] == 63 && s[2] == 0;
+}
+
+bool jpeg_open(jpeg_decoder_t *d, const uint8_t *data, uint32_t size)
+{
+    memset(d, 0, sizeof(*d));
+    const uint8_t *p = data, *end = data + size;
+    if (size < 4 || p[0] != 0xFF || p[1] != 0xD8)
+        return false;
+    p += 2;
+    bool have_frame = false;
+    for (;;)
+    {
+        if (end - p < 4 || p[0] != 0xFF)
+            return false;
+        unsigned marker = p[1];
+        if (marker == 0xFF)
+        {
+            ++p; // fill byte
+            continue;
+        }
+        unsigned len = be16(p + 2);
+        if (len < 2 || (unsigned)(end - p) < 2 + len)
+            return false;
+        const uint8_t *seg = p + 4;
+        len -= 2;
+        p += 2 + 2 + len;
+        bool ok = true;
+        switch (marker)
+        {
+        case 0xC0: // baseline
+        case 0xC1: // extended sequential, Huffman
+            ok = read_sof(d, seg, len);
+            have_frame = ok;
+            break;
+        case 0xC4:
+            ok = read_dht(d, seg, len);
+            break;
+        case 0xDB:
+            ok = read_dqt(d, seg, len);
+            break;
+        case 0xDD:
+            ok = len >= 2;
+            if (ok)
+                d->restart_interval = be16(seg);
+            break;
+        case 0xDA:
+            if (!have_frame || !read_sos(d, seg, len))
+                return false;
+            d->pos = p;
+            d->end = end;
+            d->restarts_left = d->restart_interval;
+            return true;
+        default:
+            // Other frame types are unsupported; APPn, COM and the rest
+            // are skipped.
+            if (marker >= 0xC0 && marker <= 0xCF)
+                return false;
+            break;
+        }
+        if (!ok)
+            return false;
+    }
+}
+
+unsigned jpeg_band_lines(const jpeg_decoder_t *d)
+{
+    return 8u * d->vmax;
+}
+
+// ----------------------------------------------------------------------------
+// Entropy decoding
+
+// Top up the bit buffer to at least 25 bits. Stuffed zero bytes after 0xFF
+// are dropped; at a marker, or past the end, zeros are read instead.
+static void fill(jpeg_decoder_t *d)
+{
+    while (d->nbits <= 24)
+    {
+        uint32_t b = 0;
+        if (!d->marker && d->pos < d->end)
+        {
+            b = *d->pos;
+            if (b != 0xFF)
+            {
+                ++d->pos;
+            }
+            else if (d->pos + 1 < d->end && d->pos[1] == 0)
+            {
+                d->pos += 2;
+            }
+            else
+            {
+                d->marker = true;
+                b = 0;
+            }
+        }
+        d->bits |= b << (24 - d->nbits);
+        d->nbits += 8;
+    }
+}
+
+static void consume(jpeg_decoder_t *d, unsigned n)
+{
+    d->bits <<= n;
+    d->nbits -= n;
+}
+
+static int decode_huffman(jpeg_decoder_t *d, const jpeg_huffman_t *h)
+{
+    fill(d);
+    unsigned look = d->bits >> 24;
+    unsigned len = h->lookup_len[look];
+    if (len)
+    {
+        consume(d, len);
+        return h->lookup_val[look];
+    }
+    for (len = 9; len <= 16; ++len)
+    {
+        int32_t code = d->bits >> (32 - len);
+        if (code <= h->maxcode[len])
+        {
+            consume(d, len);
+            return h->values[(h->valptr[len] + code) & 0xFF];
+        }
+    }
+    return -1;
+}
+
+// s bits of a coefficient, sign-extended (F.2.2.1).
+static int receive_extend(jpeg_decoder_t *d, unsigned s)
+{
+    if (!s)
+        return 0;
+    fill(d);
+    int v = d->bits >> (32 - s);
+    consume(d, s);
+    return v < 1 << (s - 1) ? v - (1 << s) + 1 : v;
+}
+
+// Coefficients of 8-bit images stay within +-1024 plus rounding, before
+// and after dequantisation. Clamping corrupt ones, and the first IDCT
+// pass's output, keeps the 32-bit arithmetic from overflowing.
+#define COEF_MAX 2047
+#define PASS1_MAX 8191
+
+static int32_t clamp_coef(int32_t v)
+{
+    return v < -COEF_MAX ? -COEF_MAX : v > COEF_MAX ? COEF_MAX : v;
+}
+
+// Decode one block into d->block; returns the zigzag index of its last
+// coefficient (0 for DC only), or -1.
+static int decode_block(jpeg_decoder_t *d, jpeg_component_t *c)
+{
+    const uint16_t *q = d->qt[c->tq];
+    int32_t *blk = d->block;
+    memset(blk, 0, sizeof(d->block));
+
+    int t = decode_huffman(d, &d->dc[c->td]);
+    if (t < 0 || t > 11)
+        return -1;
+    c->dc_pred = clamp_coef(c->dc_pred + receive_extend(d, t));
+    blk[0] = clamp_coef(c->dc_pred * q[0]);
+
+    int last = 0;
+    for (unsigned k = 1; k < 64;)
+    {
+        int rs = decode_huffman(d, &d->ac[c->ta]);
+        if (rs < 0)
+            return -1;
+        unsigned r = rs >> 4, s = rs & 15;
+        if (!s)
+        {
+            if (r != 15)
+                break; // end of block
+            k += 16;
+            continue;
+        }
+        k += r;
+        if (k > 63)
+            return -1;
+        blk[zigzag[k]] = clamp_coef(clamp_coef(receive_extend(d, s)) * q[k]);
+        last = k++;
+    }
+    return last;
+}
+
+// ----------------------------------------------------------------------------
+// Inverse DCT: the accurate integer algorithm of the IJG library (Loeffler,
+// Ligtenberg and Moschytz), columns then rows.
+
+#define CONST_BITS 13
+#define PASS1_BITS 2
+#define FIX(x) ((int32_t)((x) * (1 << CONST_BITS) + 0.5))
+#define DESCALE(x, n) (((x) + (1 << ((n) - 1))) >> (n))
+
+static uint8_t clamp_sample(int32_t v)
+{
+    return v < 0 ? 0 : v > 255 ? 255 : (uint8_t)v;
+}
+
+static int32_t clamp_pass1(int32_t v)
+{
+    return v < -PASS1_MAX ? -PASS1_MAX : v > PASS1_MAX ? PASS1_MAX : v;
+}
+
+// Even and odd halves of the 1-D IDCT of in[0], in[s], ... in[7s].
+#define IDCT_1D(in, s, shift_even)                                           \
+    int32_t z2 = in[2 * s], z3 = in[6 * s];                                  \
+    int32_t z1 = (z2 + z3) * FIX(0.541196100);                               \
+    int32_t tmp2 = z1 - z3 * FIX(1.847759065);                               \
+    int32_t tmp3 = z1 + z2 * FIX(0.765366865);                               \
+    int32_t tmp0 = (in[0] + in[4 * s]) * (1 << (shift_even));                \
+    int32_t tmp1 = (in[0] - in[4 * s]) * (1 << (shift_even));                \
+    int32_t tmp10 = tmp0 + tmp3, tmp13 = tmp0 - tmp3;                        \
+    int32_t tmp11 = tmp1 + tmp2, tmp12 = tmp1 - tmp2;                        \
+    tmp0 = in[7 * s];                                                        \
+    tmp1 = in[5 * s];                                                        \
+    tmp2 = in[3 * s];                                                        \
+    tmp3 = in[1 * s];                                                        \
+    z1 = tmp0 + tmp3;                                                        \
+    z2 = tmp1 + tmp2;                                                        \
+    z3 = tmp0 + tmp2;                                                        \
+    int32_t z4 = tmp1 + tmp3;                                                \
+    int32_t z5 = (z3 + z4) * FIX(1.175875602);                               \
+    tmp0 *= FIX(0.298631336);                                                \
+    tmp1 *= FIX(2.053119869);                                                \
+    tmp2 *= FIX(3.072711026);                                                \
+    tmp3 *= FIX(1.501321110);                                                \
+    z1 *= -FIX(0.899976223);                                                 \
+    z2 *= -FIX(2.562915447);                                                 \
+    z3 = z3 * -FIX(1.961570560) + z5;                                        \
+    z4 = z4 * -FIX(0.390180644) + z5;                                        \
+    tmp0 += z1 + z3;                                                         \
+    tmp1 += z2 + z4;                                                         \
+    tmp2 += z2 + z3;                                                         \
+    tmp3 += z1 + z4;
+
+static void idct(const int32_t *in, uint8_t *out, unsigned stride)
+{
+    int32_t ws[64];
+    for (unsigned x = 0; x < 8; ++x)
+    {
+        const int32_t *col = in + x;
+        int32_t *w = ws + x;
+        if (!(col[8] | col[16] | col[24] | col[32] | col[40] | col[48] | col[56]))
+        {
+            int32_t dc = col[0] * (1 << PASS1_BITS);
+            for (unsigned y = 0; y < 8; ++y)
+                w[8 * y] = dc;
+            continue;
+        }
+        IDCT_1D(col, 8, CONST_BITS)
+        const unsigned n = CONST_BITS - PASS1_BITS;
+        w[0] = clamp_pass1(DESCALE(tmp10 + tmp3, n));
+        w[56] = clamp_pass1(DESCALE(tmp10 - tmp3, n));
+        w[8] = clamp_pass1(DESCALE(tmp11 + tmp2, n));
+        w[48] = clamp_pass1(DESCALE(tmp11 - tmp2, n));
+        w[16] = clamp_pass1(DESCALE(tmp12 + tmp1, n));
+        w[40] = clamp_pass1(DESCALE(tmp12 - tmp1, n));
+        w[24] = clamp_pass1(DESCALE(tmp13 + tmp0, n));
+        w[32] = clamp_pass1(DESCALE(tmp13 - tmp0, n));
+    }
+    for (unsigned y = 0; y < 8; ++y, out += stride)
+    {
+        const int32_t *row = ws + 8 * y;
+        IDCT_1D(row, 1, CONST_BITS)
+        const unsigned n = CONST_BITS + PASS1_BITS + 3;
+        out[0] = clamp_sample(DESCALE(tmp10 + tmp3, n) + 128);
+        out[7] = clamp_sample(DESCALE(tmp10 - tmp3, n) + 128);
+        out[1] = clamp_sample(DESCALE(tmp11 + tmp2, n) + 128);
+        out[6] = clamp_sample(DESCALE(tmp11 - tmp2, n) + 128);
+        out[2] = clamp_sample(DESCALE(tmp12 + tmp1, n) + 128);
+        out[5] = clamp_sample(DESCALE(tmp12 - tmp1, n) + 128);
+        out[3] = clamp_sample(DESCALE(tmp13 + tmp0, n) + 128);
+        out[4] = clamp_sample(DESCALE(tmp13 - tmp0, n) + 128);
+    }
+}
+
+// The IDCT of a block with only a DC coefficient is flat.
+static void idct_dc(int32_t dc, uint8_t *out, unsigned stride)
+{
+    uint8_t v = clamp_sample(DESCALE(dc * (1 << PASS1_BITS), PASS1_BITS + 3) + 128);
+    for (unsigned y = 0; y < 8; ++y, out += stride)
+        memset(out, v, 8);
+}
+
+// ----------------------------------------------------------------------------
+// MCUs and bands
+
+static bool restart(jpeg_decoder_t *d)
+{
+    // Drop the rest of the interval's bits and find the marker.
+    while (!d->marker && d->pos < d->end)
+    {
+        d->bits = 0;
+        d->nbits = 0;
+        fill(d);
+    }
+    if (!d->marker || d->pos + 1 >= d->end || d->pos[1] != 0xD0 + d->next_rst)
+        return false;
+    d->pos += 2;
+    d->marker = false;
+    d->bits = 0;
+    d->nbits = 0;
+    d->next_rst = (d->next_rst + 1) & 7;
+    d->restarts_left = d->restart_interval;
+    for (unsigned i = 0; i < d->components; ++i)
+        d->comp[i].dc_pred = 0;
+    return true;
+}
+
+static bool decode_mcu(jpeg_decoder_t *d)
+{
+    if (d->restart_interval)
+    {
+        if (!d->restarts_left && !restart(d))
+            return false;
+        --d->restarts_left;
+    }
+    for (unsigned i = 0; i < d->components; ++i)
+    {
+        jpeg_component_t *c = &d->comp[i];
+        unsigned stride = 8u * c->h;
+        for (unsigned by = 0; by < c->v; ++by)
+        {
+            for (unsigned bx = 0; bx < c->h; ++bx)
+            {
+                uint8_t *out = d->planes[i] + 8 * by * stride + 8 * bx;
+                int last = decode_block(d, c);
+                if (last < 0)
+                    return false;
+                if (last == 0)
+                    idct_dc(d->block[0], out, stride);
+                else
+                    idct(d->block, out, stride);
+            }
+        }
+    }
+    return true;
+}
+
+// JFIF YCbCr to RGB in 16-bit fixed point.
+#define CR_R 91881  // 1.402
+#define CB_G 22554  // 0.344136
+#define CR_G 46802  // 0.714136
+#define CB_B 116130 // 1.772
+
+static void put_pixel(uint8_t *line, unsigned x, int y, int cb, int cr, asset_format_t format)
+{
+    unsigned r = clamp_sample(y + ((CR_R * cr + 32768) >> 16));
+    unsigned g = clamp_sample(y + ((-CB_G * cb - CR_G * cr + 32768) >> 16));
+    unsigned b = clamp_sample(y + ((CB_B * cb + 32768) >> 16));
+    if (format == ASSET_FORMAT_RGB565)
+    {
+        uint16_t p = (r & 0xF8) << 8 | (g & 0xFC) << 3 | b >> 3;
+        line[2 * x] = (uint8_t)p;
+        line[2 * x + 1] = (uint8_t)(p >> 8);
+    }
+    else
+    {
+        line[x] = (uint8_t)((r & 0xE0) | (g & 0xE0) >> 3 | b >> 6);
+    }
+}
+
+// Colour convert the MCU at column mx into the band at dst.
+static void write_mcu(jpeg_decoder_t *d, unsigned mx, unsigned lines, uint8_t *dst, uint32_t stride,
+                      asset_format_t format)
+{
+    const unsigned mcu_w = 8u * d->hmax;
+    const unsigned x0 = mx * mcu_w;
+    const unsigned w = d->width - x0 < mcu_w ? d->width - x0 : mcu_w;
+    const unsigned hshift = d->hmax - 1, vshift = d->vmax - 1;
+    for (unsigned y = 0; y < lines; ++y, dst += stride)
+    {
+        const uint8_t *luma = d->planes[0] + y * mcu_w;
+        if (d->components == 1)
+        {
+            for (unsigned x = 0; x < w; ++x)
+                put_pixel(dst, x0 + x, luma[x], 0, 0, format);
+            continue;
+        }
+        const uint8_t *cb = d->planes[1] + (y >> vshift) * 8;
+        const uint8_t *cr = d->planes[2] + (y >> vshift) * 8;
+        for (unsigned x = 0; x < w; ++x)
+            put_pixel(dst, x0 + x, luma[x], cb[x >> hshift] - 128, cr[x >> hshift] - 128, format);
+    }
+}
+
+int jpeg_decode_band(jpeg_decoder_t *d, void *dst, uint32_t stride, asset_format_t format)
+{
+    if (d->failed)
+        return -1;
+    if (d->mcu_row == d->mcus_y)
+        return 0;
+    const unsigned band = jpeg_band_lines(d);
+    const unsigned y0 = d->mcu_row * band;
+    const unsigned lines = d->height - y0 < band ? d->height - y0 : band;
+    for (unsigned mx = 0; mx < d->mcus_x; ++mx)
+    {
+        if (!decode_mcu(d))
+        {
+            d->failed = true;
+            return -1;
+        }
+        write_mcu(d, mx, lines, (uint8_t *)dst, stride, format);
+    }
+    ++d->mcu_row;
+    return (int)lines;
+}
+
+bool jpeg_decode(jpeg_decoder_t *d, void *dst, uint32_t stride, asset_format_t format)
+{
+    uint8_t *out = (uint8_t *)dst;
+    int lines;
+    while ((lines = jpeg_decode_band(d, out, stride, format)) > 0)
+        out += (size_t)lines * stride;
+    return lines == 0;
+}
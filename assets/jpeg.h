@@ -0,0 +1,92 @@
+// Baseline JPEG decoder writing RGB332 or RGB565 straight into a
+// framebuffer.
+
+// Decodes sequential Huffman-coded JPEGs (SOF0/SOF1) with 8-bit samples:
+// greyscale, or YCbCr with luma sampled 1x1, 2x1, 1x2 or 2x2 against
+// chroma (4:4:4, 4:2:2, 4:4:0 and 4:2:0), with or without restart markers.
+// Progressive and arithmetic-coded files are refused.
+//
+// The image is decoded one MCU row (a band of 8 or 16 lines) per call, and
+// each MCU is colour converted and written to the destination as soon as
+// its blocks are decoded, so the whole working set is the jpeg_decoder_t
+// (about 5 KB) and no line buffers. Chroma is upsampled by replication.
+// Like asset.c this only depends on the C library.
+//
+//   jpeg_decoder_t d;
+//   if (jpeg_open(&d, Mario_jpg, Mario_jpg_end - Mario_jpg))
+//       jpeg_decode(&d, framebuf, 640, ASSET_FORMAT_RGB332);
+
+#ifndef _JPEG_H
+#define _JPEG_H
+
+#include "asset.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct
+{
+    uint8_t lookup_len[256]; // code length by the next 8 bits, 0 if longer
+    uint8_t lookup_val[256];
+    int32_t maxcode[17];     // largest code of each length, -1 if none
+    int32_t valptr[17];      // values[] index of a code of each length, less the code
+    uint8_t values[256];
+} jpeg_huffman_t;
+
+typedef struct
+{
+    uint8_t id;
+    uint8_t h, v;   // sampling factors
+    uint8_t tq;     // quantisation table
+    uint8_t td, ta; // DC and AC Huffman tables
+    int dc_pred;
+} jpeg_component_t;
+
+typedef struct
+{
+    const uint8_t *pos;
+    const uint8_t *end;
+    uint32_t bits; // next bits of entropy-coded data, MSB first
+    int nbits;
+    bool marker;   // pos is at a marker; the bits after it read as zero
+
+    uint16_t width, height;
+    uint8_t components;
+    uint8_t hmax, vmax;
+    uint16_t mcus_x, mcus_y;
+    uint16_t mcu_row; // next MCU row to decode
+    uint16_t restart_interval;
+    uint16_t restarts_left;
+    uint8_t next_rst;
+    bool failed;
+
+    jpeg_component_t comp[3];
+    uint16_t qt[4][64]; // in zigzag order
+    jpeg_huffman_t dc[2], ac[2];
+    int32_t block[64];
+    uint8_t planes[3][256]; // one MCU of samples per component
+} jpeg_decoder_t;
+
+// Parse the headers up to the start of the image data. Returns false for
+// malformed or unsupported files.
+bool jpeg_open(jpeg_decoder_t *d, const uint8_t *data, uint32_t size);
+
+// Lines per band: 8 times the vertical luma sampling factor.
+unsigned jpeg_band_lines(const jpeg_decoder_t *d);
+
+// Decode the next band into dst, whose lines are stride bytes apart, as
+// format (ASSET_FORMAT_RGB332 or ASSET_FORMAT_RGB565). Writes width pixels
+// per line. Returns the lines written, which is fewer than
+// jpeg_band_lines() only at the bottom of the image, 0 when the image is
+// done and -1 if the data is malformed.
+int jpeg_decode_band(jpeg_decoder_t *d, void *dst, uint32_t stride, asset_format_t format);
+
+// Decode every remaining band into consecutive lines from dst.
+bool jpeg_decode(jpeg_decoder_t *d, void *dst, uint32_t stride, asset_format_t format);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,22 @@
+// Scanout robustness benchmark, see bench_bus.c, JPEG decode benchmark,
+// see bench_jpeg.c, and scanline callback timing, see bench_lines.c.
+
+#ifndef _BENCH_H
+#define _BENCH_H
+
+#include "dvi_hstx.h"
+#include "jpeg.h"
+#include "scanout_stats.h"
+
+// Runs the benchmark on core 0 and never returns. framebuffer is only used
+// to report where the displayed image lives.
+void bench_run(const void *framebuffer);
+
+// Decode jpeg into dst a few times and report time and peak RAM.
+bool bench_jpeg(const uint8_t *jpeg, uint32_t size, void *dst, uint32_t stride, asset_format_t format);
+
+// Render every active line with cb on the calling core and report the mean
+// and slowest time per line against the line period.
+void bench_lines(const char *name, dvi_scanline_cb_t cb, void *user);
+
+#endif
@@ -0,0 +1,330 @@
+// Bus-contention benchmark for the DVI scanout.
+
+// Core 1 keeps scanning out as usual while core 0 runs memcpy, random
+// access and flash XIP load patterns at increasing duty cycles. For every
+// bus priority setting, framebuffer placement and staging buffer placement,
+// the DMA IRQ statistics from scanout_stats.h are reported along with the
+// lowest load intensity at which the HSTX FIFO was seen to run dry.
+//
+// The framebuffer is the one the application set, then a copy of its top
+// lines in striped SRAM scanned out directly and staged. The unstriped
+// banks are the 4 KiB scratch banks, already holding the IRQ, the stacks
+// and the line buffers, so a framebuffer cannot be given a bank of its own.
+
+#include "bench.h"
+#include "dvi_hstx.h"
+#include "hardware/clocks.h"
+#include "hardware/structs/bus_ctrl.h"
+#include "sram_banks.h"
+#include "stdio.h"
+
+// Length of one measurement, and of the window the load duty cycle is
+// applied over.
+#define BENCH_RUN_MS 500
+#define BENCH_WINDOW_US 50
+
+static uint32_t load_src[4096];
+static uint32_t load_dst[4096];
+static uint32_t load_random[16384];
+
+typedef struct
+{
+    const char *name;
+    uint32_t bits;
+} bench_priority_t;
+
+static const bench_priority_t priorities[] = {
+    {"none", 0},
+    {"dma_r", BUSCTRL_BUS_PRIORITY_DMA_R_BITS},
+    {"dma_w", BUSCTRL_BUS_PRIORITY_DMA_W_BITS},
+    {"dma_rw", BUSCTRL_BUS_PRIORITY_DMA_R_BITS | BUSCTRL_BUS_PRIORITY_DMA_W_BITS},
+    {"dma_rw+proc1", BUSCTRL_BUS_PRIORITY_DMA_R_BITS | BUSCTRL_BUS_PRIORITY_DMA_W_BITS | BUSCTRL_BUS_PRIORITY_PROC1_BITS},
+};
+
+typedef struct
+{
+    const char *name;
+    char *buf;
+} bench_placement_t;
+
+// Filled in by bench_run(): the default staging buffer from the scratch_y
+// arena, and an alternative from the striped SRAM arena.
+static bench_placement_t placements[] = {
+    {"sram", NULL},
+    {"scratch_y", NULL},
+};
+
+// Lines of the copy in striped SRAM, repeated down the screen; the DMA
+// reads a line per line either way.
+#define BENCH_FB_LINES 120
+static uint8_t __attribute__((aligned(4))) sram_fb[640 * BENCH_FB_LINES];
+
+typedef struct
+{
+    const char *name;
+    const void *pixels; // NULL for the application's source, left as set
+    uint32_t flags;     // DVI_FB_*
+} bench_framebuffer_t;
+
+static const bench_framebuffer_t framebuffers[] = {
+    {"app", NULL, 0},
+    {"sram_direct", sram_fb, 0},
+    {"sram_staged", sram_fb, DVI_FB_STAGED},
+};
+
+typedef void (*bench_load_fn)(uint32_t deadline);
+
+static void load_memcpy(uint32_t deadline)
+{
+    // 1 KiB blocks keep the deadline overshoot well below one window.
+    static uint offset = 0;
+    while ((int32_t)(sio_hw->mtime - deadline) < 0)
+    {
+        memcpy(&load_dst[offset], &load_src[offset], 1024);
+        offset = (offset + 256) & (count_of(load_src) - 1);
+    }
+}
+
+static void load_random_access(uint32_t deadline)
+{
+    static uint32_t x = 0x12345678u;
+    while ((int32_t)(sio_hw->mtime - deadline) < 0)
+    {
+        for (int i = 0; i < 64; ++i)
+        {
+            // xorshift32
+            x ^= x << 13;
+            x ^= x >> 17;
+            x ^= x << 5;
+            load_random[x & (count_of(load_random) - 1)] += x;
+        }
+    }
+}
+
+static void load_flash_xip(uint32_t deadline)
+{
+    // The no-cache, no-allocate alias makes every read go out to QSPI.
+    static uint32_t offset = 0;
+    volatile const uint32_t *flash = (volatile const uint32_t *)XIP_NOCACHE_NOALLOC_BASE;
+    uint32_t sum = 0;
+    while ((int32_t)(sio_hw->mtime - deadline) < 0)
+    {
+        for (int i = 0; i < 64; ++i)
+        {
+            sum += flash[offset];
+            offset = (offset + 8) & (256 * 1024 / 4 - 1);
+        }
+    }
+    load_dst[0] = sum;
+}
+
+typedef struct
+{
+    const char *name;
+    bench_load_fn fn;
+} bench_load_t;
+
+static const bench_load_t loads[] = {
+    {"memcpy", load_memcpy},
+    {"random", load_random_access},
+    {"flash_xip", load_flash_xip},
+};
+
+static const uint intensities[] = {0, 25, 50, 75, 100};
+
+// Count contested accesses on the SRAM bank(s) holding buf. The bus fabric
+// counters are not per master, but with core 1 asleep outside the IRQ these
+// are almost all DMA reads of the staging buffer colliding with core 0.
+// Returns the number of counters in use.
+static uint select_bank_counters(const void *buf)
+{
+    static const uint32_t striped_lo[] = {
+        arbiter_sram0_perf_event_access_contested, arbiter_sram1_perf_event_access_contested,
+        arbiter_sram2_perf_event_access_contested, arbiter_sram3_perf_event_access_contested};
+    static const uint32_t striped_hi[] = {
+        arbiter_sram4_perf_event_access_contested, arbiter_sram5_perf_event_access_contested,
+        arbiter_sram6_perf_event_access_contested, arbiter_sram7_perf_event_access_contested};
+    uintptr_t a = (uintptr_t)buf;
+    const uint32_t *events;
+    uint n;
+
+    if (a >= SRAM9_BASE)
+    {
+        bus_ctrl_hw->counter[0].sel = arbiter_sram9_perf_event_access_contested;
+        n = 1;
+    }
+    else if (a >= SRAM8_BASE)
+    {
+        bus_ctrl_hw->counter[0].sel = arbiter_sram8_perf_event_access_contested;
+        n = 1;
+    }
+    else
+    {
+        events = a >= SRAM_STRIPED_HI_BASE ? striped_hi : striped_lo;
+        for (uint i = 0; i < 4; ++i)
+            bus_ctrl_hw->counter[i].sel = events[i];
+        n = 4;
+    }
+    bus_ctrl_hw->perfctr_en = BUSCTRL_PERFCTR_EN_BITS;
+    return n;
+}
+
+static uint32_t read_bank_counters(uint n)
+{
+    uint32_t sum = 0;
+    for (uint i = 0; i < n; ++i)
+        sum += bus_ctrl_hw->counter[i].value;
+    return sum;
+}
+
+static void clear_bank_counters(void)
+{
+    // Any write clears a counter.
+    for (uint i = 0; i < 4; ++i)
+        bus_ctrl_hw->counter[i].value = 0;
+}
+
+static void run_load(const bench_load_t *load, uint intensity, uint32_t cycles_per_us)
+{
+    uint32_t window = BENCH_WINDOW_US * cycles_per_us;
+    uint32_t busy = window * intensity / 100;
+    uint32_t end = time_us_32() + BENCH_RUN_MS * 1000;
+
+    scanout_stats_reset = true;
+    while (scanout_stats_reset)
+        tight_loop_contents();
+    clear_bank_counters();
+    while ((int32_t)(time_us_32() - end) < 0)
+    {
+        uint32_t start = sio_hw->mtime;
+        if (busy)
+            load->fn(start + busy);
+        // Idle for the rest of the window spinning on SIO, which does not
+        // touch the SRAM or XIP buses.
+        while ((int32_t)(sio_hw->mtime - (start + window)) < 0)
+            tight_loop_contents();
+    }
+}
+
+static const char *region_name(const void *p)
+{
+    uintptr_t a = (uintptr_t)p;
+    if (a >= SRAM8_BASE && a < SRAM9_BASE)
+        return "scratch_x";
+    if (a >= SRAM9_BASE && a < SRAM_END)
+        return "scratch_y";
+    if (a >= SRAM_BASE && a < SRAM8_BASE)
+        return "sram";
+    return "flash";
+}
+
+// The top of what is on show as RGB332 lines in sram_fb, or bars if it is
+// not an RGB332 framebuffer.
+static void fill_sram_fb(uint width)
+{
+    dvi_view_t view;
+    bool copy = dvi_get_view(&view) && view.format == DVI_FORMAT_RGB332 && !view.line_table;
+    for (uint y = 0; y < BENCH_FB_LINES; ++y)
+    {
+        for (uint x = 0; x < width; ++x)
+        {
+            sram_fb[y * width + x] =
+                copy ? view.pixels[(y % view.lines) * view.stride + x] : (uint8_t)(x / (width / 8) * 0x25);
+        }
+    }
+}
+
+// Put framebuffer f on show, or leave the application's.
+static void show_framebuffer(const bench_framebuffer_t *f, uint width)
+{
+    if (!f->pixels)
+        return;
+    dvi_framebuffer_t fb = {
+        .pixels = f->pixels,
+        .format = DVI_FORMAT_RGB332,
+        .lines = BENCH_FB_LINES,
+        .stride = width,
+        .flags = f->flags,
+    };
+    dvi_set_framebuffer(&fb);
+    // Measure from the first frame showing it.
+    dvi_wait_vblank();
+}
+
+// Every load at every intensity with the staging buffer in b. A direct
+// framebuffer does not use the staging buffer, so it is run once.
+static void run_placement(const bench_framebuffer_t *f, const bench_priority_t *p, const bench_placement_t *b,
+                          uint32_t cycles_per_us)
+{
+    if (!b->buf)
+        return;
+    bool direct = f->pixels && !(f->flags & DVI_FB_STAGED);
+    if (direct && b != &placements[0] && placements[0].buf)
+        return;
+    const char *linebuf = direct ? "-" : b->name;
+    scanline_buf = b->buf;
+    uint counters = select_bank_counters(direct ? f->pixels : b->buf);
+    for (uint l = 0; l < count_of(loads); ++l)
+    {
+        int threshold = -1;
+        for (uint i = 0; i < count_of(intensities); ++i)
+        {
+            run_load(&loads[l], intensities[i], cycles_per_us);
+            uint32_t contested = read_bank_counters(counters);
+            scanout_stats_t s = scanout_stats;
+            uint32_t jitter = s.line_max_cycles >= s.line_min_cycles ? s.line_max_cycles - s.line_min_cycles : 0;
+            printf("%-13s %-12s %-10s %-10s %3u%%  %5lu  %5lu  %6lu  %10lu  %14lu  %9lu\n", p->name, f->name, linebuf,
+                   loads[l].name, intensities[i], (unsigned long)s.irqs, (unsigned long)s.fifo_empty,
+                   (unsigned long)s.fifo_min_level, (unsigned long)(s.irq_max_cycles * 1000 / cycles_per_us),
+                   (unsigned long)(jitter * 1000 / cycles_per_us), (unsigned long)contested);
+            if (s.fifo_empty && threshold < 0)
+                threshold = intensities[i];
+        }
+        if (threshold < 0)
+            printf("# %s/%s/%s/%s: no underflow up to 100%%\n", p->name, f->name, linebuf, loads[l].name);
+        else
+            printf("# %s/%s/%s/%s: underflow from %d%% duty\n", p->name, f->name, linebuf, loads[l].name,
+                   threshold);
+    }
+}
+
+void bench_run(const void *framebuffer)
+{
+    uint32_t cycles_per_us = clock_get_hz(clk_sys) / 1000000;
+    uint32_t default_priority = bus_ctrl_hw->priority;
+    char *default_buf = scanline_buf;
+    uint width = dvi_get_mode()->h_active_pixels;
+    hard_assert(width <= 640);
+
+    placements[0].buf = vmem_alloc(&vmem_main, width * sizeof(uint16_t), 4);
+    placements[1].buf = default_buf;
+    if (!placements[0].buf)
+        printf("# no room for a staging buffer in striped SRAM, skipping it\n");
+    fill_sram_fb(width);
+
+    for (uint i = 0; i < count_of(load_src); ++i)
+        load_src[i] = i * 0x9e3779b9u;
+
+    printf("# bus contention bench: clk_sys=%lu Hz, framebuffer in %s, %u ms per run\n",
+           (unsigned long)clock_get_hz(clk_sys), region_name(framebuffer), BENCH_RUN_MS);
+    printf("priority      framebuffer  linebuf    load       duty  irqs   empty  minlvl  irq_max_ns  line_jitter_ns  "
+           "contested\n");
+    for (uint f = 0; f < count_of(framebuffers); ++f)
+    {
+        show_framebuffer(&framebuffers[f], width);
+        for (uint p = 0; p < count_of(priorities); ++p)
+        {
+            bus_ctrl_hw->priority = priorities[p].bits;
+            while (bus_ctrl_hw->priority_ack == 0)
+                tight_loop_contents();
+            for (uint b = 0; b < count_of(placements); ++b)
+                run_placement(&framebuffers[f], &priorities[p], &placements[b], cycles_per_us);
+        }
+    }
+
+    bus_ctrl_hw->priority = default_priority;
+    scanline_buf = default_buf;
+    printf("# bench done\n");
+    while (1)
+        __wfi();
+}
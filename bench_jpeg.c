@@ -0,0 +1,142 @@
+// JPEG decode benchmark: time and peak RAM of assets/jpeg.c.
+
+// Decodes an image a few times into a framebuffer and reports the fastest
+// run, the decoder state and the stack used. Stack use is
+// measured by painting the free stack below bench_jpeg()'s frame, through
+// a pointer, before decoding and finding how much of it was overwritten,
+// so it is approximate to a few words. The demo calls bench_jpeg() in its JPEG mode; on the host,
+// tools/bench_jpeg.py builds this file with BENCH_JPEG_HOST, which adds a
+// main() taking the JPEG file and output format.
+
+#include "jpeg.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef BENCH_JPEG_HOST
+#include <stdlib.h>
+#include <time.h>
+
+static uint64_t now_us(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t)t.tv_sec * 1000000 + t.tv_nsec / 1000;
+}
+#else
+#include "bench.h"
+#include "pico/time.h"
+
+static uint64_t now_us(void)
+{
+    return time_us_64();
+}
+#endif
+
+#define BENCH_JPEG_RUNS 5
+#define STACK_PAINT_BYTES 4096
+#define STACK_PAINT 0xA5
+// Left unpainted below paint_stack()'s locals, for the rest of its frame
+// (and on the host, the red zone).
+#define STACK_PAINT_GAP 256
+
+#ifndef BENCH_JPEG_HOST
+// The end of core 0's stack, from the SDK's linker script; below it is
+// scratch_y data.
+extern uint8_t __StackBottom[];
+#endif
+
+// The lowest byte painted under top.
+static volatile uint8_t *paint_bottom(volatile uint8_t *top)
+{
+    volatile uint8_t *bottom = (volatile uint8_t *)((uintptr_t)top - STACK_PAINT_BYTES);
+#ifndef BENCH_JPEG_HOST
+    if (bottom < __StackBottom)
+        bottom = __StackBottom;
+#endif
+    return bottom;
+}
+
+// Paint the free stack under top, up to this function's own frame.
+static __attribute__((noinline)) void paint_stack(volatile uint8_t *top)
+{
+    volatile uint8_t here = 0;
+    volatile uint8_t *end = (volatile uint8_t *)((uintptr_t)&here - STACK_PAINT_GAP);
+    for (volatile uint8_t *p = paint_bottom(top); p < end; ++p)
+        *p = STACK_PAINT;
+}
+
+// Bytes under top that are no longer paint.
+static unsigned stack_touched(volatile uint8_t *top)
+{
+    volatile uint8_t *p = paint_bottom(top);
+    while (p < top && *p == STACK_PAINT)
+        ++p;
+    return (unsigned)(top - p);
+}
+
+static __attribute__((noinline)) bool decode(jpeg_decoder_t *d, const uint8_t *jpeg, uint32_t size, void *dst,
+                                             uint32_t stride, asset_format_t format)
+{
+    return jpeg_open(d, jpeg, size) && jpeg_decode(d, dst, stride, format);
+}
+
+bool bench_jpeg(const uint8_t *jpeg, uint32_t size, void *dst, uint32_t stride, asset_format_t format)
+{
+    static jpeg_decoder_t d;
+    // Warm up caches, and on the host resolve lazily bound symbols.
+    if (!decode(&d, jpeg, size, dst, stride, format))
+    {
+        printf("# jpeg: decode failed\n");
+        return false;
+    }
+    uint64_t best = UINT64_MAX;
+    for (unsigned run = 0; run < BENCH_JPEG_RUNS; ++run)
+    {
+        uint64_t start = now_us();
+        decode(&d, jpeg, size, dst, stride, format);
+        uint64_t t = now_us() - start;
+        if (t < best)
+            best = t;
+    }
+    // A separate run, as reading the clock may itself use stack. Calls
+    // from here go below top.
+    volatile uint8_t top = 0;
+    paint_stack(&top);
+    decode(&d, jpeg, size, dst, stride, format);
+    unsigned stack = stack_touched(&top);
+    printf("# jpeg: %ux%u %s, %lu bytes in, %lu us (%.1f Mpixel/s), state %u bytes, stack %u bytes\n",
+           d.width, d.height, format == ASSET_FORMAT_RGB565 ? "rgb565" : "rgb332", (unsigned long)size,
+           (unsigned long)best, (double)d.width * d.height / (best ? best : 1), (unsigned)sizeof(d), stack);
+    return true;
+}
+
+#ifdef BENCH_JPEG_HOST
+// bench_jpeg <file.jpg> rgb332|rgb565 [decoded.raw]
+int main(int argc, char **argv)
+{
+    if (argc < 3)
+        return 2;
+    FILE *f = fopen(argv[1], "rb");
+    if (!f)
+        return 2;
+    static uint8_t jpeg[1 << 22];
+    uint32_t size = (uint32_t)fread(jpeg, 1, sizeof(jpeg), f);
+    fclose(f);
+    asset_format_t format = strcmp(argv[2], "rgb565") ? ASSET_FORMAT_RGB332 : ASSET_FORMAT_RGB565;
+    jpeg_decoder_t d;
+    if (!jpeg_open(&d, jpeg, size))
+        return 1;
+    uint32_t stride = d.width * (format == ASSET_FORMAT_RGB565 ? 2 : 1);
+    uint8_t *out = malloc((size_t)stride * d.height);
+    bool ok = out && bench_jpeg(jpeg, size, out, stride, format);
+    if (ok && argc > 3)
+    {
+        f = fopen(argv[3], "wb");
+        ok = f && fwrite(out, stride, d.height, f) == d.height;
+        if (f)
+            fclose(f);
+    }
+    free(out);
+    return ok ? 0 : 1;
+}
+#endif
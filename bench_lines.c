@@ -0,0 +1,49 @@
+// Scanline callback timing: how much of the line period a renderer takes.
+
+// The IRQ calls a scanline callback while the previous line is scanned
+// out, so every line, not just the average one, has to be ready within a
+// line period, less the IRQ's own overhead. bench_lines() renders each
+// active line on the calling core BENCH_LINES_REPEAT times in a row,
+// which gives sub-microsecond resolution from the microsecond timer, and
+// reports the mean and the slowest line. Run with the display going, core
+// 0 sees the same bus contention from the scanout as the IRQ does, but it
+// runs from wherever the callback's caches leave it rather than from a
+// cold start after the IRQ's own work, so allow some margin.
+
+#include "bench.h"
+#include "pico/time.h"
+#include <stdio.h>
+
+#define BENCH_LINES_REPEAT 16
+
+// HSTX runs at 125 MHz with 5 cycles per pixel (dvi_hstx.cpp).
+#define BENCH_PIXEL_CLOCK_MHZ 25
+
+void bench_lines(const char *name, dvi_scanline_cb_t cb, void *user)
+{
+    // Any format at up to 640 pixels.
+    static uint32_t line[640 * 2 / 4];
+    const dvi_mode_t *mode = dvi_get_mode();
+    hard_assert(mode->h_active_pixels <= 640);
+    uint32_t total = 0, worst = 0;
+    uint worst_y = 0;
+    for (uint y = 0; y < mode->v_active_lines; ++y)
+    {
+        uint32_t start = time_us_32();
+        for (uint i = 0; i < BENCH_LINES_REPEAT; ++i)
+            cb(y, line, user);
+        uint32_t t = time_us_32() - start;
+        total += t;
+        if (t > worst)
+        {
+            worst = t;
+            worst_y = y;
+        }
+    }
+    uint line_pixels = mode->h_front_porch + mode->h_sync_width + mode->h_back_porch + mode->h_active_pixels;
+    float period = (float)line_pixels / BENCH_PIXEL_CLOCK_MHZ;
+    float mean = (float)total / (BENCH_LINES_REPEAT * mode->v_active_lines);
+    float slowest = (float)worst / BENCH_LINES_REPEAT;
+    printf("# lines: %s: mean %.2f us, slowest %.2f us (line %u), %.0f%% of the %.1f us line\n", name, mean,
+           slowest, worst_y, 100 * slowest / period, period);
+}
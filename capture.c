@@ -0,0 +1,177 @@
+// Screenshots over the UART, see capture.h.
+
+#include "capture.h"
+#include "reload.h"
+#include <string.h>
+
+#ifdef RELOAD_HOST
+#include <stdio.h>
+#include <time.h>
+
+static uint64_t now_us(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t)t.tv_sec * 1000000 + t.tv_nsec / 1000;
+}
+
+static void put(const void *data, size_t n)
+{
+    fwrite(data, 1, n, stdout);
+}
+
+static void put_done(void)
+{
+    fflush(stdout);
+}
+#else
+#include "dvi_hstx.h"
+#include "pico/stdlib.h"
+
+static uint64_t now_us(void)
+{
+    return time_us_64();
+}
+
+static void put(const void *data, size_t n)
+{
+    const uint8_t *p = (const uint8_t *)data;
+    while (n--)
+        stdio_putchar_raw(*p++);
+}
+
+static void put_done(void)
+{
+    stdio_flush();
+}
+#endif
+
+// Packed pixels are sent in frames of up to this many bytes.
+#ifndef CAPTURE_CHUNK_SIZE
+#define CAPTURE_CHUNK_SIZE 4096
+#endif
+
+static uint8_t __attribute__((aligned(4))) chunk[CAPTURE_CHUNK_SIZE];
+
+static void send_frame(uint8_t type, const void *payload, uint32_t n)
+{
+    uint8_t head[7] = {RELOAD_MAGIC0, RELOAD_MAGIC1, type, (uint8_t)n, (uint8_t)(n >> 8), (uint8_t)(n >> 16),
+                       (uint8_t)(n >> 24)};
+    uint32_t crc = reload_crc32(reload_crc32(0, head + 2, 5), payload, n);
+    uint8_t tail[4] = {(uint8_t)crc, (uint8_t)(crc >> 8), (uint8_t)(crc >> 16), (uint8_t)(crc >> 24)};
+    put(head, sizeof(head));
+    put(payload, n);
+    put(tail, sizeof(tail));
+}
+
+// Packs into chunk and sends it whenever the next piece might not fit.
+// Between calls used stays below CAPTURE_CHUNK_SIZE - 1, which leaves room
+// for the run byte asset_qoi_encode_end() may add.
+typedef struct
+{
+    asset_qoi_encoder_t enc;
+    uint32_t used;
+    capture_end_t *end;
+} packer_t;
+
+static void flush(packer_t *p)
+{
+    if (!p->used)
+        return;
+    send_frame(RELOAD_CAPTURE_DATA, chunk, p->used);
+    p->end->size += p->used;
+    p->used = 0;
+}
+
+static void pack(packer_t *p, const uint8_t *src, uint32_t bytes, unsigned unit)
+{
+    while (bytes)
+    {
+        // The encoder writes at most 2 bytes per byte in, plus a run.
+        uint32_t room = (CAPTURE_CHUNK_SIZE - p->used - 1) / 2 / unit * unit;
+        if (!room)
+        {
+            flush(p);
+            continue;
+        }
+        uint32_t k = bytes < room ? bytes : room;
+        uint64_t start = now_us();
+        p->used += asset_qoi_encode(&p->enc, src, k, chunk + p->used);
+        p->end->encode_us += now_us() - start;
+        src += k;
+        bytes -= k;
+        if (p->used + 1 >= CAPTURE_CHUNK_SIZE)
+            flush(p);
+    }
+}
+
+void capture_frames(const capture_source_t *src, capture_end_t *end)
+{
+    uint64_t start = now_us();
+    capture_end_t e = {0};
+    if (src)
+    {
+        const unsigned unit = src->format == ASSET_FORMAT_RGB565 ? 2 : 1;
+        const uint32_t line_bytes = (uint32_t)src->width * unit;
+        reload_image_header_t h = {
+            .width = src->width,
+            .height = src->height,
+            .stride = (line_bytes + 3) & ~3u,
+            .format = src->format,
+            .pack = ASSET_PACK_QOI,
+            .palette_size = src->palette_size,
+        };
+        uint32_t palette_bytes = (h.palette_size * 2u + 3) & ~3u;
+        memcpy(chunk, &h, sizeof(h));
+        memset(chunk + sizeof(h), 0, palette_bytes);
+        if (h.palette_size)
+            memcpy(chunk + sizeof(h), src->palette, h.palette_size * 2u);
+        send_frame(RELOAD_CAPTURE, chunk, sizeof(h) + palette_bytes);
+
+        static const uint8_t zeros[4] = {0};
+        packer_t p = {.used = 0, .end = &e};
+        asset_qoi_encoder_init(&p.enc, (asset_format_t)src->format);
+        for (unsigned y = 0; y < src->height; ++y)
+        {
+            const uint8_t *line = src->line_table ? (const uint8_t *)src->line_table[y]
+                                                  : src->pixels + (y % src->lines) * src->stride;
+            pack(&p, line, line_bytes, unit);
+            pack(&p, zeros, h.stride - line_bytes, unit);
+        }
+        p.used += asset_qoi_encode_end(&p.enc, chunk + p.used);
+        flush(&p);
+        e.lines = src->height;
+    }
+    e.total_us = now_us() - start;
+    send_frame(RELOAD_CAPTURE_END, &e, sizeof(e));
+    put_done();
+    if (end)
+        *end = e;
+}
+
+#ifndef RELOAD_HOST
+bool capture_send(void)
+{
+    dvi_view_t view;
+    if (!dvi_get_view(&view))
+    {
+        capture_frames(NULL, NULL);
+        return false;
+    }
+    const dvi_mode_t *mode = dvi_get_mode();
+    // asset_format_t matches dvi_format_t for the formats the display shows.
+    capture_source_t src = {
+        .width = (uint16_t)mode->h_active_pixels,
+        .height = (uint16_t)mode->v_active_lines,
+        .format = (uint8_t)view.format,
+        .pixels = view.pixels,
+        .stride = view.stride,
+        .lines = view.lines,
+        .line_table = view.line_table,
+        .palette = view.palette,
+        .palette_size = (uint16_t)view.palette_size,
+    };
+    capture_frames(&src, NULL);
+    return true;
+}
+#endif
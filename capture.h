@@ -0,0 +1,67 @@
+// Screenshots over the UART: the frame on show, with its format and
+// palette, packed with ASSET_PACK_QOI on core 0 as it is sent, for
+// tools/capture.py to save as PNG.
+//
+// A capture goes out in frames laid out as in reload.h, which the device
+// sends unasked: one RELOAD_CAPTURE with a reload_image_header_t (pack
+// QOI, size 0 as it is not known yet) and the palette, RELOAD_CAPTURE_DATA
+// frames with the packed pixels in order, then a RELOAD_CAPTURE_END with a
+// capture_end_t. The lines are packed as they are read, a chunk ahead of
+// the UART, so the capture needs no frame-sized buffer; the price is that
+// a frame drawn to during the capture comes out torn, as a camera would
+// see it. Scanout is not held up: core 0 only reads the pixels, and the
+// IRQ's view of the source is untouched.
+//
+// capture_frames() only depends on the C library; with RELOAD_HOST it is
+// built into the loopback device of reload.c, which captures the image it
+// last received when sent 's'.
+
+#ifndef _CAPTURE_H
+#define _CAPTURE_H
+
+#include "asset.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct
+{
+    uint32_t size;      // bytes of packed pixels sent
+    uint32_t encode_us; // time spent packing
+    uint32_t total_us;  // time from the start to the last byte queued
+    uint16_t lines;     // lines captured, 0 if there was nothing to read
+    uint16_t reserved;
+} capture_end_t;
+
+// A frame to capture. Line y is line_table[y] if line_table is set, else
+// pixels + (y % lines) * stride, as the display reads it.
+typedef struct
+{
+    uint16_t width;
+    uint16_t height;
+    uint8_t format; // asset_format_t, RGB332, RGB565 or PAL8
+    const uint8_t *pixels;
+    uint32_t stride;
+    unsigned lines;
+    const void *const *line_table;
+    const uint16_t *palette;
+    uint16_t palette_size;
+} capture_source_t;
+
+// Send src as capture frames, or with src NULL an empty capture, and fill
+// in end if not NULL.
+void capture_frames(const capture_source_t *src, capture_end_t *end);
+
+#ifndef RELOAD_HOST
+// Capture what the display shows from the next vblank. A display drawn by
+// a scanline callback has no pixels to read back, so this sends an empty
+// capture and returns false.
+bool capture_send(void);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
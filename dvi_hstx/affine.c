@@ -0,0 +1,149 @@
+// Affine mode, see affine.h.
+
+#include "affine.h"
+#include "hardware/interp.h"
+#include <math.h>
+#include <string.h>
+
+void affine_init(affine_layer_t *t, const uint8_t *texture)
+{
+    memset(t, 0, sizeof(*t));
+    t->texture = texture;
+    t->width = dvi_get_mode()->h_active_pixels;
+    t->transform.du_dx = t->transform.dv_dy = AFFINE_FIXED(1);
+}
+
+void affine_rotate_zoom(affine_transform_t *transform, float u, float v, float angle, float zoom)
+{
+    const dvi_mode_t *mode = dvi_get_mode();
+    float c = cosf(angle) / zoom, s = sinf(angle) / zoom;
+    float cx = mode->h_active_pixels / 2.0f, cy = mode->v_active_lines / 2.0f;
+    // Along a line the screen's x axis turns by angle; down the screen, y.
+    transform->du_dx = AFFINE_FIXED(c);
+    transform->dv_dx = AFFINE_FIXED(s);
+    transform->du_dy = AFFINE_FIXED(-s);
+    transform->dv_dy = AFFINE_FIXED(c);
+    transform->u = AFFINE_FIXED(u - cx * c + cy * s);
+    transform->v = AFFINE_FIXED(v - cx * s - cy * c);
+}
+
+// The interpolator state a line changes. The SDK's interp_save() and
+// interp_restore() live in flash, so the IRQ does its own.
+typedef struct
+{
+    uint32_t accum[2], base[3], ctrl[2];
+} saved_interp_t;
+
+static __force_inline void save(saved_interp_t *s)
+{
+    s->accum[0] = interp0->accum[0];
+    s->accum[1] = interp0->accum[1];
+    s->base[0] = interp0->base[0];
+    s->base[1] = interp0->base[1];
+    s->base[2] = interp0->base[2];
+    s->ctrl[0] = interp0->ctrl[0];
+    s->ctrl[1] = interp0->ctrl[1];
+}
+
+static __force_inline void restore(const saved_interp_t *s)
+{
+    interp0->ctrl[0] = s->ctrl[0];
+    interp0->ctrl[1] = s->ctrl[1];
+    interp0->accum[0] = s->accum[0];
+    interp0->accum[1] = s->accum[1];
+    interp0->base[0] = s->base[0];
+    interp0->base[1] = s->base[1];
+    interp0->base[2] = s->base[2];
+}
+
+static __force_inline uint32_t texel(void)
+{
+    return *(const uint8_t *)(uintptr_t)interp0->pop[2];
+}
+
+// Pixels [x0, x1) of line y into out + x0.
+static void __not_in_flash_func(render)(const affine_layer_t *t, uint y, uint8_t *out, uint x0, uint x1)
+{
+    affine_line_t l;
+    if (t->frame_lines)
+    {
+        l = t->frame_lines[y];
+    }
+    else
+    {
+        l.u = t->frame.u + (int32_t)y * t->frame.du_dy;
+        l.v = t->frame.v + (int32_t)y * t->frame.dv_dy;
+        l.du = t->frame.du_dx;
+        l.dv = t->frame.dv_dx;
+    }
+    saved_interp_t saved;
+    save(&saved);
+    // Lane 0 takes the whole part of u as bits 0-7 of the result, lane 1
+    // that of v as bits 8-15; base 2 adds the texture. Both accumulators
+    // add their step, unshifted, on each pop.
+    interp_config cfg = interp_default_config();
+    interp_config_set_add_raw(&cfg, true);
+    interp_config_set_shift(&cfg, 16);
+    interp_config_set_mask(&cfg, 0, 7);
+    interp_set_config(interp0, 0, &cfg);
+    interp_config_set_shift(&cfg, 8);
+    interp_config_set_mask(&cfg, 8, 15);
+    interp_set_config(interp0, 1, &cfg);
+    interp0->accum[0] = l.u + (int32_t)x0 * l.du;
+    interp0->accum[1] = l.v + (int32_t)x0 * l.dv;
+    interp0->base[0] = l.du;
+    interp0->base[1] = l.dv;
+    interp0->base[2] = (uintptr_t)t->texture;
+
+    uint8_t *dst = out + x0;
+    uint n = x1 - x0;
+    // Bytes up to a word boundary, then four pixels to a store.
+    for (; n && ((uintptr_t)dst & 3); --n)
+        *dst++ = texel();
+    for (; n >= 4; n -= 4, dst += 4)
+    {
+        uint32_t p = texel();
+        p |= texel() << 8;
+        p |= texel() << 16;
+        p |= texel() << 24;
+        *(uint32_t *)dst = p;
+    }
+    for (; n; --n)
+        *dst++ = texel();
+    restore(&saved);
+}
+
+static __force_inline void latch(affine_layer_t *t, uint y)
+{
+    if (y == 0)
+    {
+        t->frame = t->transform;
+        t->frame_lines = t->lines;
+    }
+}
+
+void __not_in_flash_func(affine_scanline)(uint y, void *buf, void *user)
+{
+    affine_layer_t *t = (affine_layer_t *)user;
+    latch(t, y);
+    render(t, y, (uint8_t *)buf, 0, t->width);
+}
+
+uint __not_in_flash_func(affine_spans)(uint y, compose_span_t *spans, uint max, void *user)
+{
+    affine_layer_t *t = (affine_layer_t *)user;
+    (void)max;
+    latch(t, y);
+    spans[0] = (compose_span_t){0, (int16_t)t->width, COMPOSE_RENDER, 0, NULL};
+    return 1;
+}
+
+void __not_in_flash_func(affine_render)(uint y, uint8_t *line, uint x0, uint x1, void *user)
+{
+    render((const affine_layer_t *)user, y, line, x0, x1);
+}
+
+void affine_show(affine_layer_t *t)
+{
+    dvi_set_scanline_callback(DVI_FORMAT_RGB332, affine_scanline, t);
+}
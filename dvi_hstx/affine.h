@@ -0,0 +1,82 @@
+// Affine mode ("mode 7"): each scanline samples a 256x256 RGB332 texture
+// along a straight line through it, so the screen shows the texture rotated,
+// zoomed and sheared, or, with a different line per scanline, a perspective
+// floor, without a framebuffer.
+//
+// A line is a start texel and a step per pixel, in 16.16 fixed point, and
+// the texture wraps in both directions. The walk along the line runs on
+// interpolator 0 of the core drawing it: its two accumulators hold u and v,
+// add the steps on every pop, and its full result is the address of the
+// texel, so a pixel is a pop, a byte load and a store. The interpolator's
+// state is saved and restored around each line, so other users of it on the
+// same core are undisturbed. The texture should be in RAM.
+
+#ifndef _AFFINE_H
+#define _AFFINE_H
+
+#include "compose.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AFFINE_SIZE 256 // texture width and height, in texels
+
+// A texel coordinate or step in 16.16 fixed point.
+#define AFFINE_FIXED(x) ((int32_t)((x) * 65536.0f))
+
+typedef struct
+{
+    int32_t u, v;   // texel at the line's first pixel
+    int32_t du, dv; // step per pixel
+} affine_line_t;
+
+// The whole screen as one transform: line y starts at (u, v) + y * (du_dy,
+// dv_dy) and steps by (du_dx, dv_dx).
+typedef struct
+{
+    int32_t u, v;
+    int32_t du_dx, dv_dx;
+    int32_t du_dy, dv_dy;
+} affine_transform_t;
+
+typedef struct
+{
+    const uint8_t *texture; // AFFINE_SIZE rows of AFFINE_SIZE RGB332 texels
+    uint16_t width;         // pixels per line, from the mode
+    // Read at the first line of each frame, so a frame never shows two
+    // transforms; write them from a vblank callback or between frames.
+    affine_transform_t transform;
+    // If set, v_active_lines lines used instead of the transform. Taken at
+    // the first line of a frame like the transform, so once lines points
+    // elsewhere the old table is free from the next vblank.
+    const affine_line_t *lines;
+    // The frame being drawn.
+    affine_transform_t frame;
+    const affine_line_t *frame_lines;
+} affine_layer_t;
+
+// Set up t showing texture unscaled and unrotated.
+void affine_init(affine_layer_t *t, const uint8_t *texture);
+
+// Set transform to show texel (u, v) at the centre of the screen, rotated
+// by angle radians and zoomed to zoom pixels per texel.
+void affine_rotate_zoom(affine_transform_t *transform, float u, float v, float angle, float zoom);
+
+// Render line y of t into buf, for dvi_set_scanline_callback() in
+// DVI_FORMAT_RGB332 with t as user.
+void affine_scanline(uint y, void *buf, void *user);
+
+// As a compositor plane (compose.h): the whole line, rendered on request
+// for the parts left visible.
+uint affine_spans(uint y, compose_span_t *spans, uint max, void *user);
+void affine_render(uint y, uint8_t *line, uint x0, uint x1, void *user);
+
+// Show t from the next vblank.
+void affine_show(affine_layer_t *t);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
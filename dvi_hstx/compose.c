@@ -0,0 +1,207 @@
+// Compositor, see compose.h.
+
+#include "compose.h"
+#include <string.h>
+
+// Disjoint opaque ranges already claimed on a line, in order. Ranges that
+// do not fit are left out, which only costs drawing them twice.
+#define MAX_COVER 32
+
+void compose_init(compose_t *c)
+{
+    memset(c, 0, sizeof(*c));
+    c->width = dvi_get_mode()->h_active_pixels;
+}
+
+void compose_add(compose_t *c, compose_spans_cb_t spans, compose_render_cb_t render, void *user)
+{
+    hard_assert(c->count < COMPOSE_MAX_PLANES);
+    c->planes[c->count++] = (compose_plane_t){spans, render, user};
+}
+
+static __force_inline bool opaque(const compose_span_t *s)
+{
+    return s->kind != COMPOSE_KEYED;
+}
+
+// Add [a, b) to the cover, merging with the ranges it touches. Returns false
+// if it would need a new range and there is no room.
+static bool __not_in_flash_func(cover)(int16_t *c0, int16_t *c1, uint *n, int a, int b)
+{
+    uint k = 0;
+    while (k < *n && c1[k] < a)
+        ++k;
+    uint j = k;
+    while (j < *n && c0[j] <= b)
+    {
+        if (c0[j] < a)
+            a = c0[j];
+        if (c1[j] > b)
+            b = c1[j];
+        ++j;
+    }
+    int shift = 1 - (int)(j - k); // ranges gained
+    if (*n + shift > MAX_COVER)
+        return false;
+    if (shift > 0)
+    {
+        for (uint i = *n; i > k; --i)
+            c0[i] = c0[i - 1], c1[i] = c1[i - 1];
+    }
+    else if (shift < 0)
+    {
+        for (uint i = k + 1; i + (uint)-shift < *n; ++i)
+            c0[i] = c0[i - shift], c1[i] = c1[i - shift];
+    }
+    c0[k] = a;
+    c1[k] = b;
+    *n += shift;
+    return true;
+}
+
+static void __not_in_flash_func(draw)(const compose_t *c, uint y, uint8_t *line, const compose_span_t *s,
+                                      uint plane, int x0, int x1)
+{
+    uint8_t *dst = line + x0;
+    uint n = x1 - x0;
+    const uint8_t *src = s->pixels + (x0 - s->x0);
+    switch (s->kind)
+    {
+    case COMPOSE_COPY:
+        if (!(((uintptr_t)dst | (uintptr_t)src) & 3))
+        {
+            for (; n >= 4; n -= 4, dst += 4, src += 4)
+                *(uint32_t *)dst = *(const uint32_t *)src;
+        }
+        for (uint i = 0; i < n; ++i)
+            dst[i] = src[i];
+        break;
+    case COMPOSE_KEYED:
+        for (uint i = 0; i < n; ++i)
+        {
+            uint8_t p = src[i];
+            if (p != s->colour)
+                dst[i] = p;
+        }
+        break;
+    case COMPOSE_FILL:
+        for (uint i = 0; i < n; ++i)
+            dst[i] = s->colour;
+        break;
+    default:
+        c->planes[plane].render(y, line, x0, x1, c->planes[plane].user);
+        break;
+    }
+}
+
+static void __not_in_flash_func(background)(const compose_t *c, uint y, uint8_t *line)
+{
+    if (c->background)
+    {
+        c->background(y, line, c->background_user);
+    }
+    else
+    {
+        uint32_t fill = c->background_colour * 0x01010101u;
+        for (uint i = 0; i < c->width / 4; ++i)
+            ((uint32_t *)line)[i] = fill;
+    }
+}
+
+// Every span of every plane, bottom up.
+static void __not_in_flash_func(paint)(compose_t *c, uint y, uint8_t *line)
+{
+    uint32_t drawn = c->width;
+    background(c, y, line);
+    for (uint p = 0; p < c->count; ++p)
+    {
+        const compose_plane_t *pl = &c->planes[p];
+        uint n = pl->spans(y, c->spans, COMPOSE_MAX_SPANS, pl->user);
+        while (n--)
+        {
+            const compose_span_t *s = &c->spans[n];
+            if (s->x0 < s->x1)
+            {
+                draw(c, y, line, s, p, s->x0, s->x1);
+                drawn += s->x1 - s->x0;
+            }
+        }
+    }
+    c->drawn += drawn;
+}
+
+void __not_in_flash_func(compose_scanline)(uint y, void *buf, void *user)
+{
+    compose_t *c = (compose_t *)user;
+    uint8_t *line = (uint8_t *)buf;
+    if (c->painter)
+    {
+        paint(c, y, line);
+        return;
+    }
+    int16_t c0[MAX_COVER], c1[MAX_COVER];
+    uint ncover = 0, covered = 0, ndraws = 0;
+    uint32_t culled = 0;
+    const uint width = c->width;
+    for (uint p = c->count; p-- > 0;)
+    {
+        const compose_plane_t *pl = &c->planes[p];
+        // Asked even when the line is already covered, for line 0 latches.
+        uint n = pl->spans(y, c->spans, COMPOSE_MAX_SPANS, pl->user);
+        for (uint i = 0; i < n; ++i)
+        {
+            const compose_span_t *s = &c->spans[i];
+            int x = s->x0, end = s->x1;
+            if (x >= end)
+                continue;
+            uint visible = 0;
+            // Draw the gaps in the cover.
+            for (uint k = 0; k < ncover && x < end; ++k)
+            {
+                if (c1[k] <= x)
+                    continue;
+                if (c0[k] >= end)
+                    break;
+                if (c0[k] > x)
+                {
+                    if (ndraws == COMPOSE_MAX_DRAWS)
+                        goto overflow;
+                    c->draws[ndraws++] = (compose_draw_t){*s, (int16_t)x, c0[k], (uint8_t)p};
+                    visible += c0[k] - x;
+                }
+                x = c1[k];
+            }
+            if (x < end)
+            {
+                if (ndraws == COMPOSE_MAX_DRAWS)
+                    goto overflow;
+                c->draws[ndraws++] = (compose_draw_t){*s, (int16_t)x, (int16_t)end, (uint8_t)p};
+                visible += end - x;
+            }
+            culled += s->x1 - s->x0 - visible;
+            if (opaque(s) && visible && cover(c0, c1, &ncover, s->x0, s->x1))
+                covered += visible;
+        }
+    }
+    if (covered < width)
+        background(c, y, line);
+    uint32_t drawn = covered < width ? width : 0;
+    // Bottom up, so keyed pixels land on what lies beneath.
+    while (ndraws--)
+    {
+        const compose_draw_t *d = &c->draws[ndraws];
+        draw(c, y, line, &d->span, d->plane, d->x0, d->x1);
+        drawn += d->x1 - d->x0;
+    }
+    c->drawn += drawn;
+    c->culled += culled;
+    return;
+overflow:
+    // More visible pieces than fit: paint this line the slow way.
+    paint(c, y, line);
+}
+
+void compose_show(compose_t *c)
+{
+    dvi_set_scanline_callback(DVI_FORMAT_RGB332, compose_scanline, c);
+}
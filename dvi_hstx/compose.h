@@ -0,0 +1,107 @@
+// Compositor: stacks planes (a background, tile layers, sprites, overlay
+// windows) into one RGB332 line per scanline callback, drawing each pixel
+// range only from the topmost plane that covers it opaquely.
+//
+// Each plane describes its line as spans: runs of pixels to copy, pixels
+// with a transparent key colour, a flat colour, or pixels the plane renders
+// on request (a tile layer). The compositor walks the planes top down,
+// keeping a list of the ranges already covered by opaque spans; what is
+// left of each span becomes a draw, and a line that ends up fully covered
+// stops there. The draws are then made bottom up, so keyed pixels land on
+// whatever lies beneath. A pixel under an opaque window is thus never
+// rendered at all, where painting every plane in turn would draw it once
+// per plane.
+//
+// compose_t.painter turns the culling off and paints every span of every
+// plane bottom up, for comparison.
+
+#ifndef _COMPOSE_H
+#define _COMPOSE_H
+
+#include "dvi_hstx.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define COMPOSE_MAX_PLANES 8
+#define COMPOSE_MAX_SPANS 32 // per plane and line
+#define COMPOSE_MAX_DRAWS 96 // per line, after culling
+
+typedef enum
+{
+    COMPOSE_COPY,   // opaque pixels
+    COMPOSE_KEYED,  // pixels, transparent where equal to colour
+    COMPOSE_FILL,   // opaque colour
+    COMPOSE_RENDER, // opaque, drawn by the plane's render callback
+} compose_kind_t;
+
+typedef struct
+{
+    int16_t x0, x1;        // [x0, x1) on the line, clipped to it
+    uint8_t kind;          // compose_kind_t
+    uint8_t colour;        // COMPOSE_FILL colour or COMPOSE_KEYED key
+    const uint8_t *pixels; // COMPOSE_COPY and COMPOSE_KEYED: the pixel at x0
+} compose_span_t;
+
+// Write a plane's spans on line y to spans, at most max of them, and return
+// how many. Spans may overlap; each is taken to be above those after it.
+// Called for every line, line 0 included, even when the plane ends up
+// hidden, so a plane can latch per-frame state at line 0.
+typedef uint (*compose_spans_cb_t)(uint y, compose_span_t *spans, uint max, void *user);
+
+// Draw pixels [x0, x1) of line y into line + x0, for COMPOSE_RENDER spans.
+typedef void (*compose_render_cb_t)(uint y, uint8_t *line, uint x0, uint x1, void *user);
+
+typedef struct
+{
+    compose_spans_cb_t spans;
+    compose_render_cb_t render;
+    void *user;
+} compose_plane_t;
+
+// A span, or what of it is left to see, from a plane.
+typedef struct
+{
+    compose_span_t span;
+    int16_t x0, x1;
+    uint8_t plane;
+} compose_draw_t;
+
+typedef struct
+{
+    compose_plane_t planes[COMPOSE_MAX_PLANES]; // planes[0] at the bottom
+    uint count;
+    // Under the planes, wherever they leave a line uncovered: a full line
+    // callback (RGB332), or background_colour if NULL.
+    dvi_scanline_cb_t background;
+    void *background_user;
+    uint8_t background_colour;
+    bool painter;
+    uint16_t width; // from the mode
+    // Pixels written, and span pixels culled as hidden, since last reset.
+    volatile uint32_t drawn, culled;
+    // Private: the line being composed.
+    compose_span_t spans[COMPOSE_MAX_SPANS];
+    compose_draw_t draws[COMPOSE_MAX_DRAWS];
+} compose_t;
+
+// No planes over a black background. A compose_t holds its working state
+// for a line (2 KB), so one on show must not be rendered from elsewhere.
+void compose_init(compose_t *c);
+
+// Add a plane above those already added. Planes are set up before showing.
+void compose_add(compose_t *c, compose_spans_cb_t spans, compose_render_cb_t render, void *user);
+
+// Render line y of c into buf, for dvi_set_scanline_callback() in
+// DVI_FORMAT_RGB332 with c as user.
+void compose_scanline(uint y, void *buf, void *user);
+
+// Show c from the next vblank.
+void compose_show(compose_t *c);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,202 @@
+// Compile-time pixel formats, framebuffer shapes and scanline kernels.
+
+// Each format is a traits struct carrying its pixel type and the format
+// the HSTX expander scans it out as. Framebuffer<Format, W, H> derives
+// stride and DMA transfer count from them and refuses, at compile time,
+// shapes the DMA cannot move or SRAM cannot hold. The driver instantiates
+// its per-line kernels from the same traits, so the IRQ never looks at a
+// format at run time.
+//
+//   using Screen = dvi::Framebuffer<dvi::Rgb332, 640, 480>;
+//   static Screen::storage_type pixels;
+//   dvi::set_framebuffer<Screen>(&pixels[0][0], DVI_FB_STAGED);
+
+#ifndef _DVI_FORMAT_HPP
+#define _DVI_FORMAT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include "dvi_hstx.h"
+#include "hardware/structs/hstx_ctrl.h"
+
+// Largest framebuffer accepted by Framebuffer<>: the 512 KiB of striped SRAM
+// less room for the driver, stacks and the application.
+#ifndef DVI_FRAMEBUFFER_MAX_BYTES
+#define DVI_FRAMEBUFFER_MAX_BYTES (448 * 1024)
+#endif
+
+namespace dvi
+{
+
+// The TMDS encoders take up to 8 bits from the top of each right-rotated
+// pixel; NBITS is the bit count minus one. Control symbols (RAW) are an
+// entire 32-bit word.
+
+struct Rgb332
+{
+    using scanout = Rgb332;
+    using pixel_type = uint8_t;
+    static constexpr dvi_format_t id = DVI_FORMAT_RGB332;
+    static constexpr uint bytes_per_pixel = 1;
+    static constexpr uint32_t expand_tmds =
+        2 << HSTX_CTRL_EXPAND_TMDS_L2_NBITS_LSB |
+        0 << HSTX_CTRL_EXPAND_TMDS_L2_ROT_LSB |
+        2 << HSTX_CTRL_EXPAND_TMDS_L1_NBITS_LSB |
+        29 << HSTX_CTRL_EXPAND_TMDS_L1_ROT_LSB |
+        1 << HSTX_CTRL_EXPAND_TMDS_L0_NBITS_LSB |
+        26 << HSTX_CTRL_EXPAND_TMDS_L0_ROT_LSB;
+    // Pixels (TMDS) come in 4 8-bit chunks.
+    static constexpr uint32_t expand_shift =
+        4 << HSTX_CTRL_EXPAND_SHIFT_ENC_N_SHIFTS_LSB |
+        8 << HSTX_CTRL_EXPAND_SHIFT_ENC_SHIFT_LSB |
+        1 << HSTX_CTRL_EXPAND_SHIFT_RAW_N_SHIFTS_LSB |
+        0 << HSTX_CTRL_EXPAND_SHIFT_RAW_SHIFT_LSB;
+};
+
+struct Rgb565
+{
+    using scanout = Rgb565;
+    using pixel_type = uint16_t;
+    static constexpr dvi_format_t id = DVI_FORMAT_RGB565;
+    static constexpr uint bytes_per_pixel = 2;
+    static constexpr uint32_t expand_tmds =
+        4 << HSTX_CTRL_EXPAND_TMDS_L2_NBITS_LSB | // 5 bits red from 15:11
+        8 << HSTX_CTRL_EXPAND_TMDS_L2_ROT_LSB |
+        5 << HSTX_CTRL_EXPAND_TMDS_L1_NBITS_LSB | // 6 bits green from 10:5
+        3 << HSTX_CTRL_EXPAND_TMDS_L1_ROT_LSB |
+        4 << HSTX_CTRL_EXPAND_TMDS_L0_NBITS_LSB | // 5 bits blue from 4:0
+        29 << HSTX_CTRL_EXPAND_TMDS_L0_ROT_LSB;
+    // Pixels (TMDS) come in 2 16-bit chunks.
+    static constexpr uint32_t expand_shift =
+        2 << HSTX_CTRL_EXPAND_SHIFT_ENC_N_SHIFTS_LSB |
+        16 << HSTX_CTRL_EXPAND_SHIFT_ENC_SHIFT_LSB |
+        1 << HSTX_CTRL_EXPAND_SHIFT_RAW_N_SHIFTS_LSB |
+        0 << HSTX_CTRL_EXPAND_SHIFT_RAW_SHIFT_LSB;
+};
+
+// 8-bit indices into a 256-entry RGB565 palette, expanded a line ahead of
+// scanout.
+struct Pal8
+{
+    using scanout = Rgb565;
+    using pixel_type = uint8_t;
+    static constexpr dvi_format_t id = DVI_FORMAT_PAL8;
+    static constexpr uint bytes_per_pixel = 1;
+};
+
+// Words the DMA moves for one line of Width pixels.
+template <class Format, uint Width>
+constexpr uint line_words = Width * Format::scanout::bytes_per_pixel / sizeof(uint32_t);
+
+template <class Format, uint Width, uint Height>
+struct Framebuffer
+{
+    using format = Format;
+    using pixel_type = typename Format::pixel_type;
+    using storage_type = pixel_type[Height][Width];
+
+    static constexpr uint width = Width;
+    static constexpr uint height = Height;
+    static constexpr uint32_t stride = Width * Format::bytes_per_pixel;
+    static constexpr uint words_per_line = line_words<Format, Width>;
+    static constexpr size_t bytes = size_t(stride) * Height;
+
+    static_assert(Width > 0 && Height > 0, "empty framebuffer");
+    static_assert(stride % sizeof(uint32_t) == 0,
+                  "the DMA moves whole words: Width * bytes_per_pixel must be a multiple of 4");
+    static_assert(Height <= UINT16_MAX, "dvi_framebuffer_t::lines is 16 bits");
+    static_assert(bytes <= DVI_FRAMEBUFFER_MAX_BYTES,
+                  "framebuffer does not fit in SRAM (see DVI_FRAMEBUFFER_MAX_BYTES)");
+
+    static dvi_framebuffer_t describe(const pixel_type *pixels, uint32_t flags = 0,
+                                      const uint16_t *palette = nullptr, uint16_t palette_size = 0)
+    {
+        return dvi_framebuffer_t{pixels, Format::id, uint16_t(Height), stride, flags, palette, palette_size};
+    }
+};
+
+// Display a framebuffer of shape Fb; see dvi_set_framebuffer().
+template <class Fb>
+inline void set_framebuffer(const typename Fb::pixel_type *pixels, uint32_t flags = 0,
+                            const uint16_t *palette = nullptr, uint16_t palette_size = 0)
+{
+    dvi_framebuffer_t fb = Fb::describe(pixels, flags, palette, palette_size);
+    dvi_set_framebuffer(&fb);
+}
+
+// ----------------------------------------------------------------------------
+// Scanline kernels
+
+// Copy eight words at a time so GCC emits ldmia/stmia pairs. Every line of
+// a supported mode is a multiple of 8 words; the tail of others is copied
+// in straight-line code. Neither is a loop GCC can turn back into a
+// memcpy() call, which would leave the IRQ running from flash.
+__force_inline void copy_words(uint32_t *__restrict dst, const uint32_t *__restrict src, uint words)
+{
+    for (uint i = 0; i < words / 8; ++i)
+    {
+        uint32_t a = src[0], b = src[1], c = src[2], d = src[3];
+        uint32_t e = src[4], f = src[5], g = src[6], h = src[7];
+        dst[0] = a, dst[1] = b, dst[2] = c, dst[3] = d;
+        dst[4] = e, dst[5] = f, dst[6] = g, dst[7] = h;
+        src += 8;
+        dst += 8;
+    }
+    if (words & 4)
+    {
+        uint32_t a = src[0], b = src[1], c = src[2], d = src[3];
+        dst[0] = a, dst[1] = b, dst[2] = c, dst[3] = d;
+        src += 4;
+        dst += 4;
+    }
+    if (words & 2)
+    {
+        uint32_t a = src[0], b = src[1];
+        dst[0] = a, dst[1] = b;
+        src += 2;
+        dst += 2;
+    }
+    if (words & 1)
+        dst[0] = src[0];
+}
+
+// Copy Words words.
+template <uint Words>
+__force_inline void copy_line(uint32_t *__restrict dst, const uint32_t *__restrict src)
+{
+    copy_words(dst, src, Words);
+}
+
+// Run-time length version, for line widths without a specialisation.
+__force_inline void copy_line(uint32_t *__restrict dst, const uint32_t *__restrict src, uint words)
+{
+    copy_words(dst, src, words);
+}
+
+// Expand 8-bit indices through an RGB565 palette: one source word of four
+// pixels becomes two output words, first pixel in the low half.
+__force_inline void expand_pal8_word(uint32_t *__restrict dst, uint32_t w, const uint16_t *__restrict palette)
+{
+    dst[0] = palette[w & 0xff] | (uint32_t)palette[(w >> 8) & 0xff] << 16;
+    dst[1] = palette[(w >> 16) & 0xff] | (uint32_t)palette[w >> 24] << 16;
+}
+
+// OutWords output words (RGB565) from OutWords / 2 words of indices.
+template <uint OutWords>
+__force_inline void expand_pal8(uint32_t *__restrict dst, const uint32_t *__restrict src,
+                                const uint16_t *__restrict palette)
+{
+    for (uint i = 0; i < OutWords / 2; ++i, dst += 2)
+        expand_pal8_word(dst, src[i], palette);
+}
+
+__force_inline void expand_pal8(uint32_t *__restrict dst, const uint32_t *__restrict src,
+                                const uint16_t *__restrict palette, uint out_words)
+{
+    for (uint i = 0; i < out_words / 2; ++i, dst += 2)
+        expand_pal8_word(dst, src[i], palette);
+}
+
+} // namespace dvi
+
+#endif
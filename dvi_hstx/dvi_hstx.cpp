@@ -0,0 +1,858 @@
+// Copyright (c) 2024 Raspberry Pi (Trading) Ltd.
+
+// Generate DVI output using the command expander and TMDS encoder in HSTX.
+
+// This requires an external digital video connector connected to GPIOs 12
+// through 19 (the HSTX-capable GPIOs) with appropriate current-limiting
+// resistors, e.g. 270 ohms. See dvi_set_pinout() for the lane mapping.
+
+#include "dvi_hstx.h"
+#include "dvi_format.hpp"
+#include "dvi_timing.hpp"
+#include "hardware/dma.h"
+#include "hardware/gpio.h"
+#include "hardware/clocks.h"
+#include "hardware/irq.h"
+#include "hardware/structs/bus_ctrl.h"
+#include "hardware/structs/hstx_ctrl.h"
+#include "hardware/structs/hstx_fifo.h"
+#include "hardware/sync.h"
+#include "scanout_stats.h"
+#include "sram_banks.h"
+#include "trace.h"
+
+const dvi_mode_t dvi_mode_640x480_60 = dvi::mode_640x480_60;
+
+// ----------------------------------------------------------------------------
+// HSTX command lists
+
+// Built by dvi_timing.hpp. They live in scratch_x so the DMA does not
+// contend with application data for them (see sram_banks.h). The lists for
+// the built-in mode are constant-initialised, so dvi_init() only builds
+// (and checks) lists for other modes.
+
+static dvi::ScanlineLists __scanout_cmdlist("dvi_cmdlist") cmdlists = dvi::build_lists(dvi::mode_640x480_60);
+static const dvi_mode_t *cmdlists_mode = &dvi_mode_640x480_60;
+
+// ----------------------------------------------------------------------------
+// Pixel formats
+
+// The traits for each format are in dvi_format.hpp.
+
+static_assert(dvi::Rgb332::id == DVI_FORMAT_RGB332 && dvi::Rgb565::id == DVI_FORMAT_RGB565 &&
+                  dvi::Pal8::id == DVI_FORMAT_PAL8,
+              "format_bytes_per_pixel[] is indexed by dvi_format_t");
+static const uint8_t format_bytes_per_pixel[DVI_FORMAT_COUNT] = {
+    dvi::Rgb332::bytes_per_pixel,
+    dvi::Rgb565::bytes_per_pixel,
+    dvi::Pal8::bytes_per_pixel,
+};
+
+// The built-in mode at full resolution in RGB332, and line-doubled in
+// RGB565, must fit in SRAM.
+template struct dvi::Framebuffer<dvi::Rgb332, 640, 480>;
+template struct dvi::Framebuffer<dvi::Rgb565, 640, 240>;
+
+uint dvi_format_bytes_per_pixel(dvi_format_t format)
+{
+    return format_bytes_per_pixel[format];
+}
+
+// ----------------------------------------------------------------------------
+// Driver state
+
+// Posts the pixels of active line y to a DMA channel, see post_pixels().
+typedef void (*line_stage_t)(dma_channel_hw_t *ch, uint y);
+// Renders active line y ahead of its pixels, see prepare_line().
+typedef void (*line_prepare_t)(uint y);
+
+// What the active lines are generated from. Written by the API into
+// 'pending' and latched into 'source' by the IRQ at vblank. The kernel and
+// expander setup are resolved from the format when the source is set.
+typedef struct
+{
+    dvi_format_t format;
+    const uint8_t *pixels;
+    uint32_t stride;
+    uint lines;
+    uint32_t flags;
+    dvi_scanline_cb_t render;
+    void *user;
+    const uint16_t *palette;
+    uint palette_size;
+    const void *const *line_tables;
+    const void *const *line_table; // the current frame's
+    uint phases;
+    uint phase;
+    line_prepare_t prepare_line;
+    line_stage_t post_pixels;
+    uint line_words;
+    uint scroll_x_max; // bytes a line can be scrolled and stay within stride
+    uint32_t expand_tmds;
+    uint32_t expand_shift;
+} dvi_source_t;
+
+// The mode's vertical timing, cached so the IRQ never reads flash.
+static const dvi_mode_t *mode;
+static uint v_sync_start;
+static uint v_sync_end;
+static uint v_active_start;
+static uint v_total_lines;
+static uint h_active_pixels;
+
+static dvi_source_t source;
+static dvi_source_t pending;
+static volatile bool pending_valid = false;
+static uint16_t pending_id = 0;
+
+static dvi_vblank_cb_t vblank_cb;
+static void *vblank_user;
+
+static bool running = false;
+static volatile uint32_t frame_count = 0;
+
+static uint8_t lane_bits[3] = {6, 4, 0};
+static uint clock_bit = 2;
+
+vmem_arena_t vmem_main;
+vmem_arena_t vmem_scratch;
+
+// Video memory: a reserved region in striped SRAM and the free part of
+// scratch_y (which also holds core 0's stack).
+#ifndef VMEM_MAIN_SIZE
+#define VMEM_MAIN_SIZE (8 * 1024)
+#endif
+#ifndef VMEM_SCRATCH_SIZE
+#define VMEM_SCRATCH_SIZE 1536
+#endif
+static uint8_t __attribute__((aligned(8))) vmem_main_ram[VMEM_MAIN_SIZE];
+static uint8_t __scanout_linebuf("vmem") __attribute__((aligned(8))) vmem_scratch_ram[VMEM_SCRATCH_SIZE];
+
+// Staged lines go through this buffer; the bench retargets it.
+char *volatile scanline_buf;
+
+// Rendered and palette-expanded lines are built a line ahead, alternately
+// into these two, while the DMA reads the other.
+static uint32_t *render_buf[2];
+
+// The PAL8 palette in use, reloaded from the source every vblank.
+static uint16_t *palette_ram;
+
+// The copper list on show and the next one, and the program's state in
+// the frame. Once the copper has moved or scrolled the framebuffer
+// (line_moved), its lines are read from line_pixels through the scroll
+// offsets; until then straight from the source.
+static const uint32_t *copper;
+static const uint32_t *copper_pending;
+static volatile bool copper_pending_valid = false;
+static const uint32_t *copper_pc;
+static uint copper_wait;
+static bool line_moved;
+static const uint8_t *line_pixels;
+static uint line_scroll_y;
+static uint line_scroll_x;
+
+// The cursor as set, its position packed as two int16_t so it is written
+// in one store, and the pair taken for the frame at vblank.
+static const dvi_cursor_t *volatile cursor_next;
+static volatile uint32_t cursor_next_at;
+static const dvi_cursor_t *cursor;
+static int cursor_x, cursor_y;
+static bool cursor_wide; // 16-bit pixels on the line
+// A direct or staged line is going out through render_buf for the cursor.
+static bool cursor_staged;
+
+#if DVI_BENCH
+volatile scanout_stats_t scanout_stats;
+volatile bool scanout_stats_reset = true;
+#endif
+
+// ----------------------------------------------------------------------------
+// DMA logic
+
+#define DMACH_PING 0
+#define DMACH_PONG 1
+
+// First we ping. Then we pong. Then... we ping again.
+static bool dma_pong = false;
+
+// A ping and a pong are cued up initially, so the first time we enter this
+// handler it is to cue up the second ping after the first ping has completed.
+// This is the third scanline overall (-> =2 because zero-based).
+static uint v_scanline = 2;
+
+// During the vertical active period, we take two IRQs per scanline: one to
+// post the command list, and another to post the pixels.
+static bool vactive_cmdlist_posted = false;
+
+enum source_kind
+{
+    SOURCE_DIRECT, // the DMA reads the framebuffer
+    SOURCE_STAGED, // framebuffer lines are copied into scanline_buf
+    SOURCE_RENDER, // a callback renders into render_buf
+    SOURCE_PAL8,   // indices are expanded through palette_ram into render_buf
+};
+
+// Framebuffer line y, from the current line table if Table.
+template <bool Table>
+static __force_inline const uint32_t *source_line(uint y)
+{
+    if constexpr (Table)
+        return (const uint32_t *)source.line_table[y];
+    else if (!line_moved)
+        return (const uint32_t *)(source.pixels + (y % source.lines) * source.stride);
+    else
+        return (const uint32_t *)(line_pixels + ((y + line_scroll_y) % source.lines) * source.stride +
+                                  line_scroll_x);
+}
+
+static __force_inline bool cursor_covers(uint y)
+{
+    return cursor && (uint)((int)y - cursor_y) < cursor->height;
+}
+
+static __force_inline uint8_t rgb332(uint16_t c)
+{
+    return (uint8_t)((c >> 8 & 0xe0) | (c >> 6 & 0x1c) | (c >> 3 & 0x03));
+}
+
+// Draw the cursor's row for line y over buf, clipped to the line.
+static void __not_in_flash_func(cursor_overlay)(uint32_t *buf, uint y)
+{
+    const dvi_cursor_t *c = cursor;
+    uint64_t row = c->rows[y - cursor_y];
+    int x = cursor_x;
+    uint n = c->width;
+    if (x < 0)
+    {
+        if ((uint)-x >= n)
+            return;
+        row >>= 2 * -x;
+        n += x;
+        x = 0;
+    }
+    if (x >= (int)h_active_pixels)
+        return;
+    if (n > h_active_pixels - x)
+        n = h_active_pixels - x;
+    if (n < 32)
+        row &= (1ull << 2 * n) - 1;
+    if (cursor_wide)
+    {
+        uint16_t *p = (uint16_t *)buf + x;
+        for (; row; row >>= 2, ++p)
+        {
+            uint v = row & 3;
+            if (v == DVI_CURSOR_INVERT)
+                *p = ~*p;
+            else if (v)
+                *p = c->colours[v - 1];
+        }
+    }
+    else
+    {
+        uint8_t *p = (uint8_t *)buf + x;
+        for (; row; row >>= 2, ++p)
+        {
+            uint v = row & 3;
+            if (v == DVI_CURSOR_INVERT)
+                *p = ~*p;
+            else if (v)
+                *p = rgb332(c->colours[v - 1]);
+        }
+    }
+}
+
+// The pixel IRQ of a line comes only ~6 us before the DMA needs them, too
+// little for a callback or a palette lookup per pixel, so those kinds
+// build line y when its command list is posted, while line y - 1 is
+// scanned out.
+template <uint Words, source_kind Kind>
+static void __not_in_flash_func(prepare_line)(uint y)
+{
+    const uint words = Words ? Words : source.line_words;
+    uint32_t *buf = render_buf[y & 1];
+    trace_event(TRACE_EV_TASK_BEGIN, TRACE_TASK_RENDER);
+    if constexpr (Kind == SOURCE_RENDER)
+    {
+        source.render(y, buf, source.user);
+    }
+    else
+    {
+        const uint32_t *src = source_line<false>(y);
+        if constexpr (Words != 0)
+            dvi::expand_pal8<Words>(buf, src, palette_ram);
+        else
+            dvi::expand_pal8(buf, src, palette_ram, words);
+    }
+    if (cursor_covers(y))
+        cursor_overlay(buf, y);
+    trace_event(TRACE_EV_TASK_END, TRACE_TASK_RENDER);
+}
+
+// Framebuffer lines need no preparing, except to go out through a line
+// buffer where the cursor crosses them.
+template <uint Words, bool Table>
+static void __not_in_flash_func(prepare_cursor)(uint y)
+{
+    cursor_staged = cursor_covers(y);
+    if (!cursor_staged)
+        return;
+    uint32_t *buf = render_buf[y & 1];
+    trace_event(TRACE_EV_TASK_BEGIN, TRACE_TASK_RENDER);
+    if constexpr (Words != 0)
+        dvi::copy_line<Words>(buf, source_line<Table>(y));
+    else
+        dvi::copy_line(buf, source_line<Table>(y), source.line_words);
+    cursor_overlay(buf, y);
+    trace_event(TRACE_EV_TASK_END, TRACE_TASK_RENDER);
+}
+
+// Words is the line length in words, or 0 to take it from the source for
+// widths without a specialisation. One instance per (Words, Kind) is picked
+// when the source is set, so the IRQ makes an indirect call instead of
+// testing the format and flags on every line.
+template <uint Words, source_kind Kind, bool Table>
+static void __scratch_x("") post_pixels(dma_channel_hw_t *ch, uint y)
+{
+    const uint words = Words ? Words : source.line_words;
+    if (Kind == SOURCE_RENDER || Kind == SOURCE_PAL8 || cursor_staged)
+    {
+        ch->read_addr = (uintptr_t)render_buf[y & 1];
+    }
+    else
+    {
+        const uint32_t *src = source_line<Table>(y);
+        if constexpr (Kind == SOURCE_STAGED)
+        {
+            uint32_t *buf = (uint32_t *)scanline_buf;
+            trace_event(TRACE_EV_TASK_BEGIN, TRACE_TASK_RENDER);
+            if constexpr (Words != 0)
+                dvi::copy_line<Words>(buf, src);
+            else
+                dvi::copy_line(buf, src, words);
+            trace_event(TRACE_EV_TASK_END, TRACE_TASK_RENDER);
+            ch->read_addr = (uintptr_t)buf;
+        }
+        else
+        {
+            ch->read_addr = (uintptr_t)src;
+        }
+    }
+    ch->transfer_count = words;
+}
+
+// Back to the top of the copper list, and the source as set.
+static void __not_in_flash_func(copper_frame)(void)
+{
+    copper_pc = copper;
+    copper_wait = 0;
+    line_moved = false;
+    line_pixels = source.pixels;
+    line_scroll_y = 0;
+    line_scroll_x = 0;
+}
+
+// Run the copper up to line y, before the line is built.
+static void __not_in_flash_func(copper_line)(uint y)
+{
+    const uint32_t *pc = copper_pc;
+    if (!pc || y < copper_wait)
+        return;
+    for (uint n = 0; n < DVI_COPPER_MAX_PER_LINE; ++n)
+    {
+        uint32_t op = *pc++;
+        switch (op >> 28)
+        {
+        case 0:
+            if ((op & 0xffff) > y)
+            {
+                copper_wait = op & 0xffff;
+                copper_pc = pc;
+                return;
+            }
+            break;
+        case 1:
+            palette_ram[(op >> 16) & 0xff] = (uint16_t)op;
+            break;
+        case 2:
+            line_scroll_y = op & 0xffff;
+            line_moved = true;
+            break;
+        case 3:
+            line_scroll_x = op & 0xfffc;
+            if (line_scroll_x > source.scroll_x_max)
+                line_scroll_x = source.scroll_x_max;
+            line_moved = true;
+            break;
+        case 4:
+            line_pixels = (const uint8_t *)(uintptr_t)*pc++;
+            line_moved = true;
+            break;
+        default:
+            copper_pc = NULL;
+            return;
+        }
+    }
+    // Out of time for this line.
+    copper_pc = pc;
+}
+
+static void __not_in_flash_func(latch_cursor)(void)
+{
+    cursor = cursor_next;
+    if (cursor)
+    {
+        uint32_t at = cursor_next_at;
+        cursor_x = (int16_t)at - cursor->hot_x;
+        cursor_y = (int16_t)(at >> 16) - cursor->hot_y;
+        cursor_wide = source.line_words * 4 > h_active_pixels;
+    }
+    cursor_staged = false;
+}
+
+static void __not_in_flash_func(latch_source)(void)
+{
+    source = pending;
+    pending_valid = false;
+    hstx_ctrl_hw->expand_tmds = source.expand_tmds;
+    hstx_ctrl_hw->expand_shift = source.expand_shift;
+    line_pixels = source.pixels;
+}
+
+static void __not_in_flash_func(next_phase)(void)
+{
+    if (++source.phase == source.phases)
+        source.phase = 0;
+    source.line_table = source.line_tables + source.phase * source.lines;
+}
+
+// Copied every frame rather than on latch only, so that writes to the
+// application's palette show from the next frame.
+static void __not_in_flash_func(load_palette)(void)
+{
+    for (uint i = 0; i < source.palette_size; ++i)
+        palette_ram[i] = source.palette[i];
+}
+
+static void __scratch_x("") dma_irq_handler()
+{
+    // dma_pong indicates the channel that just finished, which is the one
+    // we're about to reload.
+    trace_event(TRACE_EV_IRQ_ENTER, v_scanline);
+    uint32_t bench_entry = bench_irq_enter();
+    uint ch_num = dma_pong ? DMACH_PONG : DMACH_PING;
+    dma_channel_hw_t *ch = &dma_hw->ch[ch_num];
+    dma_hw->intr = 1u << ch_num;
+    dma_pong = !dma_pong;
+
+    if (v_scanline >= v_sync_start && v_scanline < v_sync_end)
+    {
+        ch->read_addr = (uintptr_t)cmdlists.vblank_vsync_on.words;
+        ch->transfer_count = cmdlists.vblank_vsync_on.length;
+    }
+    else if (v_scanline < v_active_start)
+    {
+        ch->read_addr = (uintptr_t)cmdlists.vblank_vsync_off.words;
+        ch->transfer_count = cmdlists.vblank_vsync_off.length;
+    }
+    else if (!vactive_cmdlist_posted)
+    {
+        ch->read_addr = (uintptr_t)cmdlists.vactive.words;
+        ch->transfer_count = cmdlists.vactive.length;
+        vactive_cmdlist_posted = true;
+        copper_line(v_scanline - v_active_start);
+        source.prepare_line(v_scanline - v_active_start);
+    }
+    else
+    {
+        uint y = v_scanline - v_active_start;
+        source.post_pixels(ch, y);
+        vactive_cmdlist_posted = false;
+        bench_active_line(bench_entry, y == 0);
+    }
+
+    if (!vactive_cmdlist_posted)
+    {
+        v_scanline = (v_scanline + 1) % v_total_lines;
+        if (v_scanline == 0)
+        {
+            // Start of the vertical front porch: the last active line's
+            // pixels are already with the DMA, so the source can change.
+            if (pending_valid)
+            {
+                latch_source();
+                trace_event(TRACE_EV_BUFFER_SWAP, pending_id);
+            }
+            else if (source.phases > 1)
+            {
+                next_phase();
+            }
+            if (source.palette)
+                load_palette();
+            if (copper_pending_valid)
+            {
+                copper = copper_pending;
+                copper_pending_valid = false;
+            }
+            copper_frame();
+            latch_cursor();
+            ++frame_count;
+            trace_event(TRACE_EV_VBLANK, (uint16_t)frame_count);
+            if (vblank_cb)
+                vblank_cb(frame_count, vblank_user);
+            __sev();
+        }
+    }
+    bench_irq_exit(bench_entry);
+    trace_event(TRACE_EV_IRQ_EXIT, v_scanline);
+}
+
+// ----------------------------------------------------------------------------
+// API
+
+static void __not_in_flash_func(blank_line)(uint y, void *buf, void *user)
+{
+    (void)y;
+    (void)user;
+    uint32_t *p = (uint32_t *)buf;
+    for (uint i = 0; i < source.line_words; ++i)
+        p[i] = 0;
+}
+
+void dvi_init(const dvi_mode_t *m)
+{
+    mode = m;
+    v_sync_start = m->v_front_porch;
+    v_sync_end = m->v_front_porch + m->v_sync_width;
+    v_active_start = v_sync_end + m->v_back_porch;
+    v_total_lines = v_active_start + m->v_active_lines;
+    h_active_pixels = m->h_active_pixels;
+
+    if (m != cmdlists_mode)
+    {
+        cmdlists = dvi::build_lists(*m);
+        hard_assert(dvi::check_lists(cmdlists, *m));
+        cmdlists_mode = m;
+    }
+
+    vmem_arena_init(&vmem_main, "main", vmem_main_ram, sizeof(vmem_main_ram));
+    vmem_arena_init(&vmem_scratch, "scratch", vmem_scratch_ram, sizeof(vmem_scratch_ram));
+
+    // Room for the widest format; fall back to striped SRAM for modes too
+    // wide for scratch_y.
+    size_t line_bytes = m->h_active_pixels * sizeof(uint16_t);
+    char *buf = (char *)vmem_alloc(&vmem_scratch, line_bytes, 4);
+    if (!buf)
+        buf = (char *)vmem_alloc(&vmem_main, line_bytes, 4);
+    hard_assert(buf);
+    scanline_buf = buf;
+
+    for (uint i = 0; i < 2; ++i)
+    {
+        render_buf[i] = (uint32_t *)vmem_alloc(&vmem_scratch, line_bytes, 4);
+        if (!render_buf[i])
+            render_buf[i] = (uint32_t *)vmem_alloc(&vmem_main, line_bytes, 4);
+        hard_assert(render_buf[i]);
+    }
+    palette_ram = (uint16_t *)vmem_alloc(&vmem_main, 256 * sizeof(uint16_t), 4);
+    hard_assert(palette_ram);
+
+    // Black until the application sets a source.
+    dvi_set_scanline_callback(DVI_FORMAT_RGB332, blank_line, NULL);
+}
+
+void dvi_set_pinout(const uint8_t lane_to_output_bit[3], uint clock_output_bit)
+{
+    for (uint lane = 0; lane < 3; ++lane)
+        lane_bits[lane] = lane_to_output_bit[lane];
+    clock_bit = clock_output_bit;
+}
+
+const dvi_mode_t *dvi_get_mode(void)
+{
+    return mode;
+}
+
+template <uint Words, source_kind Kind, bool Table = false>
+static void use_kind(dvi_source_t *src)
+{
+    if constexpr (Kind == SOURCE_RENDER || Kind == SOURCE_PAL8)
+        src->prepare_line = prepare_line<Words, Kind>;
+    else
+        src->prepare_line = prepare_cursor<Words, Table>;
+    src->post_pixels = post_pixels<Words, Kind, Table>;
+}
+
+// Only PAL8 framebuffers go through the palette, and they always do. Line
+// tables are for direct colour only.
+template <class Format, uint Words>
+static void stage_for(dvi_source_t *src, source_kind kind)
+{
+    if constexpr (Format::id == DVI_FORMAT_PAL8)
+    {
+        use_kind<Words, SOURCE_PAL8>(src);
+    }
+    else if (kind == SOURCE_RENDER)
+    {
+        use_kind<Words, SOURCE_RENDER>(src);
+    }
+    else if (src->line_tables)
+    {
+        if (kind == SOURCE_STAGED)
+            use_kind<Words, SOURCE_STAGED, true>(src);
+        else
+            use_kind<Words, SOURCE_DIRECT, true>(src);
+    }
+    else if (kind == SOURCE_STAGED)
+    {
+        use_kind<Words, SOURCE_STAGED>(src);
+    }
+    else
+    {
+        use_kind<Words, SOURCE_DIRECT>(src);
+    }
+}
+
+// Kernels are specialised for the width of the built-in mode; other widths
+// use the run-time length ones.
+template <class Format>
+static void resolve_format(dvi_source_t *src, source_kind kind)
+{
+    using Scanout = typename Format::scanout;
+    src->line_words = h_active_pixels * Scanout::bytes_per_pixel / sizeof(uint32_t);
+    uint line_bytes = h_active_pixels * Format::bytes_per_pixel;
+    src->scroll_x_max = src->stride > line_bytes ? (src->stride - line_bytes) & ~3u : 0;
+    src->expand_tmds = Scanout::expand_tmds;
+    src->expand_shift = Scanout::expand_shift;
+    if (h_active_pixels == 640)
+        stage_for<Format, dvi::line_words<Format, 640>>(src, kind);
+    else
+        stage_for<Format, 0>(src, kind);
+}
+
+static void set_source(dvi_source_t *src)
+{
+    source_kind kind = src->render                 ? SOURCE_RENDER
+                       : src->flags & DVI_FB_STAGED ? SOURCE_STAGED
+                                                    : SOURCE_DIRECT;
+    switch (src->format)
+    {
+    case DVI_FORMAT_RGB565:
+        resolve_format<dvi::Rgb565>(src, kind);
+        break;
+    case DVI_FORMAT_PAL8:
+        hard_assert(!src->render && !src->line_tables && src->palette && src->palette_size <= 256);
+        resolve_format<dvi::Pal8>(src, kind);
+        break;
+    default:
+        resolve_format<dvi::Rgb332>(src, kind);
+        break;
+    }
+
+    if (!running)
+    {
+        pending = *src;
+        latch_source();
+        if (source.palette)
+            load_palette();
+        return;
+    }
+    // Wait for the IRQ to take the previous request, then post this one.
+    while (pending_valid)
+        tight_loop_contents();
+    pending = *src;
+    ++pending_id;
+    __dmb();
+    pending_valid = true;
+}
+
+void dvi_set_framebuffer(const dvi_framebuffer_t *fb)
+{
+    dvi_source_t src = {};
+    src.format = fb->format;
+    src.pixels = (const uint8_t *)fb->pixels;
+    src.stride = fb->stride;
+    src.lines = fb->lines ? fb->lines : mode->v_active_lines;
+    src.flags = fb->flags;
+    src.palette = fb->palette;
+    src.palette_size = fb->palette_size;
+    set_source(&src);
+}
+
+void dvi_set_line_table(const dvi_line_table_t *t)
+{
+    hard_assert(t->phases >= 1 && t->phases <= DVI_FRC_MAX_PHASES);
+    dvi_source_t src = {};
+    src.format = t->format;
+    src.lines = mode->v_active_lines;
+    src.flags = t->flags;
+    src.line_tables = t->lines;
+    src.line_table = t->lines;
+    src.phases = t->phases;
+    set_source(&src);
+}
+
+void dvi_set_scanline_callback(dvi_format_t format, dvi_scanline_cb_t cb, void *user)
+{
+    dvi_source_t src = {};
+    src.format = format;
+    src.render = cb;
+    src.user = user;
+    set_source(&src);
+}
+
+void dvi_set_copper(const uint32_t *list)
+{
+    if (!running)
+    {
+        copper = list;
+        copper_frame();
+        return;
+    }
+    // As for sources, one request at a time.
+    while (copper_pending_valid)
+        tight_loop_contents();
+    copper_pending = list;
+    __dmb();
+    copper_pending_valid = true;
+}
+
+void dvi_set_cursor(const dvi_cursor_t *c)
+{
+    hard_assert(!c || (c->width <= DVI_CURSOR_SIZE && c->height <= DVI_CURSOR_SIZE));
+    cursor_next = c;
+    if (!running)
+        latch_cursor();
+}
+
+void dvi_move_cursor(int x, int y)
+{
+    cursor_next_at = (uint16_t)x | (uint32_t)(uint16_t)y << 16;
+    if (!running)
+        latch_cursor();
+}
+
+void dvi_set_vblank_callback(dvi_vblank_cb_t cb, void *user)
+{
+    uint32_t save = save_and_disable_interrupts();
+    vblank_cb = cb;
+    vblank_user = user;
+    restore_interrupts(save);
+}
+
+uint32_t dvi_frame_count(void)
+{
+    return frame_count;
+}
+
+void dvi_wait_vblank(void)
+{
+    uint32_t frame = frame_count;
+    while (frame_count == frame)
+        __wfe();
+}
+
+bool dvi_get_view(dvi_view_t *view)
+{
+    // The IRQ latches new sources just before counting the frame, so after
+    // that the source holds until the next vblank.
+    if (running)
+        dvi_wait_vblank();
+    if (source.render)
+        return false;
+    view->format = source.format;
+    view->pixels = source.pixels;
+    view->stride = source.stride;
+    view->lines = source.lines;
+    view->line_table = source.line_tables ? source.line_table : NULL;
+    view->palette = source.palette;
+    view->palette_size = source.palette_size;
+    return true;
+}
+
+void dvi_start(void)
+{
+    // Serial output config: clock period of 5 cycles, pop from command
+    // expander every 5 cycles, shift the output shiftreg by 2 every cycle.
+    hstx_ctrl_hw->csr = 0;
+    hstx_ctrl_hw->csr =
+        HSTX_CTRL_CSR_EXPAND_EN_BITS |
+        5u << HSTX_CTRL_CSR_CLKDIV_LSB |
+        5u << HSTX_CTRL_CSR_N_SHIFTS_LSB |
+        2u << HSTX_CTRL_CSR_SHIFT_LSB |
+        HSTX_CTRL_CSR_EN_BITS;
+
+    // Note we are leaving the HSTX clock at the SDK default of 125 MHz; since
+    // we shift out two bits per HSTX clock cycle, this gives us an output of
+    // 250 Mbps, which is very close to the bit clock for 480p 60Hz (252 MHz).
+    // If we want the exact rate then we'll have to reconfigure PLLs.
+
+    // HSTX outputs 0 through 7 appear on GPIO 12 through 19. The default
+    // pinout (see dvi_set_pinout()) matches the Adafruit Metro RP2350:
+    // https://learn.adafruit.com/adafruit-metro-rp2350/pinouts#hstx-connector-3193107
+    //
+    //   GP12 D2+  GP13 D2-
+    //   GP14 CK+  GP15 CK-
+    //   GP16 D1+  GP17 D1-
+    //   GP18 D0+  GP19 D0-
+
+    // Assign clock pair to two neighbouring pins:
+    hstx_ctrl_hw->bit[clock_bit] = HSTX_CTRL_BIT0_CLK_BITS;
+    hstx_ctrl_hw->bit[clock_bit + 1] = HSTX_CTRL_BIT0_CLK_BITS | HSTX_CTRL_BIT0_INV_BITS;
+    for (uint lane = 0; lane < 3; ++lane)
+    {
+        // For each TMDS lane, assign it to the correct GPIO pair based on the
+        // desired pinout:
+        int bit = lane_bits[lane];
+        // Output even bits during first half of each HSTX cycle, and odd bits
+        // during second half. The shifter advances by two bits each cycle.
+        uint32_t lane_data_sel_bits =
+            (lane * 10) << HSTX_CTRL_BIT0_SEL_P_LSB |
+            (lane * 10 + 1) << HSTX_CTRL_BIT0_SEL_N_LSB;
+        // The two halves of each pair get identical data, but one pin is inverted.
+        hstx_ctrl_hw->bit[bit] = lane_data_sel_bits;
+        hstx_ctrl_hw->bit[bit + 1] = lane_data_sel_bits | HSTX_CTRL_BIT0_INV_BITS;
+    }
+
+    for (int i = 12; i <= 19; ++i)
+    {
+        gpio_set_function(i, 0); // HSTX
+    }
+
+    // Both channels are set up identically, to transfer a whole scanline and
+    // then chain to the opposite channel. Each time a channel finishes, we
+    // reconfigure the one that just finished, meanwhile the opposite channel
+    // is already making progress.
+    dma_channel_config c;
+    c = dma_channel_get_default_config(DMACH_PING);
+    channel_config_set_chain_to(&c, DMACH_PONG);
+    channel_config_set_dreq(&c, DREQ_HSTX);
+    dma_channel_configure(
+        DMACH_PING,
+        &c,
+        &hstx_fifo_hw->fifo,
+        cmdlists.vblank_vsync_off.words,
+        cmdlists.vblank_vsync_off.length,
+        false);
+    c = dma_channel_get_default_config(DMACH_PONG);
+    channel_config_set_chain_to(&c, DMACH_PING);
+    channel_config_set_dreq(&c, DREQ_HSTX);
+    dma_channel_configure(
+        DMACH_PONG,
+        &c,
+        &hstx_fifo_hw->fifo,
+        cmdlists.vblank_vsync_off.words,
+        cmdlists.vblank_vsync_off.length,
+        false);
+
+    dma_hw->ints0 = (1u << DMACH_PING) | (1u << DMACH_PONG);
+    dma_hw->inte0 = (1u << DMACH_PING) | (1u << DMACH_PONG);
+    irq_set_exclusive_handler(DMA_IRQ_0, dma_irq_handler);
+    irq_set_enabled(DMA_IRQ_0, true);
+
+    bus_ctrl_hw->priority = BUSCTRL_BUS_PRIORITY_DMA_W_BITS | BUSCTRL_BUS_PRIORITY_DMA_R_BITS;
+
+    running = true;
+    dma_channel_start(DMACH_PING);
+}
@@ -0,0 +1,227 @@
+// DVI output driver using the HSTX command expander and TMDS encoder.
+
+// The driver owns HSTX, DMA channels 0 and 1 and DMA_IRQ_0 on the core that
+// calls dvi_start(). Each active line comes either from a framebuffer (read
+// by the DMA directly, or copied through a staging buffer in scratch_y) or
+// from a scanline callback that renders into the staging buffer. Sources
+// set from another core take effect at the next vblank.
+//
+// Typical use:
+//
+//   dvi_init(&dvi_mode_640x480_60);
+//   dvi_set_framebuffer(&(dvi_framebuffer_t){pixels, DVI_FORMAT_RGB332, 480, 640, DVI_FB_STAGED});
+//   multicore_launch_core1(core1_main); // core1_main calls dvi_start()
+
+#ifndef _DVI_HSTX_H
+#define _DVI_HSTX_H
+
+#include "pico/stdlib.h"
+#include "vmem.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum
+{
+    DVI_FORMAT_RGB332, // 8 bpp, RRRGGGBB
+    DVI_FORMAT_RGB565, // 16 bpp little-endian, RRRRRGGGGGGBBBBB
+    DVI_FORMAT_PAL8,   // 8 bpp index into an RGB565 palette (framebuffers only)
+    DVI_FORMAT_COUNT
+} dvi_format_t;
+
+// Video timing. Porch and sync widths in pixels/lines; a polarity of 0
+// means the sync pulse is active low.
+typedef struct
+{
+    uint16_t h_front_porch;
+    uint16_t h_sync_width;
+    uint16_t h_back_porch;
+    uint16_t h_active_pixels;
+    uint16_t v_front_porch;
+    uint16_t v_sync_width;
+    uint16_t v_back_porch;
+    uint16_t v_active_lines;
+    bool h_sync_polarity;
+    bool v_sync_polarity;
+} dvi_mode_t;
+
+extern const dvi_mode_t dvi_mode_640x480_60;
+
+static inline uint8_t dvi_rgb332(uint8_t r, uint8_t g, uint8_t b)
+{
+    return (r & 0xe0) | (g & 0xe0) >> 3 | b >> 6;
+}
+
+static inline uint16_t dvi_rgb565(uint8_t r, uint8_t g, uint8_t b)
+{
+    return (uint16_t)(r & 0xf8) << 8 | (uint16_t)(g & 0xfc) << 3 | b >> 3;
+}
+
+// Copy each framebuffer line through the staging buffer in scratch_y
+// instead of pointing the DMA at it, which keeps the DMA off the banks the
+// framebuffer shares with application data. PAL8 framebuffers are always
+// expanded through a line buffer.
+#define DVI_FB_STAGED (1u << 0)
+
+typedef struct
+{
+    const void *pixels;
+    dvi_format_t format;
+    uint16_t lines;  // lines stored; the image repeats down the screen if
+                     // fewer than the mode's active lines
+    uint32_t stride; // bytes from one line to the next, multiple of 4
+    uint32_t flags;  // DVI_FB_*
+    const uint16_t *palette; // DVI_FORMAT_PAL8: RGB565 entries, re-read
+    uint16_t palette_size;   // every vblank so they can be animated
+} dvi_framebuffer_t;
+
+// Lines given by pointer, one table per frame: frame n shows
+// lines[(n % phases) * v_active_lines + y] as line y. Cycling through
+// differently dithered phases of an image makes the eye average them into
+// colours the format cannot show (frame-rate control); a table can also
+// repeat or reorder lines at no cost.
+#define DVI_FRC_MAX_PHASES 4
+
+typedef struct
+{
+    const void *const *lines; // phases * v_active_lines pointers, word aligned
+    dvi_format_t format;      // RGB332 or RGB565
+    uint8_t phases;           // 1 to DVI_FRC_MAX_PHASES
+    uint32_t flags;           // DVI_FB_STAGED
+} dvi_line_table_t;
+
+// What the display reads, for reading it back. Line y is line_table[y] if
+// line_table is set, else pixels + (y % lines) * stride.
+typedef struct
+{
+    dvi_format_t format;
+    const uint8_t *pixels;
+    uint32_t stride;
+    uint lines;
+    const void *const *line_table; // the phase on show, for line tables
+    const uint16_t *palette;
+    uint palette_size;
+} dvi_view_t;
+
+// Fill line y (0 = first active line) of h_active_pixels pixels into buf,
+// which is word aligned. Called from the DMA IRQ while the line before is
+// scanned out, so it should live in RAM and return well within one line
+// period. Callbacks render RGB332 or RGB565, not PAL8.
+typedef void (*dvi_scanline_cb_t)(uint y, void *buf, void *user);
+
+// Called from the DMA IRQ at the start of vertical blanking, after pending
+// sources have been latched.
+typedef void (*dvi_vblank_cb_t)(uint frame, void *user);
+
+// Copper lists (dvi_set_copper()): a program of 32-bit words run by the
+// IRQ as it scans down the frame, changing scanout state between lines.
+// DVI_COPPER_WAIT holds the program until a line; the others take effect
+// from the line the program has reached. Effects:
+//
+//   PALETTE   set a PAL8 palette entry, from the next line drawn
+//   SCROLL_Y  read framebuffer line (y + lines) % height for line y
+//   SCROLL_X  start each framebuffer line bytes in, a multiple of 4, at
+//             most the stride less the line's bytes, so lines never read
+//             past their stride: scrolling needs a stride wider than the line
+//   PIXELS    read framebuffer lines from the address in the next word
+//
+// Each frame starts at the top of the list with the source's own palette,
+// pixels and no scroll. SCROLL and PIXELS apply to framebuffers, PALETTE to
+// PAL8 ones; scanline callbacks can vary their own state per line.
+#define DVI_COPPER_WAIT(line) ((uint32_t)(line) & 0xffffu)
+#define DVI_COPPER_PALETTE(index, rgb565) (0x10000000u | ((uint32_t)(index) & 0xffu) << 16 | (rgb565))
+#define DVI_COPPER_SCROLL_Y(lines) (0x20000000u | ((uint32_t)(lines) & 0xffffu))
+#define DVI_COPPER_SCROLL_X(bytes) (0x30000000u | ((uint32_t)(bytes) & 0xfffcu))
+#define DVI_COPPER_PIXELS 0x40000000u
+#define DVI_COPPER_END 0xf0000000u
+
+// Instructions run per line at most; a program that has more to do by a
+// line carries on at the next, so the IRQ's time per line stays bounded.
+#ifndef DVI_COPPER_MAX_PER_LINE
+#define DVI_COPPER_MAX_PER_LINE 16
+#endif
+
+// A cursor drawn over whatever is on show as each line goes out, so moving
+// it writes nothing to the framebuffer: rendered and palette lines get it
+// in their line buffer, and framebuffer lines it covers are staged through
+// one. Rows hold 2 bits a pixel, the left pixel in the low bits. Screenshots
+// (dvi_get_view()) leave it out.
+#define DVI_CURSOR_SIZE 32
+#define DVI_CURSOR_CLEAR 0   // transparent
+#define DVI_CURSOR_COLOUR0 1 // colours[0]
+#define DVI_CURSOR_COLOUR1 2 // colours[1]
+#define DVI_CURSOR_INVERT 3  // inverts the pixel beneath
+
+typedef struct
+{
+    uint64_t rows[DVI_CURSOR_SIZE];
+    uint16_t colours[2];   // RGB565, shown as RGB332 on RGB332 sources
+    uint8_t width, height; // up to DVI_CURSOR_SIZE
+    uint8_t hot_x, hot_y;  // the pixel placed at the cursor position
+} dvi_cursor_t;
+
+// Video memory arenas (vmem.h) in striped SRAM and scratch_y. dvi_init()
+// resets both and takes the staging buffer from them, so allocate
+// application video buffers after calling it.
+extern vmem_arena_t vmem_main;
+extern vmem_arena_t vmem_scratch;
+
+// Set up the driver state for a mode. May be called again before
+// dvi_start() to change mode.
+void dvi_init(const dvi_mode_t *mode);
+
+// Map TMDS lanes D0-D2 and the clock to HSTX output bits (GPIO 12 + bit).
+// Each pair uses bit and bit + 1, with the odd bit inverted. The default is
+// the Adafruit Metro RP2350 layout: D0 = 6, D1 = 4, D2 = 0, clock = 2.
+void dvi_set_pinout(const uint8_t lane_to_output_bit[3], uint clock_output_bit);
+
+const dvi_mode_t *dvi_get_mode(void);
+uint dvi_format_bytes_per_pixel(dvi_format_t format);
+
+// Display a framebuffer. The struct is copied.
+void dvi_set_framebuffer(const dvi_framebuffer_t *fb);
+
+// Display lines through per-frame pointer tables. The struct is copied; the
+// tables are read by the IRQ and should be in RAM.
+void dvi_set_line_table(const dvi_line_table_t *t);
+
+// Render active lines with cb instead of reading a framebuffer.
+void dvi_set_scanline_callback(dvi_format_t format, dvi_scanline_cb_t cb, void *user);
+
+void dvi_set_vblank_callback(dvi_vblank_cb_t cb, void *user);
+
+// Configure HSTX, the DMA channels and DMA_IRQ_0 on the calling core and
+// start scanout. Returns once running; the caller usually idles in __wfi().
+void dvi_start(void);
+
+// Run list, ended by DVI_COPPER_END, from the next vblank; NULL for none.
+// The IRQ reads it as the frame goes, so it should be in RAM. A list
+// rewritten every frame alternates between two buffers, each written after
+// the vblank that took the other (dvi_wait_vblank()).
+void dvi_set_copper(const uint32_t *list);
+
+// Show cursor, or hide it if NULL, from the next vblank. The IRQ reads the
+// image on the lines it covers, so it should be in RAM.
+void dvi_set_cursor(const dvi_cursor_t *cursor);
+
+// Put the cursor's hot spot at (x, y) from the next vblank. It may be
+// partly or wholly off the screen.
+void dvi_move_cursor(int x, int y);
+
+// Frames started since dvi_start().
+uint32_t dvi_frame_count(void);
+
+// Block until the next vblank begins.
+void dvi_wait_vblank(void);
+
+// Describe the source on show from the next vblank, waiting for it once
+// running; it then stays on show for at least a frame. Returns false for a
+// scanline callback, whose lines only exist while scanned out.
+bool dvi_get_view(dvi_view_t *view);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
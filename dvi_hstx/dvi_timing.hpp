@@ -0,0 +1,217 @@
+// Video modes and their HSTX command lists, built at compile time.
+
+// Every scanline is one DMA transfer of a command list: a blanking line
+// with or without vsync, or the preamble of an active line, which ends in
+// a TMDS command that the pixel transfer then feeds. build_lists() derives
+// the three lists from a dvi_mode_t and check_lists() decodes them again
+// the way the command expander will, so a mode can be validated with
+// static_assert:
+//
+//   constexpr dvi_mode_t my_mode = {...};
+//   static_assert(dvi::mode_valid(my_mode), "bad timing for my_mode");
+//
+// Both are ordinary functions too; dvi_init() uses them for modes only
+// known at run time.
+
+#ifndef _DVI_TIMING_HPP
+#define _DVI_TIMING_HPP
+
+#include <cstdint>
+#include "dvi_hstx.h"
+
+namespace dvi
+{
+
+constexpr dvi_mode_t mode_640x480_60 = {
+    16, 96, 48, 640, // h front porch, sync, back porch, active
+    10, 2, 33, 480,  // v front porch, sync, back porch, active
+    false, false,    // h, v sync active low
+};
+
+constexpr uint h_total_pixels(const dvi_mode_t &m)
+{
+    return m.h_front_porch + m.h_sync_width + m.h_back_porch + m.h_active_pixels;
+}
+
+constexpr uint v_total_lines(const dvi_mode_t &m)
+{
+    return m.v_front_porch + m.v_sync_width + m.v_back_porch + m.v_active_lines;
+}
+
+// ----------------------------------------------------------------------------
+// DVI and HSTX constants
+
+constexpr uint32_t tmds_ctrl_00 = 0x354u;
+constexpr uint32_t tmds_ctrl_01 = 0x0abu;
+constexpr uint32_t tmds_ctrl_10 = 0x154u;
+constexpr uint32_t tmds_ctrl_11 = 0x2abu;
+
+// Indexed by C1 << 1 | C0.
+constexpr uint32_t tmds_ctrl[4] = {tmds_ctrl_00, tmds_ctrl_01, tmds_ctrl_10, tmds_ctrl_11};
+
+constexpr uint32_t hstx_cmd_raw = 0x0u << 12;
+constexpr uint32_t hstx_cmd_raw_repeat = 0x1u << 12;
+constexpr uint32_t hstx_cmd_tmds = 0x2u << 12;
+constexpr uint32_t hstx_cmd_tmds_repeat = 0x3u << 12;
+constexpr uint32_t hstx_cmd_nop = 0xfu << 12;
+constexpr uint32_t hstx_cmd_op_mask = 0xfu << 12;
+constexpr uint32_t hstx_cmd_len_mask = 0xfffu;
+
+// Lists are padded with NOPs to at least the depth of the HSTX FIFO.
+// Anything shorter and the DMA completes, and raises its IRQ again, before
+// the previous IRQ has reloaded the other channel.
+constexpr uint hstx_fifo_depth = 8;
+
+// Control symbols for lane 0 carry the syncs (C1 = vsync, C0 = hsync);
+// lanes 1 and 2 send CTRL_00. A polarity of 0 means active low.
+constexpr uint32_t sync_symbol(const dvi_mode_t &m, bool vsync, bool hsync)
+{
+    uint v = vsync == m.v_sync_polarity;
+    uint h = hsync == m.h_sync_polarity;
+    return tmds_ctrl[v << 1 | h] | (tmds_ctrl_00 << 10) | (tmds_ctrl_00 << 20);
+}
+
+// ----------------------------------------------------------------------------
+// Command lists
+
+template <uint N>
+struct CmdList
+{
+    static constexpr uint length = N;
+    uint32_t words[N];
+};
+
+struct ScanlineLists
+{
+    CmdList<8> vblank_vsync_off;
+    CmdList<8> vblank_vsync_on;
+    CmdList<9> vactive;
+};
+
+constexpr CmdList<8> build_vblank_line(const dvi_mode_t &m, bool vsync)
+{
+    return {{
+        hstx_cmd_raw_repeat | m.h_front_porch,
+        sync_symbol(m, vsync, false),
+        hstx_cmd_raw_repeat | m.h_sync_width,
+        sync_symbol(m, vsync, true),
+        hstx_cmd_raw_repeat | (m.h_back_porch + m.h_active_pixels),
+        sync_symbol(m, vsync, false),
+        hstx_cmd_nop,
+        hstx_cmd_nop,
+    }};
+}
+
+constexpr CmdList<9> build_vactive_line(const dvi_mode_t &m)
+{
+    return {{
+        hstx_cmd_raw_repeat | m.h_front_porch,
+        sync_symbol(m, false, false),
+        hstx_cmd_nop,
+        hstx_cmd_raw_repeat | m.h_sync_width,
+        sync_symbol(m, false, true),
+        hstx_cmd_nop,
+        hstx_cmd_raw_repeat | m.h_back_porch,
+        sync_symbol(m, false, false),
+        hstx_cmd_tmds | m.h_active_pixels,
+    }};
+}
+
+constexpr ScanlineLists build_lists(const dvi_mode_t &m)
+{
+    return {
+        build_vblank_line(m, false),
+        build_vblank_line(m, true),
+        build_vactive_line(m),
+    };
+}
+
+// ----------------------------------------------------------------------------
+// Validation
+
+// True if sym is a control symbol on lane 0, CTRL_00 on lanes 1 and 2, and
+// its C1/C0 bits are the line levels for the given sync states.
+constexpr bool sync_symbol_ok(uint32_t sym, const dvi_mode_t &m, bool vsync, bool hsync)
+{
+    if (sym >> 10 != (tmds_ctrl_00 | tmds_ctrl_00 << 10))
+        return false;
+    for (uint c = 0; c < 4; ++c)
+    {
+        if (tmds_ctrl[c] == (sym & 0x3ffu))
+        {
+            bool c1 = c >> 1, c0 = c & 1;
+            return c1 == (vsync ? m.v_sync_polarity : !m.v_sync_polarity) &&
+                   c0 == (hsync ? m.h_sync_polarity : !m.h_sync_polarity);
+        }
+    }
+    return false;
+}
+
+// Walk a list as the command expander would. It must be at least
+// hstx_fifo_depth words, cover exactly h_total_pixels(), assert hsync over
+// exactly the sync pulse and vsync on every period of a vsync line, and
+// (only) an active line must end with a TMDS command for the active pixels.
+template <uint N>
+constexpr bool check_list(const CmdList<N> &list, const dvi_mode_t &m, bool vsync, bool active)
+{
+    if (N < hstx_fifo_depth)
+        return false;
+    const uint sync_start = m.h_front_porch;
+    const uint sync_end = sync_start + m.h_sync_width;
+    const uint pixels_start = sync_end + m.h_back_porch;
+    uint pos = 0;
+    bool saw_pixels = false;
+    for (uint i = 0; i < N;)
+    {
+        uint32_t op = list.words[i] & hstx_cmd_op_mask;
+        uint len = list.words[i] & hstx_cmd_len_mask;
+        ++i;
+        if (op == hstx_cmd_nop)
+            continue;
+        if (op == hstx_cmd_tmds)
+        {
+            if (!active || saw_pixels || pos != pixels_start || len != m.h_active_pixels)
+                return false;
+            saw_pixels = true;
+            pos += len;
+            continue;
+        }
+        if (op != hstx_cmd_raw && op != hstx_cmd_raw_repeat)
+            return false;
+        if (i == N)
+            return false;
+        uint32_t sym = list.words[i++];
+        uint count = op == hstx_cmd_raw_repeat ? len : 1;
+        if (count == 0)
+            return false;
+        // A run may not straddle either edge of the hsync pulse.
+        bool hsync = pos >= sync_start && pos + count <= sync_end;
+        bool blank = pos + count <= sync_start || pos >= sync_end;
+        if (!(hsync || blank) || !sync_symbol_ok(sym, m, vsync, hsync))
+            return false;
+        pos += count;
+    }
+    return pos == h_total_pixels(m) && saw_pixels == active;
+}
+
+constexpr bool check_lists(const ScanlineLists &l, const dvi_mode_t &m)
+{
+    return check_list(l.vblank_vsync_off, m, false, false) &&
+           check_list(l.vblank_vsync_on, m, true, false) &&
+           check_list(l.vactive, m, false, true);
+}
+
+constexpr bool mode_valid(const dvi_mode_t &m)
+{
+    return m.h_sync_width > 0 && m.h_active_pixels > 0 &&
+           m.v_sync_width > 0 && m.v_active_lines > 0 &&
+           check_lists(build_lists(m), m);
+}
+
+static_assert(mode_valid(mode_640x480_60), "640x480 timing");
+static_assert(h_total_pixels(mode_640x480_60) == 800 && v_total_lines(mode_640x480_60) == 525,
+              "640x480 totals");
+
+} // namespace dvi
+
+#endif
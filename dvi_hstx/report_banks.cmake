@@ -0,0 +1,37 @@
+# Report the scratch bank sections of an ELF, see dvi_hstx_report_banks().
+#
+#   cmake -DELF=<file> -DOBJDUMP=<objdump> -P report_banks.cmake
+#
+# The SDK's linker script puts .scratch_x and core 1's stack (.stack1_dummy)
+# in SRAM8, and .scratch_y and core 0's stack (.stack_dummy) in SRAM9.
+
+execute_process(COMMAND ${OBJDUMP} -h ${ELF} OUTPUT_VARIABLE headers RESULT_VARIABLE result)
+if (NOT result EQUAL 0)
+    message(WARNING "report_banks: ${OBJDUMP} -h ${ELF} failed")
+    return()
+endif()
+
+function(section_size name out)
+    set(size 0)
+    string(REGEX MATCH " ${name} +([0-9a-f]+)" match "${headers}")
+    if (match)
+        math(EXPR size "0x${CMAKE_MATCH_1}")
+    endif()
+    set(${out} ${size} PARENT_SCOPE)
+endfunction()
+
+foreach (bank x y)
+    if (bank STREQUAL "x")
+        set(stack .stack1_dummy)
+    else()
+        set(stack .stack_dummy)
+    endif()
+    section_size(\\.scratch_${bank} code)
+    section_size(\\${stack} stack)
+    math(EXPR total "${code} + ${stack}")
+    message(STATUS "scratch_${bank}: ${code} bytes of sections + ${stack} of stack = ${total} of 4096")
+    if (total GREATER 4096)
+        math(EXPR over "${total} - 4096")
+        message(WARNING "scratch_${bank} is ${over} bytes over its 4 KiB bank")
+    endif()
+endforeach()
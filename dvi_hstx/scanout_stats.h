@@ -0,0 +1,102 @@
+// Scanout statistics for benchmarking.
+
+// Enabled in the dvi_hstx_bench library variant only (DVI_BENCH=1). The DMA
+// IRQ handler calls the hooks below to collect FIFO and timing statistics;
+// in normal builds they compile to nothing.
+
+#ifndef _SCANOUT_STATS_H
+#define _SCANOUT_STATS_H
+
+#include "pico/stdlib.h"
+#include "hardware/structs/hstx_fifo.h"
+#include "hardware/structs/sio.h"
+
+#ifndef DVI_BENCH
+#define DVI_BENCH 0
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct
+{
+    uint32_t irqs;
+    uint32_t fifo_empty;      // IRQ entries that found the HSTX FIFO empty (underflow)
+    uint32_t fifo_min_level;  // lowest FIFO level seen at IRQ entry
+    uint32_t irq_max_cycles;  // longest DMA IRQ handler run
+    uint32_t line_min_cycles; // shortest/longest interval between pixel IRQs
+    uint32_t line_max_cycles; // of consecutive active lines
+    uint32_t last_line_entry;
+} scanout_stats_t;
+
+extern volatile scanout_stats_t scanout_stats;
+extern volatile bool scanout_stats_reset;
+
+// Staging buffer the DMA IRQ copies DVI_FB_STAGED lines into. The bench
+// points this at buffers in different SRAM banks.
+extern char *volatile scanline_buf;
+
+static __force_inline uint32_t bench_irq_enter(void)
+{
+#if DVI_BENCH
+    uint32_t now = sio_hw->mtime;
+    uint32_t stat = hstx_fifo_hw->stat;
+    if (scanout_stats_reset)
+    {
+        scanout_stats.irqs = 0;
+        scanout_stats.fifo_empty = 0;
+        scanout_stats.fifo_min_level = HSTX_FIFO_STAT_LEVEL_BITS;
+        scanout_stats.irq_max_cycles = 0;
+        scanout_stats.line_min_cycles = UINT32_MAX;
+        scanout_stats.line_max_cycles = 0;
+        scanout_stats.last_line_entry = 0;
+        scanout_stats_reset = false;
+    }
+    scanout_stats.irqs++;
+    if (stat & HSTX_FIFO_STAT_EMPTY_BITS)
+        scanout_stats.fifo_empty++;
+    if ((stat & HSTX_FIFO_STAT_LEVEL_BITS) < scanout_stats.fifo_min_level)
+        scanout_stats.fifo_min_level = stat & HSTX_FIFO_STAT_LEVEL_BITS;
+    return now;
+#else
+    return 0;
+#endif
+}
+
+static __force_inline void bench_irq_exit(uint32_t entry)
+{
+#if DVI_BENCH
+    uint32_t cycles = sio_hw->mtime - entry;
+    if (cycles > scanout_stats.irq_max_cycles)
+        scanout_stats.irq_max_cycles = cycles;
+#else
+    (void)entry;
+#endif
+}
+
+// Called from the IRQ that posts a line's pixels. first_line breaks the
+// interval chain across vblank.
+static __force_inline void bench_active_line(uint32_t entry, bool first_line)
+{
+#if DVI_BENCH
+    if (!first_line && scanout_stats.last_line_entry)
+    {
+        uint32_t interval = entry - scanout_stats.last_line_entry;
+        if (interval < scanout_stats.line_min_cycles)
+            scanout_stats.line_min_cycles = interval;
+        if (interval > scanout_stats.line_max_cycles)
+            scanout_stats.line_max_cycles = interval;
+    }
+    scanout_stats.last_line_entry = entry;
+#else
+    (void)entry;
+    (void)first_line;
+#endif
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
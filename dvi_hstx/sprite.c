@@ -0,0 +1,191 @@
+// Sprites, see sprite.h.
+
+#include "sprite.h"
+#include "hardware/sync.h"
+#include <string.h>
+
+void sprite_init(sprite_layer_t *t, dvi_scanline_cb_t background, void *background_user)
+{
+    memset(t, 0, sizeof(*t));
+    t->background = background;
+    t->background_user = background_user;
+    const dvi_mode_t *mode = dvi_get_mode();
+    hard_assert(mode->v_active_lines <= SPRITE_MAX_LINES);
+    t->width = mode->h_active_pixels;
+    t->lines = mode->v_active_lines;
+}
+
+// Lines [*y0, *y1) of s on the screen; false if none or hidden.
+static bool visible_lines(const sprite_layer_t *t, const sprite_t *s, uint *y0, uint *y1)
+{
+    if (s->hidden || s->x >= (int)t->width || s->x + (int)s->width <= 0)
+        return false;
+    int top = s->y < 0 ? 0 : s->y;
+    int bottom = s->y + (int)s->height;
+    if (bottom > (int)t->lines)
+        bottom = t->lines;
+    if (top >= bottom)
+        return false;
+    *y0 = top;
+    *y1 = bottom;
+    return true;
+}
+
+// Bucket the sprites of f by line. Counting sort: count the sprites taken
+// on each line, turn the counts into offsets, then place the ids, taking
+// the same decisions on the second pass. Sprites are visited in priority
+// order, so the limits drop the lowest priority first.
+static void sort_lines(const sprite_layer_t *t, sprite_frame_t *f, uint count, sprite_stats_t *stats)
+{
+    uint8_t taken[SPRITE_MAX_LINES];
+    uint8_t wanted[SPRITE_MAX_LINES];
+    memset(taken, 0, t->lines);
+    memset(wanted, 0, t->lines);
+    memset(stats, 0, sizeof(*stats));
+    uint total = 0;
+    for (uint i = 0; i < count; ++i)
+    {
+        uint y0, y1;
+        if (!visible_lines(t, &f->sprites[i], &y0, &y1))
+            continue;
+        ++stats->sprites;
+        for (uint y = y0; y < y1; ++y)
+        {
+            if (wanted[y] < 255)
+                ++wanted[y];
+            if (taken[y] < SPRITE_MAX_PER_LINE && total < SPRITE_MAX_ENTRIES)
+            {
+                ++taken[y];
+                ++total;
+            }
+            else
+                ++stats->dropped;
+        }
+    }
+    uint at = 0;
+    for (uint y = 0; y < t->lines; ++y)
+    {
+        f->first[y] = at;
+        at += taken[y];
+        if (wanted[y] > stats->busiest)
+            stats->busiest = wanted[y];
+        if (wanted[y] > SPRITE_MAX_PER_LINE)
+            ++stats->lines_over;
+    }
+    f->first[t->lines] = at;
+
+    memset(taken, 0, t->lines);
+    total = 0;
+    for (uint i = 0; i < count; ++i)
+    {
+        uint y0, y1;
+        if (!visible_lines(t, &f->sprites[i], &y0, &y1))
+            continue;
+        for (uint y = y0; y < y1; ++y)
+        {
+            if (taken[y] < SPRITE_MAX_PER_LINE && total < SPRITE_MAX_ENTRIES)
+            {
+                f->ids[f->first[y] + taken[y]++] = i;
+                ++total;
+            }
+        }
+    }
+}
+
+void sprite_commit(sprite_layer_t *t, sprite_stats_t *stats)
+{
+    sprite_stats_t unused;
+    uint count = t->count < SPRITE_MAX ? t->count : SPRITE_MAX;
+    // Once the IRQ draws the layer, wait for it to take the last commit;
+    // the frame not on show is then free.
+    if (t->drawing)
+    {
+        while (t->pending)
+            tight_loop_contents();
+    }
+    sprite_frame_t *f = t->shown == &t->frames[0] ? &t->frames[1] : &t->frames[0];
+    memcpy(f->sprites, t->sprites, count * sizeof(sprite_t));
+    sort_lines(t, f, count, stats ? stats : &unused);
+    __dmb();
+    if (t->drawing)
+        t->pending = f;
+    else
+        t->shown = f;
+}
+
+static void __not_in_flash_func(draw_row)(uint8_t *out, const sprite_t *s, uint row, uint width)
+{
+    const uint8_t *src = s->pixels + row * s->stride;
+    int x = s->x;
+    uint from = x < 0 ? -x : 0;
+    uint to = x + (int)s->width > (int)width ? width - x : s->width;
+    uint8_t key = s->key;
+    uint8_t *dst = out + x;
+    for (uint i = from; i < to; ++i)
+    {
+        uint8_t p = src[i];
+        if (p != key)
+            dst[i] = p;
+    }
+}
+
+static __force_inline void latch(sprite_layer_t *t, uint y)
+{
+    if (y == 0)
+    {
+        t->drawing = true;
+        if (t->pending)
+        {
+            t->shown = t->pending;
+            t->pending = NULL;
+        }
+    }
+}
+
+void __not_in_flash_func(sprite_scanline)(uint y, void *buf, void *user)
+{
+    sprite_layer_t *t = (sprite_layer_t *)user;
+    latch(t, y);
+    if (t->background)
+        t->background(y, buf, t->background_user);
+    else
+    {
+        uint32_t fill = t->background_colour * 0x01010101u;
+        uint32_t *out = (uint32_t *)buf;
+        for (uint i = 0; i < t->width / 4; ++i)
+            out[i] = fill;
+    }
+    const sprite_frame_t *f = t->shown;
+    if (!f || y >= t->lines)
+        return;
+    // Lowest priority first, so the highest ends up on top.
+    for (uint k = f->first[y + 1]; k-- > f->first[y];)
+    {
+        const sprite_t *s = &f->sprites[f->ids[k]];
+        draw_row((uint8_t *)buf, s, y - s->y, t->width);
+    }
+}
+
+uint __not_in_flash_func(sprite_spans)(uint y, compose_span_t *spans, uint max, void *user)
+{
+    sprite_layer_t *t = (sprite_layer_t *)user;
+    latch(t, y);
+    const sprite_frame_t *f = t->shown;
+    if (!f || y >= t->lines)
+        return 0;
+    uint n = 0;
+    for (uint k = f->first[y]; k < f->first[y + 1] && n < max; ++k)
+    {
+        const sprite_t *s = &f->sprites[f->ids[k]];
+        int x0 = s->x < 0 ? 0 : s->x;
+        int x1 = s->x + (int)s->width > (int)t->width ? (int)t->width : s->x + (int)s->width;
+        const uint8_t *row = s->pixels + (y - s->y) * s->stride;
+        spans[n++] = (compose_span_t){(int16_t)x0, (int16_t)x1, COMPOSE_KEYED, s->key, row + (x0 - s->x)};
+    }
+    return n;
+}
+
+void sprite_show(sprite_layer_t *t)
+{
+    dvi_set_scanline_callback(DVI_FORMAT_RGB332, sprite_scanline, t);
+}
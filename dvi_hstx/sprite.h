@@ -0,0 +1,96 @@
+// Sprites: RGB332 images with a transparent colour drawn over a background
+// scanline callback (the tile or text mode, or a flat colour) as each line
+// is rendered, so moving objects never redraw a framebuffer.
+//
+// The application edits an array of sprites and calls sprite_commit() once
+// a frame. That copies them and sorts them, on the calling core, into a
+// list per display line of the sprites crossing it, which the IRQ takes at
+// the next frame's first line; it then only visits the sprites on each
+// line. Two of these lists alternate, so the sprites can be edited while
+// the last commit is on show, and sprite_commit() waits for the IRQ to
+// take the previous commit, which paces an animation loop to the display.
+//
+// Like sprite hardware, a line holds at most SPRITE_MAX_PER_LINE sprites,
+// which bounds the time a line takes; lower-numbered sprites have priority
+// and are drawn on top, and sprite_commit() reports what did not fit.
+
+#ifndef _SPRITE_H
+#define _SPRITE_H
+
+#include "compose.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SPRITE_MAX 64
+#define SPRITE_MAX_PER_LINE 16
+#define SPRITE_MAX_LINES 480
+// Sprite lines in one frame, the sum of the sprites' visible heights.
+#define SPRITE_MAX_ENTRIES 4096
+
+typedef struct
+{
+    const uint8_t *pixels; // RGB332, height rows of stride bytes, in RAM
+    int16_t x, y;          // top left on the screen, may be partly off it
+    uint16_t width, height, stride;
+    uint8_t key;           // pixels of this colour are transparent
+    bool hidden;
+} sprite_t;
+
+// A commit, as the IRQ reads it.
+typedef struct
+{
+    sprite_t sprites[SPRITE_MAX];
+    // Line y shows sprites ids[first[y]] to ids[first[y + 1] - 1].
+    uint16_t first[SPRITE_MAX_LINES + 1];
+    uint8_t ids[SPRITE_MAX_ENTRIES];
+} sprite_frame_t;
+
+typedef struct
+{
+    uint16_t sprites;    // sprites with any line on the screen
+    uint16_t busiest;    // most sprites on one line, before the limit
+    uint16_t lines_over; // lines with more than SPRITE_MAX_PER_LINE
+    uint16_t dropped;    // sprite lines left out by the limits
+} sprite_stats_t;
+
+typedef struct
+{
+    sprite_t sprites[SPRITE_MAX]; // the application's; sprites[0, count) are used
+    uint count;
+    // Drawn under the sprites; a flat background_colour if NULL.
+    dvi_scanline_cb_t background;
+    void *background_user;
+    uint8_t background_colour;
+    uint16_t width, lines; // from the mode
+    // Private
+    sprite_frame_t frames[2];
+    sprite_frame_t *volatile shown;
+    sprite_frame_t *volatile pending;
+    volatile bool drawing; // the IRQ has drawn a line of this layer
+} sprite_layer_t;
+
+// No sprites over background, which renders RGB332 (NULL for a flat colour).
+void sprite_init(sprite_layer_t *t, dvi_scanline_cb_t background, void *background_user);
+
+// Show sprites[0, count) as they are now from the next frame, waiting for
+// the IRQ to take the previous commit first. Fills stats if not NULL.
+void sprite_commit(sprite_layer_t *t, sprite_stats_t *stats);
+
+// Render line y of t into buf, for dvi_set_scanline_callback() in
+// DVI_FORMAT_RGB332 with t as user.
+void sprite_scanline(uint y, void *buf, void *user);
+
+// As a compositor plane (compose.h), without the background: a keyed span
+// per sprite on the line, highest priority first.
+uint sprite_spans(uint y, compose_span_t *spans, uint max, void *user);
+
+// Show t from the next vblank.
+void sprite_show(sprite_layer_t *t);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
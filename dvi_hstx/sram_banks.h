@@ -0,0 +1,44 @@
+// SRAM bank placement for scanout data.
+
+// RP2350 SRAM is ten banks. SRAM0-3 (0x20000000) and SRAM4-7 (0x20040000)
+// are word-striped, so any buffer there shares banks with the heap, .data,
+// .bss and the framebuffer, and the DMA stalls whenever core 0 touches the
+// same bank in the same cycle. SRAM8 (scratch_x) and SRAM9 (scratch_y) are
+// 4 KiB each and not striped. The SDK's default linker script already routes
+// .scratch_x.* and .scratch_y.* sections to them and copies their contents in
+// at boot, so no custom linker script is needed to use them.
+//
+// Scanout uses them as follows:
+//
+//   scratch_x: the DMA IRQ handler and its per-line post_pixels() kernels,
+//              core 1's stack (which the IRQ runs on) and the HSTX command
+//              lists. Only core 1 and the DMA touch it. The IRQ's other
+//              helpers (line preparation, vblank latches, the copper and
+//              the cursor) are __not_in_flash_func(), in striped SRAM, to
+//              leave the 4 KiB bank its stack; each build prints what the
+//              bank holds (dvi_hstx_report_banks()).
+//   scratch_y: the staging line buffer the DMA streams pixels from. Core 0's
+//              stack also lives at the top of this bank.
+//
+// Application data stays in the striped banks. Define the macros below
+// before including this header to override the placement.
+
+#ifndef _SRAM_BANKS_H
+#define _SRAM_BANKS_H
+
+#include "pico/stdlib.h"
+
+// Data read by the DMA during blanking, next to the IRQ and its stack.
+#ifndef __scanout_cmdlist
+#define __scanout_cmdlist(group) __scratch_x(group)
+#endif
+
+// Staging buffers the DMA streams active pixels from.
+#ifndef __scanout_linebuf
+#define __scanout_linebuf(group) __scratch_y(group)
+#endif
+
+#define SRAM_STRIPED_LO_BASE SRAM_BASE
+#define SRAM_STRIPED_HI_BASE SRAM4_BASE
+
+#endif
@@ -0,0 +1,116 @@
+// Text mode, see text.h.
+
+#include "text.h"
+#include "dvi_hstx.h"
+#include <string.h>
+
+static const uint8_t default_colours[16] = {
+    0x00, 0x02, 0x14, 0x16, 0xa0, 0xa2, 0xa8, 0xb6, // black to light grey
+    0x49, 0x4b, 0x5d, 0x5f, 0xe9, 0xeb, 0xfd, 0xff, // dark grey to white
+};
+
+// Byte i of nibble_mask[n] is 0xff where bit 3 - i of n is set: four glyph
+// pixels, the leftmost first in memory as the scanout reads them.
+static const uint32_t __not_in_flash("text") nibble_mask[16] = {
+    0x00000000, 0xff000000, 0x00ff0000, 0xffff0000, 0x0000ff00, 0xff00ff00, 0x00ffff00, 0xffffff00,
+    0x000000ff, 0xff0000ff, 0x00ff00ff, 0xffff00ff, 0x0000ffff, 0xff00ffff, 0x00ffffff, 0xffffffff,
+};
+
+void text_init(text_screen_t *t)
+{
+    for (uint r = 0; r < TEXT_ROWS; ++r)
+        t->rows[r] = t->cells[r];
+    t->font = text_font_8x16;
+    memcpy(t->colours, default_colours, sizeof(default_colours));
+    for (uint i = 0; i < 16; ++i)
+        text_set_colour(t, i, default_colours[i]);
+    text_clear(t, TEXT_ATTR(TEXT_LIGHT_GREY, TEXT_BLACK));
+}
+
+void text_set_colour(text_screen_t *t, uint index, uint8_t rgb332)
+{
+    t->colours[index & 15] = rgb332;
+    // Attributes using the colour as either foreground or background.
+    for (uint i = 0; i < 16; ++i)
+    {
+        uint8_t attrs[2] = {TEXT_ATTR(index & 15, i), TEXT_ATTR(i, index & 15)};
+        for (uint k = 0; k < 2; ++k)
+        {
+            uint a = attrs[k];
+            uint32_t bg = t->colours[a >> 4] * 0x01010101u;
+            t->attrs[a][0] = bg;
+            t->attrs[a][1] = bg ^ t->colours[a & 15] * 0x01010101u;
+        }
+    }
+}
+
+void text_clear(text_screen_t *t, uint8_t attr)
+{
+    for (uint r = 0; r < TEXT_ROWS; ++r)
+        text_clear_row(t, r, 0, TEXT_COLS, attr);
+}
+
+void text_clear_row(text_screen_t *t, uint row, uint from, uint to, uint8_t attr)
+{
+    uint16_t *cell = t->rows[row];
+    for (uint x = from; x < to; ++x)
+        cell[x] = TEXT_CELL(' ', attr);
+}
+
+void text_scroll(text_screen_t *t, uint top, uint bottom, int n, uint8_t attr)
+{
+    uint count = bottom - top + 1;
+    uint k = (uint)(n < 0 ? -n : n);
+    if (k > count)
+        k = count;
+    // Rotate by k, then clear the k rows that wrapped around.
+    uint16_t *moved[TEXT_ROWS];
+    uint16_t **rows = t->rows + top;
+    if (n > 0)
+    {
+        memcpy(moved, rows, k * sizeof(*rows));
+        memmove(rows, rows + k, (count - k) * sizeof(*rows));
+        memcpy(rows + count - k, moved, k * sizeof(*rows));
+        for (uint r = bottom + 1 - k; r <= bottom; ++r)
+            text_clear_row(t, r, 0, TEXT_COLS, attr);
+    }
+    else if (n < 0)
+    {
+        memcpy(moved, rows + count - k, k * sizeof(*rows));
+        memmove(rows + k, rows, (count - k) * sizeof(*rows));
+        memcpy(rows, moved, k * sizeof(*rows));
+        for (uint r = top; r < top + k; ++r)
+            text_clear_row(t, r, 0, TEXT_COLS, attr);
+    }
+}
+
+uint text_print(text_screen_t *t, uint col, uint row, const char *s, uint8_t attr)
+{
+    if (row >= TEXT_ROWS)
+        return col;
+    for (; *s && col < TEXT_COLS; ++s, ++col)
+        t->rows[row][col] = TEXT_CELL(*s, attr);
+    return col;
+}
+
+void __not_in_flash_func(text_scanline)(uint y, void *buf, void *user)
+{
+    const text_screen_t *t = (const text_screen_t *)user;
+    const uint16_t *cell = t->rows[y / TEXT_FONT_HEIGHT % TEXT_ROWS];
+    const uint8_t *font = t->font + y % TEXT_FONT_HEIGHT;
+    uint32_t *out = (uint32_t *)buf;
+    for (uint x = 0; x < TEXT_COLS; ++x, out += 2)
+    {
+        uint c = cell[x];
+        uint g = font[(c & 0xff) * TEXT_FONT_HEIGHT];
+        const uint32_t *attr = t->attrs[c >> 8];
+        out[0] = attr[0] ^ (nibble_mask[g >> 4] & attr[1]);
+        out[1] = attr[0] ^ (nibble_mask[g & 15] & attr[1]);
+    }
+}
+
+void text_show(text_screen_t *t)
+{
+    hard_assert(dvi_get_mode()->h_active_pixels == TEXT_COLS * 8);
+    dvi_set_scanline_callback(DVI_FORMAT_RGB332, text_scanline, t);
+}
@@ -0,0 +1,101 @@
+// Text mode: 80x30 character cells of 8x16 pixels, rendered a scanline at a
+// time on a 640x480 display instead of being read from a framebuffer.
+//
+// A cell is a character and an attribute byte choosing its foreground and
+// background from 16 colours. The scanline callback takes each cell's glyph
+// row from the font, looks the attribute up in a table holding the
+// background and its difference from the foreground as words of four
+// pixels, and widens the glyph row four pixels at a time through a
+// 16-entry table of byte masks selecting between them. The cells (4.8 KB),
+// the font (4 KB) and the attribute table (2 KB) are all the mode needs,
+// against 300 KB for a 640x480 RGB332 framebuffer.
+//
+// Rows are reached through a table of pointers into the cells, so
+// scrolling rotates the table and clears one row instead of moving the
+// screen. The IRQ reads the table a line at a time; a scroll during a row's
+// scanout can show that row torn for one frame.
+
+#ifndef _TEXT_H
+#define _TEXT_H
+
+#include "pico/stdlib.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TEXT_COLS 80
+#define TEXT_ROWS 30
+#define TEXT_FONT_HEIGHT 16
+
+// Foreground colour index in the low nibble, background in the high one.
+#define TEXT_ATTR(fg, bg) ((uint8_t)((fg) | (bg) << 4))
+#define TEXT_CELL(ch, attr) ((uint16_t)((uint8_t)(ch) | (uint16_t)(attr) << 8))
+
+// The colours of the PC text modes, the default table.
+enum
+{
+    TEXT_BLACK,
+    TEXT_BLUE,
+    TEXT_GREEN,
+    TEXT_CYAN,
+    TEXT_RED,
+    TEXT_MAGENTA,
+    TEXT_BROWN,
+    TEXT_LIGHT_GREY,
+    TEXT_DARK_GREY,
+    TEXT_LIGHT_BLUE,
+    TEXT_LIGHT_GREEN,
+    TEXT_LIGHT_CYAN,
+    TEXT_LIGHT_RED,
+    TEXT_LIGHT_MAGENTA,
+    TEXT_YELLOW,
+    TEXT_WHITE,
+};
+
+typedef struct
+{
+    uint16_t *rows[TEXT_ROWS];            // screen row r is rows[r][0..TEXT_COLS)
+    uint16_t cells[TEXT_ROWS][TEXT_COLS]; // TEXT_CELL(character, attribute), in any row order
+    const uint8_t *font;                  // 256 glyphs of 16 rows, bit 7 leftmost, in RAM
+    uint8_t colours[16];                  // RGB332
+    // Per attribute, the background and background ^ foreground, repeated
+    // in each byte. Kept by text_set_colour().
+    uint32_t attrs[256][2];
+} text_screen_t;
+
+// CP437-style 8x16 font written by tools/mkfont.py: ASCII, shades, blocks
+// and box drawing.
+extern const uint8_t text_font_8x16[256 * TEXT_FONT_HEIGHT];
+
+// Default font and colours, all cells light grey spaces on black.
+void text_init(text_screen_t *t);
+
+void text_set_colour(text_screen_t *t, uint index, uint8_t rgb332);
+
+void text_clear(text_screen_t *t, uint8_t attr);
+
+// Fill columns [from, to) of a row with spaces in attr.
+void text_clear_row(text_screen_t *t, uint row, uint from, uint to, uint8_t attr);
+
+// Move rows [top, bottom] up by n rows (down for negative n), clearing the
+// rows that come in to attr. Rotates row pointers; cells do not move.
+void text_scroll(text_screen_t *t, uint top, uint bottom, int n, uint8_t attr);
+
+// Write s from (col, row), cut off at the end of the row. Returns the column
+// after the last character written.
+uint text_print(text_screen_t *t, uint col, uint row, const char *s, uint8_t attr);
+
+// Render line y of t into buf, for dvi_set_scanline_callback() in
+// DVI_FORMAT_RGB332 with t as user.
+void text_scanline(uint y, void *buf, void *user);
+
+// Show t from the next vblank. The mode must be 640 pixels wide; lines
+// past the last row repeat the screen from the top.
+void text_show(text_screen_t *t);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,163 @@
+// Tile mode, see tile.h.
+
+#include "tile.h"
+#include "dvi_hstx.h"
+#include <string.h>
+
+void tile_init(tile_layer_t *t, const uint8_t *tiles, uint tile_size, uint bpp, const uint8_t *palette,
+               const uint16_t *map, uint map_cols, uint map_rows)
+{
+    hard_assert(tile_size == 8 || tile_size == 16);
+    hard_assert(bpp == 8 || (bpp == 4 && palette));
+    hard_assert(map_cols && !(map_cols & (map_cols - 1)) && map_rows && !(map_rows & (map_rows - 1)));
+    memset(t, 0, sizeof(*t));
+    t->tiles = tiles;
+    t->tile_size = tile_size;
+    t->bpp = bpp;
+    t->palette = palette;
+    t->map = map;
+    t->map_cols = map_cols;
+    t->map_rows = map_rows;
+    t->width = dvi_get_mode()->h_active_pixels;
+}
+
+// Row ty of a tile as RGB332 pixels into dst, which need not be aligned.
+// ts and bpp are constants where inlined, leaving straight-line code; the
+// fixed-size memcpy()s compile to loads and stores, not library calls. The
+// byte loops in render() would become memcpy() calls too, but tile.c is
+// built with -fno-tree-loop-distribute-patterns (see CMakeLists.txt).
+static __force_inline void tile_row(const tile_layer_t *t, uint8_t *dst, uint entry, uint ty, uint ts, uint bpp)
+{
+    if (entry & TILE_VFLIP)
+        ty = ts - 1 - ty;
+    uint tile = entry & TILE_INDEX_MASK;
+    if (bpp == 8)
+    {
+        const uint8_t *src = t->tiles + (tile * ts + ty) * ts;
+        if (!(entry & TILE_HFLIP))
+        {
+            memcpy(dst, src, ts);
+        }
+        else
+        {
+            for (uint i = 0; i < ts; i += 4)
+            {
+                uint32_t w;
+                memcpy(&w, src + ts - 4 - i, 4);
+                w = __builtin_bswap32(w);
+                memcpy(dst + i, &w, 4);
+            }
+        }
+    }
+    else
+    {
+        const uint8_t *src = t->tiles + (tile * ts + ty) * ts / 2;
+        const uint8_t *pal = t->palette + (entry >> TILE_PALETTE_SHIFT) * 16;
+        if (!(entry & TILE_HFLIP))
+        {
+            for (uint i = 0; i < ts / 2; ++i)
+            {
+                uint b = src[i];
+                dst[2 * i] = pal[b & 15];
+                dst[2 * i + 1] = pal[b >> 4];
+            }
+        }
+        else
+        {
+            for (uint i = 0; i < ts / 2; ++i)
+            {
+                uint b = src[ts / 2 - 1 - i];
+                dst[2 * i] = pal[b >> 4];
+                dst[2 * i + 1] = pal[b & 15];
+            }
+        }
+    }
+}
+
+// Pixels [x0, x1) of line y into out + x0.
+static __force_inline void render(const tile_layer_t *t, uint y, uint8_t *out, uint x0, uint x1, uint ts, uint bpp)
+{
+    const uint shift = ts == 8 ? 3 : 4;
+    // Wrapping to the map is a mask, as its size is a power of two.
+    uint sx = (uint)(t->frame_x + (t->line_x ? t->line_x[y] : 0) + (int)x0) & (((uint)t->map_cols << shift) - 1);
+    uint sy = (uint)(t->frame_y + (int)y + (t->line_y ? t->line_y[y] : 0)) & (((uint)t->map_rows << shift) - 1);
+    const uint16_t *row = t->map + (sy >> shift) * t->map_cols;
+    const uint col_mask = t->map_cols - 1;
+    const uint ty = sy & (ts - 1);
+    const uint width = x1 - x0;
+    uint col = sx >> shift;
+    uint fine = sx & (ts - 1);
+    uint8_t part[16];
+    uint x = 0;
+    out += x0;
+    // A partial tile either side when the scroll is not a whole tile.
+    if (fine)
+    {
+        tile_row(t, part, row[col], ty, ts, bpp);
+        x = ts - fine < width ? ts - fine : width;
+        for (uint i = 0; i < x; ++i)
+            out[i] = part[fine + i];
+        col = (col + 1) & col_mask;
+    }
+    for (; x + ts <= width; x += ts, col = (col + 1) & col_mask)
+        tile_row(t, out + x, row[col], ty, ts, bpp);
+    if (x < width)
+    {
+        tile_row(t, part, row[col], ty, ts, bpp);
+        for (uint i = 0; x + i < width; ++i)
+            out[x + i] = part[i];
+    }
+}
+
+static void __not_in_flash_func(render_range)(const tile_layer_t *t, uint y, uint8_t *out, uint x0, uint x1)
+{
+    if (t->tile_size == 8)
+    {
+        if (t->bpp == 8)
+            render(t, y, out, x0, x1, 8, 8);
+        else
+            render(t, y, out, x0, x1, 8, 4);
+    }
+    else
+    {
+        if (t->bpp == 8)
+            render(t, y, out, x0, x1, 16, 8);
+        else
+            render(t, y, out, x0, x1, 16, 4);
+    }
+}
+
+static __force_inline void latch(tile_layer_t *t, uint y)
+{
+    if (y == 0)
+    {
+        t->frame_x = t->scroll_x;
+        t->frame_y = t->scroll_y;
+    }
+}
+
+void __not_in_flash_func(tile_scanline)(uint y, void *buf, void *user)
+{
+    tile_layer_t *t = (tile_layer_t *)user;
+    latch(t, y);
+    render_range(t, y, (uint8_t *)buf, 0, t->width);
+}
+
+uint __not_in_flash_func(tile_spans)(uint y, compose_span_t *spans, uint max, void *user)
+{
+    tile_layer_t *t = (tile_layer_t *)user;
+    (void)max;
+    latch(t, y);
+    spans[0] = (compose_span_t){0, (int16_t)t->width, COMPOSE_RENDER, 0, NULL};
+    return 1;
+}
+
+void __not_in_flash_func(tile_render)(uint y, uint8_t *line, uint x0, uint x1, void *user)
+{
+    render_range((const tile_layer_t *)user, y, line, x0, x1);
+}
+
+void tile_show(tile_layer_t *t)
+{
+    dvi_set_scanline_callback(DVI_FORMAT_RGB332, tile_scanline, t);
+}
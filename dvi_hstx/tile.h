@@ -0,0 +1,77 @@
+// Tile mode: a background drawn from a map of 8x8 or 16x16 pixel tiles,
+// rendered a scanline at a time like the text mode (text.h) instead of being
+// read from a framebuffer.
+//
+// Map entries are 16 bits, laid out as on the Game Boy Advance: a tile
+// number, horizontal and vertical flip, and for 4 bpp tiles one of 16
+// palettes of 16 RGB332 colours. 8 bpp tiles hold RGB332 pixels directly.
+// The map wraps in both directions, so its size in tiles must be a power of
+// two. A 128x64 map of 8x8 tiles and 256 tiles at 4 bpp is 16 KB of map
+// and 8 KB of tiles; 256 tiles of 16x16 at 8 bpp are 64 KB.
+//
+// Scrolling is a pair of registers read once per frame plus optional
+// per-line offsets, so moving the whole screen costs nothing and line
+// effects (parallax bands, wobble, perspective floors) are a table. The
+// scanline callback reads the map, tiles and palettes, which should all be
+// in RAM.
+
+#ifndef _TILE_H
+#define _TILE_H
+
+#include "compose.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TILE_INDEX_MASK 0x3ffu
+#define TILE_HFLIP (1u << 10)
+#define TILE_VFLIP (1u << 11)
+#define TILE_PALETTE_SHIFT 12
+
+// A map entry: tile number, TILE_HFLIP | TILE_VFLIP, 4 bpp palette.
+#define TILE_ENTRY(tile, flags, palette) ((uint16_t)((tile) | (flags) | (palette) << TILE_PALETTE_SHIFT))
+
+typedef struct
+{
+    // Tile n is tile_size rows of tile_size pixels at tiles + n * tile_size
+    // * tile_size * bpp / 8. At 4 bpp the low nibble is the left pixel.
+    const uint8_t *tiles;
+    const uint16_t *map;    // map_cols * map_rows entries, row by row
+    const uint8_t *palette; // 4 bpp: 16 palettes of 16 RGB332 colours
+    uint8_t tile_size;      // 8 or 16
+    uint8_t bpp;            // 4 or 8
+    uint16_t map_cols, map_rows;
+    uint16_t width;         // pixels per line, from the mode
+    // Top left of the screen in the map, in pixels. Read at the first line
+    // of each frame, so a frame never shows two scroll positions.
+    int scroll_x, scroll_y;
+    // If set, v_active_lines offsets added to the scroll for each line,
+    // read as the line is drawn.
+    const int16_t *line_x, *line_y;
+    // The scroll of the frame being drawn.
+    int frame_x, frame_y;
+} tile_layer_t;
+
+// Set up t with no scroll or line offsets. The map size must be a power of
+// two in each direction.
+void tile_init(tile_layer_t *t, const uint8_t *tiles, uint tile_size, uint bpp, const uint8_t *palette,
+               const uint16_t *map, uint map_cols, uint map_rows);
+
+// Render line y of t into buf, for dvi_set_scanline_callback() in
+// DVI_FORMAT_RGB332 with t as user.
+void tile_scanline(uint y, void *buf, void *user);
+
+// As a compositor plane (compose.h): the whole line, rendered on request
+// for the parts left visible.
+uint tile_spans(uint y, compose_span_t *spans, uint max, void *user);
+void tile_render(uint y, uint8_t *line, uint x0, uint x1, void *user);
+
+// Show t from the next vblank.
+void tile_show(tile_layer_t *t);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
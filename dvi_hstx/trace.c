@@ -0,0 +1,65 @@
+// Scanout event trace recorder, see trace.h.
+
+#include "trace.h"
+#include "hardware/clocks.h"
+#include "stdio.h"
+
+static_assert((TRACE_RING_SIZE & (TRACE_RING_SIZE - 1)) == 0, "TRACE_RING_SIZE must be a power of two");
+
+trace_ring_t trace_rings[2];
+volatile bool trace_paused = false;
+
+void trace_init(void)
+{
+    // Count clk_sys cycles rather than timer ticks; 32 bits wrap after ~28 s
+    // at 150 MHz, which the host tool unwraps.
+    sio_hw->mtime_ctrl = 0;
+    sio_hw->mtimeh = 0;
+    sio_hw->mtime = 0;
+    sio_hw->mtime_ctrl = SIO_MTIME_CTRL_EN_BITS | SIO_MTIME_CTRL_FULLSPEED_BITS;
+}
+
+// Dump format, one event per line, oldest first within each core:
+//
+//   # trace v1 clk_hz=<hz> ring=<events per core> now=<64-bit timer, hex>
+//   E <core> <timestamp, hex> <event id> <arg>
+//   # end dropped=<core 0 overwritten events>,<core 1 overwritten events>
+void trace_dump(void)
+{
+    uint32_t dropped[2];
+    uint32_t now_hi, now_lo;
+
+    trace_paused = true;
+    __dmb();
+    // Take each ring's count and restart it in one atomic step, against a
+    // core's fetch_add. An event already past the pause check when it was
+    // set then counts in one ring or the other, and at worst shows in this
+    // dump in place of the oldest event, instead of resetting the count
+    // under it.
+    uint32_t heads[2];
+    for (uint core = 0; core < 2; ++core)
+        heads[core] = __atomic_exchange_n(&trace_rings[core].head, 0, __ATOMIC_RELAXED);
+    // The host unwraps each core's 32-bit timestamps backwards from here.
+    do
+    {
+        now_hi = sio_hw->mtimeh;
+        now_lo = sio_hw->mtime;
+    } while (now_hi != sio_hw->mtimeh);
+    printf("# trace v1 clk_hz=%lu ring=%u now=%08lx%08lx\n", (unsigned long)clock_get_hz(clk_sys),
+           TRACE_RING_SIZE, (unsigned long)now_hi, (unsigned long)now_lo);
+    for (uint core = 0; core < 2; ++core)
+    {
+        const trace_ring_t *ring = &trace_rings[core];
+        uint32_t head = heads[core];
+        uint32_t count = head < TRACE_RING_SIZE ? head : TRACE_RING_SIZE;
+        dropped[core] = head - count;
+        for (uint32_t i = head - count; i != head; ++i)
+        {
+            const trace_event_t *ev = &ring->events[i & (TRACE_RING_SIZE - 1)];
+            printf("E %u %08lx %u %u\n", core, (unsigned long)ev->timestamp, ev->id, ev->arg);
+        }
+    }
+    printf("# end dropped=%lu,%lu\n", (unsigned long)dropped[0], (unsigned long)dropped[1]);
+
+    trace_paused = false;
+}
@@ -0,0 +1,93 @@
+// Scanout event trace recorder.
+
+// Events are recorded into one fixed-size ring per core, so each ring has a
+// single writer and recording never takes a lock. Slots are claimed with an
+// atomic increment, which keeps a core's IRQ handlers and thread code from
+// clobbering each other's entries. Timestamps come from the SIO platform
+// timer running at clk_sys, which both cores read, so events from core 0
+// and core 1 can be merged onto one timeline.
+//
+// Recording is compiled out unless DVI_TRACE is defined to 1. Use
+// trace_dump() to print both rings over stdio and tools/trace2json.py to
+// convert the dump into Chrome trace JSON (chrome://tracing or Perfetto).
+
+#ifndef _TRACE_H
+#define _TRACE_H
+
+#include "pico/stdlib.h"
+#include "hardware/structs/sio.h"
+
+#ifndef DVI_TRACE
+#define DVI_TRACE 0
+#endif
+
+// Events per core, must be a power of two. Each event is 8 bytes.
+#ifndef TRACE_RING_SIZE
+#define TRACE_RING_SIZE 1024
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum
+{
+    TRACE_EV_IRQ_ENTER = 0, // arg: scanline
+    TRACE_EV_IRQ_EXIT,      // arg: scanline
+    TRACE_EV_VBLANK,        // arg: frame count (low 16 bits)
+    TRACE_EV_BUFFER_SWAP,   // arg: buffer index
+    TRACE_EV_TASK_BEGIN,    // arg: task id
+    TRACE_EV_TASK_END,      // arg: task id
+    TRACE_EV_MARK,          // arg: user defined
+    TRACE_EV_COUNT
+} trace_event_id_t;
+
+// Task ids used with TRACE_EV_TASK_BEGIN/END.
+enum
+{
+    TRACE_TASK_MAIN_LOOP = 0,
+    TRACE_TASK_RENDER,
+    TRACE_TASK_USER = 16
+};
+
+typedef struct
+{
+    uint32_t timestamp;
+    uint16_t id;
+    uint16_t arg;
+} trace_event_t;
+
+typedef struct
+{
+    uint32_t head; // total events ever written; slot is head % TRACE_RING_SIZE
+    trace_event_t events[TRACE_RING_SIZE];
+} trace_ring_t;
+
+extern trace_ring_t trace_rings[2];
+extern volatile bool trace_paused;
+
+void trace_init(void);
+void trace_dump(void);
+
+static __force_inline void trace_event(trace_event_id_t id, uint16_t arg)
+{
+#if DVI_TRACE
+    if (trace_paused)
+        return;
+    trace_ring_t *ring = &trace_rings[sio_hw->cpuid];
+    uint32_t slot = __atomic_fetch_add(&ring->head, 1, __ATOMIC_RELAXED) & (TRACE_RING_SIZE - 1);
+    trace_event_t *ev = &ring->events[slot];
+    ev->timestamp = sio_hw->mtime;
+    ev->id = (uint16_t)id;
+    ev->arg = arg;
+#else
+    (void)id;
+    (void)arg;
+#endif
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
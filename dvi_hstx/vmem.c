@@ -0,0 +1,120 @@
+// Video memory arenas, see vmem.h.
+
+#include "vmem.h"
+#include <stdio.h>
+
+void vmem_arena_init(vmem_arena_t *arena, const char *name, void *base, size_t size)
+{
+    arena->name = name;
+    arena->base = (uint8_t *)base;
+    arena->size = size;
+    arena->used = 0;
+    arena->high_water = 0;
+    arena->allocs = 0;
+    arena->failed = 0;
+}
+
+void *vmem_alloc(vmem_arena_t *arena, size_t size, size_t align)
+{
+    uintptr_t start = (uintptr_t)arena->base + arena->used;
+    uintptr_t aligned = (start + align - 1) & ~(uintptr_t)(align - 1);
+    size_t used = (aligned - (uintptr_t)arena->base) + size;
+
+    if (align == 0 || (align & (align - 1)) || used > arena->size || used < arena->used)
+    {
+        arena->failed++;
+        return NULL;
+    }
+    arena->used = used;
+    if (used > arena->high_water)
+        arena->high_water = used;
+    arena->allocs++;
+    return (void *)aligned;
+}
+
+void vmem_reset(vmem_arena_t *arena)
+{
+    arena->used = 0;
+    arena->allocs = 0;
+}
+
+size_t vmem_mark(const vmem_arena_t *arena)
+{
+    return arena->used;
+}
+
+void vmem_release(vmem_arena_t *arena, size_t mark)
+{
+    if (mark <= arena->used)
+        arena->used = mark;
+}
+
+size_t vmem_free_bytes(const vmem_arena_t *arena)
+{
+    return arena->size - arena->used;
+}
+
+bool vmem_contains(const vmem_arena_t *arena, const void *p)
+{
+    uintptr_t a = (uintptr_t)p;
+    return a >= (uintptr_t)arena->base && a < (uintptr_t)arena->base + arena->size;
+}
+
+void vmem_report(const vmem_arena_t *const *arenas, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        const vmem_arena_t *a = arenas[i];
+        printf("vmem %-8s %p: %6lu / %6lu bytes used, high water %6lu, %lu allocs, %lu failed\n",
+               a->name, (void *)a->base, (unsigned long)a->used, (unsigned long)a->size,
+               (unsigned long)a->high_water, (unsigned long)a->allocs, (unsigned long)a->failed);
+    }
+}
+
+bool vmem_pool_init(vmem_pool_t *pool, vmem_arena_t *arena, size_t slot_size, uint32_t count, size_t align)
+{
+    if (slot_size < sizeof(void *))
+        slot_size = sizeof(void *);
+    if (align < sizeof(void *))
+        align = sizeof(void *);
+    slot_size = (slot_size + align - 1) & ~(align - 1);
+    // Too large a slot or count would wrap the block's size.
+    if (slot_size < sizeof(void *) || count > SIZE_MAX / slot_size)
+    {
+        arena->failed++;
+        return false;
+    }
+
+    uint8_t *slots = (uint8_t *)vmem_alloc(arena, slot_size * count, align);
+    if (!slots)
+        return false;
+
+    pool->free_list = NULL;
+    pool->slot_size = slot_size;
+    pool->count = count;
+    pool->in_use = 0;
+    for (uint32_t i = count; i-- > 0;)
+    {
+        void **slot = (void **)(slots + i * slot_size);
+        *slot = pool->free_list;
+        pool->free_list = slot;
+    }
+    return true;
+}
+
+void *vmem_pool_get(vmem_pool_t *pool)
+{
+    void **slot = (void **)pool->free_list;
+    if (!slot)
+        return NULL;
+    pool->free_list = *slot;
+    pool->in_use++;
+    return slot;
+}
+
+void vmem_pool_put(vmem_pool_t *pool, void *slot)
+{
+    *(void **)slot = pool->free_list;
+    pool->free_list = slot;
+    pool->in_use--;
+}
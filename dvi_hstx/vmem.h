@@ -0,0 +1,75 @@
+// Video memory arenas.
+
+// Framebuffers, staging line buffers, ring slots and palette tables are
+// carved out of reserved regions by a bump allocator instead of being
+// separate static arrays, so a mode or format change can throw everything
+// away with vmem_reset() in O(1) and allocate the new layout. Use one arena
+// per SRAM region (see sram_banks.h) to control which bank a buffer lands
+// in, and a vmem_pool_t for fixed-size slots that are recycled
+// individually.
+//
+// This file and vmem.c only depend on the C library, so they can be built
+// and tested on the host: tools/test_vmem.py runs vmem_test.c.
+
+#ifndef _VMEM_H
+#define _VMEM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct
+{
+    const char *name;
+    uint8_t *base;
+    size_t size;
+    size_t used;       // bytes handed out, including alignment padding
+    size_t high_water; // largest 'used' since init
+    uint32_t allocs;   // allocations since the last reset
+    uint32_t failed;   // allocations refused since init
+} vmem_arena_t;
+
+// Fixed-size slots carved from an arena, with an intrusive free list.
+typedef struct
+{
+    void *free_list;
+    size_t slot_size;
+    uint32_t count;
+    uint32_t in_use;
+} vmem_pool_t;
+
+void vmem_arena_init(vmem_arena_t *arena, const char *name, void *base, size_t size);
+
+// Returns NULL if the arena cannot fit size bytes at the requested
+// alignment, which must be a power of two. Memory is not cleared.
+void *vmem_alloc(vmem_arena_t *arena, size_t size, size_t align);
+
+// Release everything allocated from the arena.
+void vmem_reset(vmem_arena_t *arena);
+
+// Nested scopes: everything allocated after vmem_mark() is released by
+// vmem_release() with its result.
+size_t vmem_mark(const vmem_arena_t *arena);
+void vmem_release(vmem_arena_t *arena, size_t mark);
+
+size_t vmem_free_bytes(const vmem_arena_t *arena);
+bool vmem_contains(const vmem_arena_t *arena, const void *p);
+
+// Print one usage line per arena.
+void vmem_report(const vmem_arena_t *const *arenas, size_t count);
+
+// Allocate count slots of slot_size bytes (rounded up to a pointer) from the
+// arena. Returns false if the arena is too small or the size overflows.
+bool vmem_pool_init(vmem_pool_t *pool, vmem_arena_t *arena, size_t slot_size, uint32_t count, size_t align);
+void *vmem_pool_get(vmem_pool_t *pool);
+void vmem_pool_put(vmem_pool_t *pool, void *slot);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
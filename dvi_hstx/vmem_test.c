@@ -0,0 +1,139 @@
+// Host test for vmem.c, built and run by tools/test_vmem.py. Not part of
+// the library. Prints one line per failed check, a usage report for the
+// script to check, and exits non-zero on any failure.
+
+#include "vmem.h"
+#include <stdio.h>
+#include <string.h>
+
+static int failures;
+
+#define CHECK(cond)                                                                                                    \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (!(cond))                                                                                                   \
+        {                                                                                                              \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);                                                     \
+            ++failures;                                                                                                \
+        }                                                                                                              \
+    } while (0)
+
+static _Alignas(64) uint8_t ram[4096];
+
+static void test_alignment(void)
+{
+    vmem_arena_t a;
+    vmem_arena_init(&a, "align", ram + 1, sizeof(ram) - 1); // an odd base
+    for (size_t align = 1; align <= 64; align *= 2)
+    {
+        uint8_t *p = vmem_alloc(&a, 3, align);
+        CHECK(p && (uintptr_t)p % align == 0);
+        CHECK(vmem_contains(&a, p) && vmem_contains(&a, p + 2));
+    }
+    CHECK(vmem_alloc(&a, 4, 0) == NULL);
+    CHECK(vmem_alloc(&a, 4, 3) == NULL);
+    CHECK(a.failed == 2 && a.allocs == 7);
+}
+
+static void test_exhaustion(void)
+{
+    vmem_arena_t a;
+    vmem_arena_init(&a, "full", ram, 100);
+    CHECK(vmem_alloc(&a, 60, 4) == ram);
+    CHECK(vmem_alloc(&a, 41, 4) == NULL); // one byte too many
+    CHECK(vmem_alloc(&a, 40, 4) == ram + 60);
+    CHECK(vmem_free_bytes(&a) == 0);
+    CHECK(vmem_alloc(&a, 1, 1) == NULL);
+    CHECK(vmem_alloc(&a, SIZE_MAX, 1) == NULL); // wraps, must not succeed
+    CHECK(a.failed == 3 && a.used == 100);
+    CHECK(!vmem_contains(&a, ram + 100));
+}
+
+static void test_reset(void)
+{
+    vmem_arena_t a;
+    vmem_arena_init(&a, "reset", ram, sizeof(ram));
+    memset(ram, 0x5a, sizeof(ram));
+    for (int i = 0; i < 100; ++i)
+        CHECK(vmem_alloc(&a, 16, 8) != NULL);
+    // O(1): only the counters change, whatever was allocated.
+    vmem_reset(&a);
+    CHECK(a.used == 0 && a.allocs == 0 && a.high_water == 1600);
+    for (size_t i = 0; i < sizeof(ram); ++i)
+        CHECK(ram[i] == 0x5a);
+    CHECK(vmem_alloc(&a, 16, 8) == ram);
+}
+
+static void test_mark_release(void)
+{
+    vmem_arena_t a;
+    vmem_arena_init(&a, "mark", ram, sizeof(ram));
+    uint8_t *keep = vmem_alloc(&a, 10, 1);
+    size_t outer = vmem_mark(&a);
+    uint8_t *p = vmem_alloc(&a, 100, 4);
+    size_t inner = vmem_mark(&a);
+    vmem_alloc(&a, 200, 4);
+    vmem_release(&a, inner);
+    CHECK(a.used == inner);
+    vmem_release(&a, outer);
+    CHECK(a.used == outer && vmem_alloc(&a, 100, 4) == p);
+    // A mark from after the current position is stale and ignored.
+    vmem_release(&a, a.used + 50);
+    CHECK(a.used == outer + 2 + 100);
+    CHECK(keep == ram);
+}
+
+static void test_pool(void)
+{
+    vmem_arena_t a;
+    vmem_pool_t pool;
+    void *slots[8];
+    vmem_arena_init(&a, "pool", ram, sizeof(ram));
+    CHECK(vmem_pool_init(&pool, &a, 1, 8, 16));
+    CHECK(pool.slot_size == 16 && pool.count == 8);
+    for (int i = 0; i < 8; ++i)
+    {
+        slots[i] = vmem_pool_get(&pool);
+        CHECK(slots[i] && (uintptr_t)slots[i] % 16 == 0 && vmem_contains(&a, slots[i]));
+        for (int j = 0; j < i; ++j)
+            CHECK(slots[i] != slots[j]);
+    }
+    CHECK(pool.in_use == 8 && vmem_pool_get(&pool) == NULL);
+    vmem_pool_put(&pool, slots[3]);
+    vmem_pool_put(&pool, slots[5]);
+    CHECK(pool.in_use == 6);
+    CHECK(vmem_pool_get(&pool) == slots[5] && vmem_pool_get(&pool) == slots[3]);
+
+    vmem_arena_t small;
+    vmem_arena_init(&small, "small", ram, 64);
+    CHECK(!vmem_pool_init(&pool, &small, 32, 4, 4));
+    CHECK(small.failed == 1 && small.used == 0);
+
+    // Slot size times count, or the rounded slot size, wraps to 0.
+    CHECK(!vmem_pool_init(&pool, &small, SIZE_MAX / (1u << 31) + 1, 1u << 31, 4));
+    CHECK(!vmem_pool_init(&pool, &small, SIZE_MAX - 2, 1, 8));
+    CHECK(small.failed == 3 && small.used == 0);
+}
+
+int main(void)
+{
+    test_alignment();
+    test_exhaustion();
+    test_reset();
+    test_mark_release();
+    test_pool();
+
+    // For the script: 200 of 1000 bytes, high water 300, 2 allocs, 1 failed.
+    vmem_arena_t a;
+    vmem_arena_init(&a, "report", ram, 1000);
+    vmem_alloc(&a, 300, 4);
+    vmem_reset(&a);
+    vmem_alloc(&a, 100, 4);
+    vmem_alloc(&a, 100, 4);
+    vmem_alloc(&a, 2000, 4);
+    const vmem_arena_t *arenas[] = {&a};
+    vmem_report(arenas, 1);
+
+    printf("%s: %d failed\n", failures ? "FAIL" : "ok", failures);
+    return failures != 0;
+}
@@ -4,360 +4,672 @@
 
 // This example requires an external digital video connector connected to
 // GPIOs 12 through 19 (the HSTX-capable GPIOs) with appropriate
-// current-limiting resistors, e.g. 270 ohms. The pinout used in this example
-// matches the Pico DVI Sock board, which can be soldered onto a Pico 2:
-// https://github.com/Wren6991/Pico-DVI-Sock
-
-#include "hardware/dma.h"
-#include "hardware/gpio.h"
-#include "hardware/clocks.h"
-#include "hardware/irq.h"
-#include "hardware/structs/bus_ctrl.h"
-#include "hardware/structs/hstx_ctrl.h"
-#include "hardware/structs/hstx_fifo.h"
-#include "hardware/structs/sio.h"
+// current-limiting resistors, e.g. 270 ohms. The scanout engine lives in
+// the dvi_hstx library; this file picks an image and drives it.
+
 #include "pico/multicore.h"
-#include "pico/sem.h"
 #include "stdio.h"
 #include "pico/stdlib.h"
-#include "hardware/vreg.h"
+#include "dvi_hstx.h"
+#include "trace.h"
+#include "bench.h"
+#include "capture.h"
 
 // Comment line below to display 640x240 RGB565
 #define RBG332    // display 640x480 RGB332
+// Uncomment to display 640x480 RGB332 with two alternating dither phases
+// #define FRC
+// Uncomment to decode images/Mario.jpg from flash into a 640x480 RGB332
+// framebuffer at startup, reporting the decode time over the UART
+// #define JPEG
+// Uncomment to show the image called "mario" from an archive written to
+// flash by tools/archive.py and picotool (see README.md)
+// #define ARCHIVE
+// Uncomment to show colour bars until tools/reload.py sends an image over
+// the UART
+// #define RELOAD
+// Uncomment to show an 80x30 text status screen rendered from a character
+// buffer instead of a framebuffer
+// #define TEXT
+// Uncomment to run a VT100/ANSI terminal in the text mode on what arrives
+// over the UART
+// #define TERM
+// Uncomment to scroll a 4 bpp tile map diagonally, with a band of lines
+// wobbling through per-line scroll offsets
+// #define TILES
+// Uncomment to bounce 64 sprites over a gradient, reporting the sprites per
+// line each second
+// #define SPRITES
+// Uncomment to stack the tile map, the sprites and a status window with the
+// compositor, reporting its cost for each number of planes
+// #define COMPOSE
+// Uncomment to show a PAL8 pattern under a copper list: a gradient and
+// raster bars in colour 0, a second palette for the lower half and a wobble
+// through per-line scroll
+// #define COPPER
+// Uncomment to fly over a 256x256 map texture in perspective ("mode 7"),
+// reporting the time per line flat and in perspective
+// #define AFFINE
+// Uncomment, with any of the above, to circle a mouse pointer over the
+// screen as a hardware cursor
+// #define CURSOR
 // ----------------------------------------------------------------------------
-#ifdef RBG332
-#include "mario_640x480_rgb332.h"
-#define framebuf mario_640x480_rgb332
-#else
-#include "mario_640x240_rgb565.h"
-#define framebuf mario_640x240_rgb565
+#if defined(TILES) || defined(COMPOSE)
+#include "tile.h"
+#include "text.h"
+#include <math.h>
+#define MAP_COLS 128
+#define MAP_ROWS 64
+enum
+{
+    TILE_BRICK = 128,
+    TILE_COUNT
+};
+// All read by the IRQ, so in RAM.
+static uint8_t tiles[TILE_COUNT][8 * 8 / 2];
+static uint8_t palettes[16 * 16];
+static uint16_t map[MAP_ROWS][MAP_COLS];
+static int16_t wobble[480];
+static int8_t sine[64];
+static tile_layer_t playfield;
+
+// ASCII from the text mode's font (whose 16 rows are 8 rows doubled) in
+// colour 1 on 0, and a brick in 3 with mortar in 2.
+static void make_tiles(void)
+{
+    for (uint c = 0; c < 128; ++c)
+        for (uint y = 0; y < 8; ++y)
+        {
+            uint g = text_font_8x16[c * TEXT_FONT_HEIGHT + 2 * y];
+            for (uint x = 0; x < 8; x += 2)
+                tiles[c][y * 4 + x / 2] = (g >> (7 - x) & 1) | (g >> (6 - x) & 1) << 4;
+        }
+    for (uint y = 0; y < 8; ++y)
+        for (uint x = 0; x < 8; ++x)
+        {
+            bool mortar = y % 4 == 0 || x == (y < 4 ? 0 : 4);
+            tiles[TILE_BRICK][y * 4 + x / 2] |= (mortar ? 2 : 3) << (x & 1) * 4;
+        }
+}
+
+static void draw_map(void)
+{
+    static const uint8_t bricks[8] = {0x80, 0xa4, 0x88, 0x6c, 0x8d, 0x51, 0x92, 0xb0};
+    static const uint8_t letters[8] = {0xfc, 0x1f, 0xff, 0xe3, 0x1c, 0xf4, 0x9f, 0xf0};
+    for (uint p = 0; p < 8; ++p)
+    {
+        // Palettes 0-7 for bricks, 8-15 for text.
+        palettes[p * 16 + 2] = 0x49;
+        palettes[p * 16 + 3] = bricks[p];
+        palettes[(8 + p) * 16 + 0] = 0x00;
+        palettes[(8 + p) * 16 + 1] = letters[p];
+    }
+    static const char message[] = " DVI OUT HSTX - TILE MODE - 128x64 MAP OF 8x8 TILES AT 4 BPP -";
+    for (uint r = 0; r < MAP_ROWS; ++r)
+        for (uint c = 0; c < MAP_COLS; ++c)
+        {
+            if (r % 8 == 3)
+                map[r][c] = TILE_ENTRY(message[(c + r) % (sizeof(message) - 1)], 0, 8 + r / 8 % 8);
+            else
+                map[r][c] = TILE_ENTRY(TILE_BRICK, r / 8 % 2 ? TILE_HFLIP : 0, (r / 8 + c / 16) % 8);
+        }
+}
+
+// Scroll by a pixel a frame, and wave the bottom quarter of the screen.
+static void __not_in_flash_func(animate)(uint frame, void *user)
+{
+    tile_layer_t *t = (tile_layer_t *)user;
+    t->scroll_x = frame;
+    t->scroll_y = frame / 2;
+    for (uint y = 360; y < 480; ++y)
+        wobble[y] = sine[(y + frame) % 64];
+}
+
+static void start_tiles(void)
+{
+    for (uint i = 0; i < 64; ++i)
+        sine[i] = (int8_t)lroundf(6 * sinf(i * 2 * (float)M_PI / 64));
+    make_tiles();
+    draw_map();
+    tile_init(&playfield, &tiles[0][0], 8, 4, palettes, &map[0][0], MAP_COLS, MAP_ROWS);
+    playfield.line_x = wobble;
+    dvi_set_vblank_callback(animate, &playfield);
+}
 #endif
+#if defined(SPRITES) || defined(COMPOSE)
+#include "sprite.h"
+#include <stdlib.h>
+#define BALL 32
+#define BALL_KEY 0xe3 // magenta, kept out of the balls
+static uint8_t balls[4][BALL * BALL];
+static sprite_layer_t sprite_layer;
+static int16_t dx[SPRITE_MAX], dy[SPRITE_MAX];
+
+static void __not_in_flash_func(sky)(uint y, void *buf, void *user)
+{
+    (void)user;
+    uint32_t c = dvi_rgb332(0, y / 4, 255 - y / 3) * 0x01010101u;
+    uint32_t *p = (uint32_t *)buf;
+    for (uint i = 0; i < 640 / 4; ++i)
+        p[i] = c;
+}
 
-// ----------------------------------------------------------------------------
-// DVI constants
-
-#define TMDS_CTRL_00 0x354u
-#define TMDS_CTRL_01 0x0abu
-#define TMDS_CTRL_10 0x154u
-#define TMDS_CTRL_11 0x2abu
-
-#define SYNC_V0_H0 (TMDS_CTRL_00 | (TMDS_CTRL_00 << 10) | (TMDS_CTRL_00 << 20))
-#define SYNC_V0_H1 (TMDS_CTRL_01 | (TMDS_CTRL_00 << 10) | (TMDS_CTRL_00 << 20))
-#define SYNC_V1_H0 (TMDS_CTRL_10 | (TMDS_CTRL_00 << 10) | (TMDS_CTRL_00 << 20))
-#define SYNC_V1_H1 (TMDS_CTRL_11 | (TMDS_CTRL_00 << 10) | (TMDS_CTRL_00 << 20))
-
-#define MODE_H_SYNC_POLARITY 0
-#define MODE_H_FRONT_PORCH 16
-#define MODE_H_SYNC_WIDTH 96
-#define MODE_H_BACK_PORCH 48
-#define MODE_H_ACTIVE_PIXELS 640
-
-#define MODE_V_SYNC_POLARITY 0
-#define MODE_V_FRONT_PORCH 10
-#define MODE_V_SYNC_WIDTH 2
-#define MODE_V_BACK_PORCH 33
-#define MODE_V_ACTIVE_LINES 480
-
-#define MODE_H_TOTAL_PIXELS (                \
-    MODE_H_FRONT_PORCH + MODE_H_SYNC_WIDTH + \
-    MODE_H_BACK_PORCH + MODE_H_ACTIVE_PIXELS)
-#define MODE_V_TOTAL_LINES (                 \
-    MODE_V_FRONT_PORCH + MODE_V_SYNC_WIDTH + \
-    MODE_V_BACK_PORCH + MODE_V_ACTIVE_LINES)
-
-#define HSTX_CMD_RAW (0x0u << 12)
-#define HSTX_CMD_RAW_REPEAT (0x1u << 12)
-#define HSTX_CMD_TMDS (0x2u << 12)
-#define HSTX_CMD_TMDS_REPEAT (0x3u << 12)
-#define HSTX_CMD_NOP (0xfu << 12)
+// Shaded balls in red, green, blue and yellow, lit from the top left.
+static void make_balls(void)
+{
+    static const uint8_t tint[4][3] = {{255, 64, 48}, {64, 224, 64}, {80, 96, 255}, {255, 224, 32}};
+    for (uint b = 0; b < 4; ++b)
+        for (int y = 0; y < BALL; ++y)
+            for (int x = 0; x < BALL; ++x)
+            {
+                int cx = 2 * x + 1 - BALL, cy = 2 * y + 1 - BALL;
+                uint8_t p = BALL_KEY;
+                if (cx * cx + cy * cy < BALL * BALL)
+                {
+                    int hx = 2 * x - BALL / 2, hy = 2 * y - BALL / 2;
+                    int light = 255 - (hx * hx + hy * hy) * 200 / (4 * BALL * BALL);
+                    light = light < 48 ? 48 : light;
+                    p = dvi_rgb332(tint[b][0] * light / 255, tint[b][1] * light / 255, tint[b][2] * light / 255);
+                    if (p == BALL_KEY)
+                        p ^= 0x04;
+                }
+                balls[b][y * BALL + x] = p;
+            }
+}
 
-// ----------------------------------------------------------------------------
-// HSTX command lists
-
-// Lists are padded with NOPs to be >= HSTX FIFO size, to avoid DMA rapidly
-// pingponging and tripping up the IRQs.
-
-static uint32_t vblank_line_vsync_off[] = {
-    HSTX_CMD_RAW_REPEAT | MODE_H_FRONT_PORCH,
-    SYNC_V1_H1,
-    HSTX_CMD_RAW_REPEAT | MODE_H_SYNC_WIDTH,
-    SYNC_V1_H0,
-    HSTX_CMD_RAW_REPEAT | (MODE_H_BACK_PORCH + MODE_H_ACTIVE_PIXELS),
-    SYNC_V1_H1,
-    HSTX_CMD_NOP};
-
-static uint32_t vblank_line_vsync_on[] = {
-    HSTX_CMD_RAW_REPEAT | MODE_H_FRONT_PORCH,
-    SYNC_V0_H1,
-    HSTX_CMD_RAW_REPEAT | MODE_H_SYNC_WIDTH,
-    SYNC_V0_H0,
-    HSTX_CMD_RAW_REPEAT | (MODE_H_BACK_PORCH + MODE_H_ACTIVE_PIXELS),
-    SYNC_V0_H1,
-    HSTX_CMD_NOP};
-
-static uint32_t vactive_line[] = {
-    HSTX_CMD_RAW_REPEAT | MODE_H_FRONT_PORCH,
-    SYNC_V1_H1,
-    HSTX_CMD_NOP,
-    HSTX_CMD_RAW_REPEAT | MODE_H_SYNC_WIDTH,
-    SYNC_V1_H0,
-    HSTX_CMD_NOP,
-    HSTX_CMD_RAW_REPEAT | MODE_H_BACK_PORCH,
-    SYNC_V1_H1,
-    HSTX_CMD_TMDS | MODE_H_ACTIVE_PIXELS};
+static void place_balls(sprite_layer_t *t, uint count)
+{
+    t->count = count;
+    for (uint i = 0; i < count; ++i)
+    {
+        sprite_t *s = &t->sprites[i];
+        *s = (sprite_t){balls[i % 4], rand() % (640 - BALL), rand() % (480 - BALL), BALL, BALL, BALL, BALL_KEY};
+        dx[i] = rand() % 7 - 3;
+        dy[i] = rand() % 7 - 3;
+    }
+}
 
-// ----------------------------------------------------------------------------
-// DMA logic
+static void move_balls(void)
+{
+    for (uint i = 0; i < sprite_layer.count; ++i)
+    {
+        sprite_t *s = &sprite_layer.sprites[i];
+        if (s->x + dx[i] < 0 || s->x + dx[i] > 640 - BALL)
+            dx[i] = -dx[i];
+        if (s->y + dy[i] < 0 || s->y + dy[i] > 480 - BALL)
+            dy[i] = -dy[i];
+        s->x += dx[i];
+        s->y += dy[i];
+    }
+}
 
-#define DMACH_PING 0
-#define DMACH_PONG 1
+#ifdef SPRITES
+// Per-line cost with no sprites, the demo's 64, and 16 on the same lines,
+// the most a line can hold, on a layer of its own: the IRQ draws the one on
+// show, and takes its commits.
+static void time_sprite_lines(void)
+{
+    static sprite_layer_t bench_layer;
+    sprite_init(&bench_layer, sky, NULL);
+    bench_lines("sprites, none", sprite_scanline, &bench_layer);
+    place_balls(&bench_layer, SPRITE_MAX);
+    sprite_commit(&bench_layer, NULL);
+    bench_lines("sprites, 64 scattered", sprite_scanline, &bench_layer);
+    for (uint i = 0; i < SPRITE_MAX_PER_LINE; ++i)
+    {
+        bench_layer.sprites[i].x = i * (640 - BALL) / (SPRITE_MAX_PER_LINE - 1);
+        bench_layer.sprites[i].y = 0;
+    }
+    bench_layer.count = SPRITE_MAX_PER_LINE;
+    sprite_commit(&bench_layer, NULL);
+    bench_lines("sprites, 16 per line", sprite_scanline, &bench_layer);
+}
+#endif
+#endif
+#ifdef COMPOSE
+#include "compose.h"
+#define PANEL_X 192
+#define PANEL_Y 400
+#define PANEL_W 256
+#define PANEL_H 48
+static uint8_t panel[PANEL_H][PANEL_W];
+static compose_t compositor, bench_compositor;
+
+static void panel_text(uint x, uint y, const char *s, uint8_t fg, uint8_t bg)
+{
+    for (; *s && x + 8 <= PANEL_W; ++s, x += 8)
+        for (uint r = 0; r < TEXT_FONT_HEIGHT; ++r)
+        {
+            uint g = text_font_8x16[(uint8_t)*s * TEXT_FONT_HEIGHT + r];
+            for (uint i = 0; i < 8; ++i)
+                panel[y + r][x + i] = g & 0x80 >> i ? fg : bg;
+        }
+}
 
-// First we ping. Then we pong. Then... we ping again.
-static bool dma_pong = false;
+// An opaque status window with a border, drawn once.
+static void draw_panel(void)
+{
+    for (uint y = 0; y < PANEL_H; ++y)
+        for (uint x = 0; x < PANEL_W; ++x)
+            panel[y][x] = x < 2 || x >= PANEL_W - 2 || y < 2 || y >= PANEL_H - 2 ? 0xff : 0x02;
+    panel_text(16, 6, "Compositor: 3 planes", 0xfc, 0x02);
+    panel_text(16, 24, "tiles, sprites, panel", 0xb6, 0x02);
+}
 
-// A ping and a pong are cued up initially, so the first time we enter this
-// handler it is to cue up the second ping after the first ping has completed.
-// This is the third scanline overall (-> =2 because zero-based).
-static uint v_scanline = 2;
+static uint __not_in_flash_func(panel_spans)(uint y, compose_span_t *spans, uint max, void *user)
+{
+    (void)max;
+    (void)user;
+    if (y < PANEL_Y || y >= PANEL_Y + PANEL_H)
+        return 0;
+    spans[0] = (compose_span_t){PANEL_X, PANEL_X + PANEL_W, COMPOSE_COPY, 0, panel[y - PANEL_Y]};
+    return 1;
+}
 
-// During the vertical active period, we take two IRQs per scanline: one to
-// post the command list, and another to post the pixels.
-static bool vactive_cmdlist_posted = false;
+// The tile map, the balls and the panel, bottom up, over the gradient.
+static void start_compose(compose_t *c, uint planes, bool painter)
+{
+    compose_init(c);
+    c->background = sky;
+    c->painter = painter;
+    if (planes > 0)
+        compose_add(c, tile_spans, tile_render, &playfield);
+    if (planes > 1)
+        compose_add(c, sprite_spans, NULL, &sprite_layer);
+    if (planes > 2)
+        compose_add(c, panel_spans, NULL, NULL);
+}
 
-#ifndef _IMG_ASSET_SECTION
-#define _IMG_ASSET_SECTION ".data"
+// Per-line cost and pixels written for each number of planes, culled and
+// painted bottom up, on a compositor of its own as one holds its line's
+// state.
+static void time_compose_lines(void)
+{
+    static uint32_t line[640 / 4];
+    for (uint planes = 0; planes <= 3; ++planes)
+        for (uint painter = 0; painter < 2; ++painter)
+        {
+            char name[32];
+            snprintf(name, sizeof(name), "%u planes, %s", planes, painter ? "painted" : "culled");
+            start_compose(&bench_compositor, planes, painter);
+            bench_lines(name, compose_scanline, &bench_compositor);
+            bench_compositor.drawn = bench_compositor.culled = 0;
+            for (uint y = 0; y < 480; ++y)
+                compose_scanline(y, line, &bench_compositor);
+            printf("# compose: %lu pixels written a frame, %lu culled\n", (unsigned long)bench_compositor.drawn,
+                   (unsigned long)bench_compositor.culled);
+        }
+}
 #endif
-char __attribute__((aligned(4), section(_IMG_ASSET_SECTION ".tempbuf"))) tempbuf[640]; 
-void __scratch_x("") dma_irq_handler()
+#ifdef TERM
+#include "term.h"
+#include "uart_rx.h"
+#define framebuf NULL
+static text_screen_t screen;
+static term_t term;
+#elif defined(TILES) || defined(SPRITES) || defined(COMPOSE)
+#define framebuf NULL
+#elif defined(AFFINE)
+#include "affine.h"
+#include <math.h>
+#define framebuf NULL
+// Read by the IRQ, so in RAM.
+static uint8_t texture[AFFINE_SIZE][AFFINE_SIZE];
+static affine_line_t floor_lines[2][480];
+static affine_layer_t ground;
+
+// Fields of 32x32 texels between roads, like a map.
+static void draw_texture(void)
 {
-    // dma_pong indicates the channel that just finished, which is the one
-    // we're about to reload.
-    uint ch_num = dma_pong ? DMACH_PONG : DMACH_PING;
-    dma_channel_hw_t *ch = &dma_hw->ch[ch_num];
-    dma_hw->intr = 1u << ch_num;
-    dma_pong = !dma_pong;
-
-    if (v_scanline >= MODE_V_FRONT_PORCH && v_scanline < (MODE_V_FRONT_PORCH + MODE_V_SYNC_WIDTH))
-    {
-        // printf("Vsync %d\n", v_scanline);
-        ch->read_addr = (uintptr_t)vblank_line_vsync_on;
-        ch->transfer_count = count_of(vblank_line_vsync_on);
-    }
-    else if (v_scanline < MODE_V_FRONT_PORCH + MODE_V_SYNC_WIDTH + MODE_V_BACK_PORCH)
+    static const uint8_t fields[8] = {0x30, 0x34, 0x50, 0x74, 0x2c, 0x58, 0x90, 0x38};
+    for (uint v = 0; v < AFFINE_SIZE; ++v)
+        for (uint u = 0; u < AFFINE_SIZE; ++u)
+        {
+            uint8_t c = fields[(u / 32 * 5 + v / 32 * 3) % 8];
+            if ((u / 4 + v / 4) % 2)
+                c += 0x04; // a little texture in each field
+            if (u % 64 < 6 || v % 64 < 6)
+                c = (u % 64 == 2 || v % 64 == 2) && (u + v) % 8 < 4 ? 0xfc : 0x92;
+            texture[v][u] = c;
+        }
+}
+
+// A camera at height 32 texels over the map at (u, v), looking along
+// heading: line y is the floor at distance 32 * 256 / (y + 24), the horizon
+// just above the screen.
+static void mode7_lines(affine_line_t *lines, float u, float v, float heading)
+{
+    float c = cosf(heading), s = sinf(heading);
+    for (uint y = 0; y < 480; ++y)
     {
-        // printf("Vsync %d\n", v_scanline);
-        ch->read_addr = (uintptr_t)vblank_line_vsync_off;
-        ch->transfer_count = count_of(vblank_line_vsync_off);
+        float scale = 32.0f / (float)(y + 24); // texels per pixel
+        float centre_u = u + c * scale * 256, centre_v = v + s * scale * 256;
+        // Along the line, to the right of the heading.
+        float du = -s * scale, dv = c * scale;
+        lines[y] = (affine_line_t){AFFINE_FIXED(centre_u - 320 * du), AFFINE_FIXED(centre_v - 320 * dv),
+                                   AFFINE_FIXED(du), AFFINE_FIXED(dv)};
     }
-    else if (!vactive_cmdlist_posted)
+}
+
+// Time the layer flat, rotated and zoomed, and in perspective.
+static void time_affine_lines(void)
+{
+    affine_layer_t t;
+    affine_init(&t, &texture[0][0]);
+    affine_rotate_zoom(&t.transform, 128, 128, 0.5f, 1.5f);
+    bench_lines("affine, rotated and zoomed", affine_scanline, &t);
+    static affine_line_t lines[480];
+    mode7_lines(lines, 128, 128, 0.5f);
+    t.lines = lines;
+    bench_lines("affine, perspective", affine_scanline, &t);
+}
+#elif defined(COPPER)
+#include <math.h>
+#define PATTERN_LINES 120
+#define WOBBLE 64 // most bytes scrolled, drawn past the right edge
+#define PATTERN_STRIDE (640 + WOBBLE)
+static uint8_t framebuf[PATTERN_STRIDE * PATTERN_LINES];
+// Entry 0 is the background, which the copper sets per line.
+static uint16_t palette[16];
+static const dvi_framebuffer_t image = {
+    .pixels = framebuf,
+    .format = DVI_FORMAT_PAL8,
+    .lines = PATTERN_LINES,
+    .stride = PATTERN_STRIDE,
+    .palette = palette,
+    .palette_size = count_of(palette),
+};
+// Per line: a wait and colour 0, and below the split a scroll; plus the
+// split's palette and the end.
+#define COPPER_WORDS (480 * 2 + 120 + 15 + 1)
+static uint32_t copper_lists[2][COPPER_WORDS];
+
+static inline uint16_t rgb565(uint r, uint g, uint b)
+{
+    return (uint16_t)((r >> 3) << 11 | (g >> 2) << 5 | b >> 3);
+}
+
+// Rings of colours 1-15 with colour 0 between them, repeated down the screen.
+static void draw_pattern(void)
+{
+    for (uint y = 0; y < PATTERN_LINES; ++y)
     {
-        ch->read_addr = (uintptr_t)vactive_line;
-        ch->transfer_count = count_of(vactive_line);
-        vactive_cmdlist_posted = true;
+        for (uint x = 0; x < PATTERN_STRIDE; ++x)
+        {
+            float dx = (float)x - 320.0f, dy = ((float)y - 60.0f) * 2.0f;
+            uint ring = (uint)(sqrtf(dx * dx + dy * dy) / 6.0f);
+            framebuf[y * PATTERN_STRIDE + x] = ring & 1 ? 1 + (ring / 2) % 15 : 0;
+        }
     }
-    else
+    for (uint i = 1; i < 16; ++i)
+        palette[i] = rgb565(16 * i, 128 + 8 * i, 255);
+}
+
+// The list for frame: colour 0 is a sky gradient crossed by three raster
+// bars; from line 240 colours 1-15 turn warm, and from line 360 the lines
+// wobble sideways.
+static uint build_copper(uint32_t *list, uint frame)
+{
+    uint n = 0;
+    int bars[3];
+    for (uint b = 0; b < 3; ++b)
+        bars[b] = 240 + (int)(200.0f * sinf((float)frame * 0.03f + (float)b * 0.6f));
+    for (uint y = 0; y < 480; ++y)
     {
-#ifdef RBG332
-        ch->read_addr = (uintptr_t)&tempbuf;
-        char *ptr = (char *)&framebuf[(v_scanline - (MODE_V_TOTAL_LINES - MODE_V_ACTIVE_LINES)) * MODE_H_ACTIVE_PIXELS];
-        for(int i=0; i<640; i++) {
-            tempbuf[i] = *ptr++;
+        uint16_t colour = rgb565(0, y / 4, 64 + y / 4);
+        for (uint b = 0; b < 3; ++b)
+        {
+            int d = (int)y - bars[b];
+            if (d >= -8 && d < 8)
+            {
+                uint level = 255 - 30 * (uint)(d < 0 ? -d - 1 : d);
+                colour = b == 0 ? rgb565(level, 0, 0) : b == 1 ? rgb565(0, level, 0) : rgb565(level, level, 0);
+                break;
+            }
         }
-        
-        //ch->read_addr = (uintptr_t)&framebuf[(v_scanline - (MODE_V_TOTAL_LINES - MODE_V_ACTIVE_LINES)) * MODE_H_ACTIVE_PIXELS];
-        // // Duplicate the upper half of the image to the lower half
-        // if (v_scanline > 523 - 480 + 240)
-        // {
-        //     ch->read_addr = (uintptr_t)&framebuf[(v_scanline - 239 - (MODE_V_TOTAL_LINES - MODE_V_ACTIVE_LINES)) * MODE_H_ACTIVE_PIXELS];
-        // }
-        // else
-        // {
-        //     ch->read_addr = (uintptr_t)&framebuf[(v_scanline - (MODE_V_TOTAL_LINES - MODE_V_ACTIVE_LINES)) * MODE_H_ACTIVE_PIXELS];
-        // }
-        ch->transfer_count = MODE_H_ACTIVE_PIXELS / sizeof(uint32_t);
-#else
-        // 640x480 RGB565 is too large to fit into memory. The include file is 640 x 240 pixels.
-        // The image is duplicated to the lower half of the screen. 
-        if (v_scanline > 523 - 480 + 240)
+        list[n++] = DVI_COPPER_WAIT(y);
+        list[n++] = DVI_COPPER_PALETTE(0, colour);
+        if (y == 240)
         {
-            ch->read_addr = (uintptr_t)&framebuf[(v_scanline - 239 - (MODE_V_TOTAL_LINES - MODE_V_ACTIVE_LINES)) * MODE_H_ACTIVE_PIXELS * 2];
+            for (uint i = 1; i < 16; ++i)
+                list[n++] = DVI_COPPER_PALETTE(i, rgb565(255, 16 * i, 64));
         }
-        else
+        if (y >= 360)
         {
-            ch->read_addr = (uintptr_t)&framebuf[(v_scanline - (MODE_V_TOTAL_LINES - MODE_V_ACTIVE_LINES)) * MODE_H_ACTIVE_PIXELS * 2];
+            float s = sinf((float)(y + frame * 2) * 0.1f);
+            list[n++] = DVI_COPPER_SCROLL_X(4 * (uint)((float)(WOBBLE / 8) * (1.0f + s)));
         }
-        ch->transfer_count = MODE_H_ACTIVE_PIXELS * 2 / sizeof(uint32_t);
-#endif
-        
-        vactive_cmdlist_posted = false;
-        // printf("Scanline %d\n", v_scanline);
     }
+    list[n++] = DVI_COPPER_END;
+    return n;
+}
+#elif defined(RELOAD)
+#include "reload.h"
+#define framebuf NULL
 
-    if (!vactive_cmdlist_posted)
-    {
+static void __not_in_flash_func(colour_bars)(uint y, void *buf, void *user)
+{
+    (void)y;
+    (void)user;
+    // White, yellow, cyan, green, magenta, red, blue, black in RGB332.
+    static const uint8_t bars[8] = {0xff, 0xfc, 0x1f, 0x1c, 0xe3, 0xe0, 0x03, 0x00};
+    uint32_t *p = (uint32_t *)buf;
+    for (uint i = 0; i < 640 / 4; ++i)
+        p[i] = bars[i / 20] * 0x01010101u;
+}
+#elif defined(TEXT)
+#include "text.h"
+#define framebuf NULL
+static text_screen_t screen;
 
-        v_scanline = (v_scanline + 1) % MODE_V_TOTAL_LINES;
+static void draw_status_screen(void)
+{
+    const uint8_t title = TEXT_ATTR(TEXT_WHITE, TEXT_BLUE);
+    const uint8_t frame = TEXT_ATTR(TEXT_LIGHT_CYAN, TEXT_BLACK);
+    text_init(&screen);
+    for (uint x = 0; x < TEXT_COLS; ++x)
+        screen.rows[0][x] = TEXT_CELL(' ', title);
+    text_print(&screen, 1, 0, "DVI output example - 80x30 text mode", title);
+    // A double-lined box in CP437 box drawing characters.
+    for (uint x = 1; x < 39; ++x)
+        screen.rows[2][x] = screen.rows[9][x] = TEXT_CELL(0xcd, frame);
+    for (uint y = 3; y < 9; ++y)
+        screen.rows[y][0] = screen.rows[y][39] = TEXT_CELL(0xba, frame);
+    screen.rows[2][0] = TEXT_CELL(0xc9, frame);
+    screen.rows[2][39] = TEXT_CELL(0xbb, frame);
+    screen.rows[9][0] = TEXT_CELL(0xc8, frame);
+    screen.rows[9][39] = TEXT_CELL(0xbc, frame);
+    text_print(&screen, 2, 3, "Mode      640x480 RGB332, 8x16 cells", TEXT_ATTR(TEXT_LIGHT_GREY, TEXT_BLACK));
+    text_print(&screen, 2, 4, "Colours", TEXT_ATTR(TEXT_LIGHT_GREY, TEXT_BLACK));
+    for (uint i = 0; i < 16; ++i)
+    {
+        screen.rows[4][12 + i] = TEXT_CELL(0xdb, TEXT_ATTR(i, TEXT_BLACK));
+        screen.rows[5][12 + i] = TEXT_CELL(0xb1, TEXT_ATTR(i, 15 - i));
     }
+    text_print(&screen, 2, 7, "Core 0", TEXT_ATTR(TEXT_LIGHT_GREY, TEXT_BLACK));
 }
 
-// ----------------------------------------------------------------------------
-// Main program
+// Render every line on core 0 and report the time per line, which the IRQ
+// spends a line ahead of the scanout.
+static void time_text_lines(void)
+{
+    bench_lines("text", text_scanline, &screen);
+    printf("# text: %u bytes of cells and colours, %u of font\n", (unsigned)sizeof(screen),
+           (unsigned)sizeof(text_font_8x16));
+}
+#elif defined(ARCHIVE)
+#include "archive.h"
+#ifndef ARCHIVE_FLASH_OFFSET
+#define ARCHIVE_FLASH_OFFSET 0x200000
+#endif
+// Packed images are unpacked here; the others are scanned out from flash.
+static uint8_t unpacked[640 * 480];
+static dvi_framebuffer_t image = {
+    .pixels = unpacked,
+    .format = DVI_FORMAT_RGB332,
+    .lines = 480,
+    .stride = 640,
+};
+#define framebuf image.pixels
+
+static bool image_from_archive(const char *name)
+{
+    archive_t a;
+    asset_image_t img;
+    if (!archive_open(&a, (const void *)(XIP_BASE + ARCHIVE_FLASH_OFFSET)) ||
+        !archive_image(&a, archive_find(&a, name), &img) || img.format == ASSET_FORMAT_PAL4)
+        return false;
+    if (img.pack != ASSET_PACK_NONE)
+    {
+        if ((uint64_t)img.stride * img.height > sizeof(unpacked) || !asset_unpack(&img, unpacked))
+            return false;
+        img.data = unpacked;
+    }
+    // asset_format_t matches dvi_format_t for these.
+    image.pixels = img.data;
+    image.format = (dvi_format_t)img.format;
+    image.lines = img.height;
+    image.stride = img.stride;
+    image.palette = img.palette;
+    image.palette_size = img.palette_size;
+    // Staging keeps XIP cache misses out of the scanout DMA.
+    image.flags = DVI_FB_STAGED;
+    return true;
+}
+#elif defined(JPEG)
+// Linked as is by asset_embed(... SECTION .rodata Mario.jpg).
+extern const uint8_t Mario_jpg[], Mario_jpg_end[];
+static uint8_t framebuf[640 * 480];
+static const dvi_framebuffer_t image = {
+    .pixels = framebuf,
+    .format = DVI_FORMAT_RGB332,
+    .lines = 480,
+    .stride = 640,
+    .flags = DVI_FB_STAGED,
+};
+#elif defined(FRC)
+// Two 640x240 phases of Mountains.png, line-doubled and cycled per frame
+// through the line tables (tools/imgconv.py --phases).
+#include "mountains_640x480_rgb332_frc2.h"
+#define framebuf mountains_640x480_rgb332_frc2
+static const dvi_line_table_t image = {
+    .lines = mountains_640x480_rgb332_frc2_lines,
+    .format = DVI_FORMAT_RGB332,
+    .phases = MOUNTAINS_640X480_RGB332_FRC2_PHASES,
+    .flags = DVI_FB_STAGED,
+};
+#elif defined(RBG332)
+#include "mario_640x480_rgb332.h"
+#define framebuf mario_640x480_rgb332
+static const dvi_framebuffer_t image = {
+    .pixels = framebuf,
+    .format = DVI_FORMAT_RGB332,
+    .lines = MARIO_640X480_RGB332_HEIGHT,
+    .stride = MARIO_640X480_RGB332_STRIDE,
+    .flags = DVI_FB_STAGED,
+};
+#else
+// 640x480 RGB565 is too large to fit into memory. The image is the top 640 x 240 pixels.
+// The image is duplicated to the lower half of the screen.
+#include "mario_640x240_rgb565.h"
+#define framebuf mario_640x240_rgb565
+static const dvi_framebuffer_t image = {
+    .pixels = framebuf,
+    .format = DVI_FORMAT_RGB565,
+    .lines = MARIO_640X240_RGB565_HEIGHT,
+    .stride = MARIO_640X240_RGB565_STRIDE,
+};
+#endif
 
-static __force_inline uint16_t colour_rgb565(uint8_t r, uint8_t g, uint8_t b)
+#ifdef CURSOR
+#include <math.h>
+// An arrow: X outline in colour 0, . fill in colour 1.
+static const char *const arrow[] = {
+    "X",
+    "XX",
+    "X.X",
+    "X..X",
+    "X...X",
+    "X....X",
+    "X.....X",
+    "X......X",
+    "X.......X",
+    "X........X",
+    "X.........X",
+    "X......XXXXX",
+    "X...X..X",
+    "X..XX..X",
+    "X.X  X..X",
+    "XX   X..X",
+    "X     X..X",
+    "      X..X",
+    "       XX",
+};
+// Read by the IRQ, so in RAM.
+static dvi_cursor_t pointer = {
+    .colours = {0x0000, 0xffff},
+    .height = count_of(arrow),
+};
+
+static void make_pointer(void)
 {
-    // printf("RGB565: %02x %02x %02x\n", r, g, b);
-    return ((uint16_t)r & 0xf8) >> 3 | ((uint16_t)g & 0xfc) << 3 | ((uint16_t)b & 0xf8) << 8;
+    for (uint y = 0; y < count_of(arrow); ++y)
+    {
+        for (uint x = 0; arrow[y][x]; ++x)
+        {
+            uint64_t v = arrow[y][x] == 'X' ? DVI_CURSOR_COLOUR0 : arrow[y][x] == '.' ? DVI_CURSOR_COLOUR1 : 0;
+            pointer.rows[y] |= v << 2 * x;
+            if (x + 1 > pointer.width)
+                pointer.width = x + 1;
+        }
+    }
 }
 
-static __force_inline uint8_t colour_rgb332(uint8_t r, uint8_t g, uint8_t b)
+// Round the screen once every four seconds, the position taken at vblank.
+static bool move_pointer(repeating_timer_t *rt)
 {
-    // printf("RGB332: %02x %02x %02x\n", r, g, b);
-    return (r & 0xc0) >> 6 | (g & 0xe0) >> 3 | (b & 0xe0) >> 0;
+    static uint step = 0;
+    float a = (float)step++ * 2 * (float)M_PI / 240;
+    dvi_move_cursor(320 + (int)(200 * cosf(a)), 240 + (int)(160 * sinf(a)));
+    (void)rt;
+    return true;
 }
+#endif
 
-void scroll_framebuffer(void);
+// ----------------------------------------------------------------------------
+// Main program
 
 void core1_main()
 {
     printf("DVI output example\n");
-
-#ifdef RBG332
+#ifdef TERM
+    printf("80x30 VT100/ANSI terminal on the UART\n");
+#elif defined(TILES)
+    printf("640x480 RGB332 from a tile map\n");
+#elif defined(SPRITES)
+    printf("640x480 RGB332 sprites over a gradient\n");
+#elif defined(COMPOSE)
+    printf("640x480 RGB332 composed from tiles, sprites and a window\n");
+#elif defined(COPPER)
+    printf("640x480 PAL8 under a copper list\n");
+#elif defined(AFFINE)
+    printf("640x480 RGB332 from a texture in perspective\n");
+#elif defined(RELOAD)
+    printf("640x480 RGB332 colour bars, waiting for tools/reload.py\n");
+#elif defined(TEXT)
+    printf("80x30 text mode\n");
+#elif defined(ARCHIVE)
+    printf("image from the archive at flash offset 0x%x\n", ARCHIVE_FLASH_OFFSET);
+#elif defined(JPEG)
+    printf("640x480 RGB332, decoded from JPEG\n");
+#elif defined(FRC)
+    printf("640x480 RGB332, 2 FRC phases\n");
+#elif defined(RBG332)
     printf("640x480 RGB332\n");
-    // Configure HSTX's TMDS encoder for RGB332
-    hstx_ctrl_hw->expand_tmds =
-        2 << HSTX_CTRL_EXPAND_TMDS_L2_NBITS_LSB |
-        0 << HSTX_CTRL_EXPAND_TMDS_L2_ROT_LSB |
-        2 << HSTX_CTRL_EXPAND_TMDS_L1_NBITS_LSB |
-        29 << HSTX_CTRL_EXPAND_TMDS_L1_ROT_LSB |
-        1 << HSTX_CTRL_EXPAND_TMDS_L0_NBITS_LSB |
-        26 << HSTX_CTRL_EXPAND_TMDS_L0_ROT_LSB;
 #else
-    // This should be RGB565
     printf("640x240 RGB565\n");
-    hstx_ctrl_hw->expand_tmds =
-        5 << HSTX_CTRL_EXPAND_TMDS_L2_NBITS_LSB | // 5 bits for red
-        0 << HSTX_CTRL_EXPAND_TMDS_L2_ROT_LSB |   // No rotation for red
-        6 << HSTX_CTRL_EXPAND_TMDS_L1_NBITS_LSB | // 6 bits for green
-        29 << HSTX_CTRL_EXPAND_TMDS_L1_ROT_LSB |  // Rotation for green
-        5 << HSTX_CTRL_EXPAND_TMDS_L0_NBITS_LSB | // 5 bits for blue
-        26 << HSTX_CTRL_EXPAND_TMDS_L0_ROT_LSB;   // Rotation for blue
 #endif
-    // Pixels (TMDS) come in 4 8-bit chunks. Control symbols (RAW) are an
-    // entire 32-bit word.
-    hstx_ctrl_hw->expand_shift =
-        4 << HSTX_CTRL_EXPAND_SHIFT_ENC_N_SHIFTS_LSB |
-        8 << HSTX_CTRL_EXPAND_SHIFT_ENC_SHIFT_LSB |
-        1 << HSTX_CTRL_EXPAND_SHIFT_RAW_N_SHIFTS_LSB |
-        0 << HSTX_CTRL_EXPAND_SHIFT_RAW_SHIFT_LSB;
-
-    // Serial output config: clock period of 5 cycles, pop from command
-    // expander every 5 cycles, shift the output shiftreg by 2 every cycle.
-    hstx_ctrl_hw->csr = 0;
-    hstx_ctrl_hw->csr =
-        HSTX_CTRL_CSR_EXPAND_EN_BITS |
-        5u << HSTX_CTRL_CSR_CLKDIV_LSB |
-        5u << HSTX_CTRL_CSR_N_SHIFTS_LSB |
-        2u << HSTX_CTRL_CSR_SHIFT_LSB |
-        HSTX_CTRL_CSR_EN_BITS;
-
-    // Note we are leaving the HSTX clock at the SDK default of 125 MHz; since
-    // we shift out two bits per HSTX clock cycle, this gives us an output of
-    // 250 Mbps, which is very close to the bit clock for 480p 60Hz (252 MHz).
-    // If we want the exact rate then we'll have to reconfigure PLLs.
-
-    // HSTX outputs 0 through 7 appear on GPIO 12 through 19.
-    // Pinout on Pico DVI sock:
-    //
-    //   GP12 D0+  GP13 D0-
-    //   GP14 CK+  GP15 CK-
-    //   GP16 D2+  GP17 D2-
-    //   GP18 D1+  GP19 D1-
-
-    // Assign clock pair to two neighbouring pins:
-    hstx_ctrl_hw->bit[2] = HSTX_CTRL_BIT0_CLK_BITS;
-    hstx_ctrl_hw->bit[3] = HSTX_CTRL_BIT0_CLK_BITS | HSTX_CTRL_BIT0_INV_BITS;
-    for (uint lane = 0; lane < 3; ++lane)
-    {
-        // For each TMDS lane, assign it to the correct GPIO pair based on the
-        // desired pinout:
-        // HSTX Output Bits and GPIO Pins
-        // The HSTX hardware outputs data on 8 "output bits" (0 through 7), which are mapped to specific GPIO pins. The mapping is fixed as follows:
-
-        // HSTX Output Bit 0 → GPIO12
-        // HSTX Output Bit 1 → GPIO13
-        // HSTX Output Bit 2 → GPIO14
-        // HSTX Output Bit 3 → GPIO15
-        // HSTX Output Bit 4 → GPIO16
-        // HSTX Output Bit 5 → GPIO17
-        // HSTX Output Bit 6 → GPIO18
-        // HSTX Output Bit 7 → GPIO19
-        // lane_to_output_bit Array
-        // The lane_to_output_bit array specifies which HSTX output bits are used for each TMDS lane:
-
-        // Index 0: TMDS lane D0 (data lane 0)
-        // Index 1: TMDS lane D1 (data lane 1)
-        // Index 2: TMDS lane D2 (data lane 2)
-
-        // Hardcoded mapping for now using Adafruit Metro RP2350
-        // The mapping is fixed as follows:
-        // D0+ = CPIO18, D0-=GPIO19, D1+=GPIO16, D1-=GPIO17, D2+-GPIO12, D2-=GPIO13 
-        // For the array {6, 4, 0}:
-        
-        // D0 (Index 0) is assigned to HSTX output bit 6 → GPIO18 (D0+) and GPIO19 (D0-).
-        // D1 (Index 1) is assigned to HSTX output bit 4 → GPIO16 (D1+) and GPIO17 (D1-).
-        // D2 (Index 2) is assigned to HSTX output bit 0 → GPIO12 (D2+) and GPIO13 (D2-).
-        // https://learn.adafruit.com/adafruit-metro-rp2350/pinouts#hstx-connector-3193107
-        static const int lane_to_output_bit[3] = {6, 4, 0}; // was {0, 6, 4};
-        int bit = lane_to_output_bit[lane];
-        // Output even bits during first half of each HSTX cycle, and odd bits
-        // during second half. The shifter advances by two bits each cycle.
-        uint32_t lane_data_sel_bits =
-            (lane * 10) << HSTX_CTRL_BIT0_SEL_P_LSB |
-            (lane * 10 + 1) << HSTX_CTRL_BIT0_SEL_N_LSB;
-        // The two halves of each pair get identical data, but one pin is inverted.
-        hstx_ctrl_hw->bit[bit] = lane_data_sel_bits;
-        hstx_ctrl_hw->bit[bit + 1] = lane_data_sel_bits | HSTX_CTRL_BIT0_INV_BITS;
-    }
-
-    for (int i = 12; i <= 19; ++i)
-    {
-        gpio_set_function(i, 0); // HSTX
-    }
-
-    // Both channels are set up identically, to transfer a whole scanline and
-    // then chain to the opposite channel. Each time a channel finishes, we
-    // reconfigure the one that just finished, meanwhile the opposite channel
-    // is already making progress.
-    dma_channel_config c;
-    c = dma_channel_get_default_config(DMACH_PING);
-    channel_config_set_chain_to(&c, DMACH_PONG);
-    channel_config_set_dreq(&c, DREQ_HSTX);
-    dma_channel_configure(
-        DMACH_PING,
-        &c,
-        &hstx_fifo_hw->fifo,
-        vblank_line_vsync_off,
-        count_of(vblank_line_vsync_off),
-        false);
-    c = dma_channel_get_default_config(DMACH_PONG);
-    channel_config_set_chain_to(&c, DMACH_PING);
-    channel_config_set_dreq(&c, DREQ_HSTX);
-    dma_channel_configure(
-        DMACH_PONG,
-        &c,
-        &hstx_fifo_hw->fifo,
-        vblank_line_vsync_off,
-        count_of(vblank_line_vsync_off),
-        false);
-
-    dma_hw->ints0 = (1u << DMACH_PING) | (1u << DMACH_PONG);
-    dma_hw->inte0 = (1u << DMACH_PING) | (1u << DMACH_PONG);
-    irq_set_exclusive_handler(DMA_IRQ_0, dma_irq_handler);
-    irq_set_enabled(DMA_IRQ_0, true);
-
-    bus_ctrl_hw->priority = BUSCTRL_BUS_PRIORITY_DMA_W_BITS | BUSCTRL_BUS_PRIORITY_DMA_R_BITS;
-
-    dma_channel_start(DMACH_PING);
+    dvi_start();
 
     while (1)
         __wfi();
@@ -366,13 +678,182 @@ void core1_main()
 int main(void)
 {
     stdio_init_all();
+    trace_init();
+    dvi_init(&dvi_mode_640x480_60);
+#ifdef ARCHIVE
+    if (!image_from_archive("mario"))
+        printf("No usable \"mario\" in the archive at flash offset 0x%x\n", ARCHIVE_FLASH_OFFSET);
+#endif
+#ifdef TERM
+    text_init(&screen);
+    term_init(&term, &screen);
+    text_show(&screen);
+#elif defined(TILES)
+    start_tiles();
+    tile_show(&playfield);
+#elif defined(SPRITES)
+    make_balls();
+    sprite_init(&sprite_layer, sky, NULL);
+    place_balls(&sprite_layer, SPRITE_MAX);
+    sprite_show(&sprite_layer);
+#elif defined(COMPOSE)
+    start_tiles();
+    make_balls();
+    sprite_init(&sprite_layer, NULL, NULL);
+    place_balls(&sprite_layer, SPRITE_MAX);
+    sprite_commit(&sprite_layer, NULL);
+    draw_panel();
+    start_compose(&compositor, 3, false);
+    compose_show(&compositor);
+#elif defined(COPPER)
+    draw_pattern();
+    dvi_set_framebuffer(&image);
+    build_copper(copper_lists[0], 0);
+    dvi_set_copper(copper_lists[0]);
+#elif defined(AFFINE)
+    draw_texture();
+    affine_init(&ground, &texture[0][0]);
+    mode7_lines(floor_lines[0], 0, 0, 0);
+    ground.lines = floor_lines[0];
+    affine_show(&ground);
+#elif defined(RELOAD)
+    reload_init(DVI_FORMAT_RGB332, colour_bars, NULL);
+#elif defined(TEXT)
+    draw_status_screen();
+    text_show(&screen);
+#elif defined(FRC)
+    dvi_set_line_table(&image);
+#else
+    dvi_set_framebuffer(&image);
+#endif
+#ifdef CURSOR
+    make_pointer();
+    dvi_set_cursor(&pointer);
+    static repeating_timer_t pointer_timer;
+    add_repeating_timer_ms(-16, move_pointer, NULL, &pointer_timer);
+#endif
     sleep_ms(1000);
     printf("DVI output example on Core1\n");
+    const vmem_arena_t *arenas[] = {&vmem_main, &vmem_scratch};
+    vmem_report(arenas, count_of(arenas));
     int teller = 0;
     multicore_launch_core1(core1_main);
+#ifdef TERM
+    // From here on received bytes go to the terminal, not stdio.
+    uart_rx_init(uart0);
+#endif
+#ifdef JPEG
+    // Decoded while displayed, so the bands can be seen arriving.
+    bench_jpeg(Mario_jpg, Mario_jpg_end - Mario_jpg, framebuf, 640, ASSET_FORMAT_RGB332);
+#endif
+#ifdef TEXT
+    time_text_lines();
+#endif
+#ifdef SPRITES
+    time_sprite_lines();
+#endif
+#ifdef COMPOSE
+    time_compose_lines();
+#endif
+#ifdef AFFINE
+    time_affine_lines();
+#endif
+#ifdef TILES
+    bench_lines("tiles, 8x8 at 4 bpp", tile_scanline, &playfield);
+    printf("# tiles: %u bytes of map, %u of tiles and palettes\n", (unsigned)sizeof(map),
+           (unsigned)(sizeof(tiles) + sizeof(palettes)));
+#endif
+#if DVI_BENCH
+    sleep_ms(100);
+    bench_run(framebuf);
+#endif
     while (1)
     {
+#ifdef TERM
+        // Draw what arrives for a second; the ring holds what comes in
+        // meanwhile.
+        static uint8_t buf[256];
+        uint32_t received = 0;
+        absolute_time_t until = make_timeout_time_ms(1000);
+        while (!time_reached(until))
+        {
+            size_t n = uart_rx_read(buf, sizeof(buf));
+            if (n)
+            {
+                term_write(&term, (const char *)buf, n);
+                received += n;
+            }
+            else
+                best_effort_wfe_or_timeout(until);
+        }
+        printf("# term: %lu bytes/s, %lu dropped\n", (unsigned long)received, (unsigned long)uart_rx_dropped());
+        int c = -1;
+#elif defined(SPRITES) || defined(COMPOSE)
+        // A second of animation, paced by sprite_commit() to the display.
+        sprite_stats_t stats, worst = {0};
+        for (uint frame = 0; frame < 60; ++frame)
+        {
+            move_balls();
+            sprite_commit(&sprite_layer, &stats);
+            if (stats.busiest > worst.busiest)
+                worst.busiest = stats.busiest;
+            worst.lines_over += stats.lines_over;
+            worst.dropped += stats.dropped;
+        }
+        printf("# sprites: %u on screen, up to %u on a line, %u lines over the limit, %u sprite lines dropped\n",
+               stats.sprites, worst.busiest, worst.lines_over, worst.dropped);
+        int c = getchar_timeout_us(0);
+#elif defined(COPPER)
+        // A second of animation, a new list per frame.
+        static uint frame = 0;
+        uint words = 0;
+        uint64_t build_us = 0;
+        for (uint i = 0; i < 60; ++i)
+        {
+            ++frame;
+            absolute_time_t t0 = get_absolute_time();
+            words = build_copper(copper_lists[frame & 1], frame);
+            build_us += absolute_time_diff_us(t0, get_absolute_time());
+            dvi_set_copper(copper_lists[frame & 1]);
+            // The other list is free once this one is taken.
+            dvi_wait_vblank();
+        }
+        printf("# copper: %u words a frame, built in %lu us\n", words, (unsigned long)(build_us / 60));
+        int c = getchar_timeout_us(0);
+#elif defined(AFFINE)
+        // A second of flight, a new table of lines per frame.
+        static uint frame = 0;
+        for (uint i = 0; i < 60; ++i)
+        {
+            ++frame;
+            float heading = (float)frame * 0.005f;
+            float u = (float)frame * 0.5f * cosf(heading), v = (float)frame * 0.5f * sinf(heading);
+            mode7_lines(floor_lines[frame & 1], u, v, heading);
+            ground.lines = floor_lines[frame & 1];
+            // After this the other table is free to rewrite.
+            dvi_wait_vblank();
+        }
+        int c = getchar_timeout_us(0);
+#elif defined(RELOAD)
+        // Handles any frames from tools/reload.py and returns other input.
+        int c = reload_poll(1000000);
+#else
         sleep_ms(1000);
+        int c = getchar_timeout_us(0);
+#endif
+        trace_event(TRACE_EV_TASK_BEGIN, TRACE_TASK_MAIN_LOOP);
+#ifdef TEXT
+        char status[32];
+        snprintf(status, sizeof(status), "running, count %d", teller);
+        text_print(&screen, 12, 7, status, TEXT_ATTR(TEXT_YELLOW, TEXT_BLACK));
+#endif
         printf("Running random on core 0: %d\n", teller++);
+        trace_event(TRACE_EV_TASK_END, TRACE_TASK_MAIN_LOOP);
+        // Send 't' over the UART to dump the trace rings (DVI_TRACE=1 builds),
+        // 's' (tools/capture.py) for a screenshot.
+        if (c == 't')
+            trace_dump();
+        else if (c == 's')
+            capture_send();
     }
 }
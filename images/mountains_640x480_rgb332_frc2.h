@@ -0,0 +1,268 @@
+// Generated by tools/imgconv.py from Mountains.png; do not edit.
+// rgb332 2 FRC phases 640x480, 480 distinct lines, 307200 bytes
+
+#ifndef _MOUNTAINS_640X480_RGB332_FRC2_H
+#define _MOUNTAINS_640X480_RGB332_FRC2_H
+
+#include <stdint.h>
+
+#define MOUNTAINS_640X480_RGB332_FRC2_WIDTH 640
+#define MOUNTAINS_640X480_RGB332_FRC2_LINES 480
+#define MOUNTAINS_640X480_RGB332_FRC2_STRIDE 640
+#define MOUNTAINS_640X480_RGB332_FRC2_SIZE 307200
+#define MOUNTAINS_640X480_RGB332_FRC2_PHASES 2
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+extern const uint8_t mountains_640x480_rgb332_frc2[];
+#ifdef __cplusplus
+}
+#endif
+
+// One table per frame. Not const, so it is in RAM where the DMA IRQ reads
+// it without touching flash.
+static const void *mountains_640x480_rgb332_frc2_lines[960] = {
+    mountains_640x480_rgb332_frc2 + 0, mountains_640x480_rgb332_frc2 + 153600, mountains_640x480_rgb332_frc2 + 640, mountains_640x480_rgb332_frc2 + 154240,
+    mountains_640x480_rgb332_frc2 + 1280, mountains_640x480_rgb332_frc2 + 154880, mountains_640x480_rgb332_frc2 + 1920, mountains_640x480_rgb332_frc2 + 155520,
+    mountains_640x480_rgb332_frc2 + 2560, mountains_640x480_rgb332_frc2 + 156160, mountains_640x480_rgb332_frc2 + 3200, mountains_640x480_rgb332_frc2 + 156800,
+    mountains_640x480_rgb332_frc2 + 3840, mountains_640x480_rgb332_frc2 + 157440, mountains_640x480_rgb332_frc2 + 4480, mountains_640x480_rgb332_frc2 + 158080,
+    mountains_640x480_rgb332_frc2 + 5120, mountains_640x480_rgb332_frc2 + 158720, mountains_640x480_rgb332_frc2 + 5760, mountains_640x480_rgb332_frc2 + 159360,
+    mountains_640x480_rgb332_frc2 + 6400, mountains_640x480_rgb332_frc2 + 160000, mountains_640x480_rgb332_frc2 + 7040, mountains_640x480_rgb332_frc2 + 160640,
+    mountains_640x480_rgb332_frc2 + 7680, mountains_640x480_rgb332_frc2 + 161280, mountains_640x480_rgb332_frc2 + 8320, mountains_640x480_rgb332_frc2 + 161920,
+    mountains_640x480_rgb332_frc2 + 8960, mountains_640x480_rgb332_frc2 + 162560, mountains_640x480_rgb332_frc2 + 9600, mountains_640x480_rgb332_frc2 + 163200,
+    mountains_640x480_rgb332_frc2 + 10240, mountains_640x480_rgb332_frc2 + 163840, mountains_640x480_rgb332_frc2 + 10880, mountains_640x480_rgb332_frc2 + 164480,
+    mountains_640x480_rgb332_frc2 + 11520, mountains_640x480_rgb332_frc2 + 165120, mountains_640x480_rgb332_frc2 + 12160, mountains_640x480_rgb332_frc2 + 165760,
+    mountains_640x480_rgb332_frc2 + 12800, mountains_640x480_rgb332_frc2 + 166400, mountains_640x480_rgb332_frc2 + 13440, mountains_640x480_rgb332_frc2 + 167040,
+    mountains_640x480_rgb332_frc2 + 14080, mountains_640x480_rgb332_frc2 + 167680, mountains_640x480_rgb332_frc2 + 14720, mountains_640x480_rgb332_frc2 + 168320,
+    mountains_640x480_rgb332_frc2 + 15360, mountains_640x480_rgb332_frc2 + 168960, mountains_640x480_rgb332_frc2 + 16000, mountains_640x480_rgb332_frc2 + 169600,
+    mountains_640x480_rgb332_frc2 + 16640, mountains_640x480_rgb332_frc2 + 170240, mountains_640x480_rgb332_frc2 + 17280, mountains_640x480_rgb332_frc2 + 170880,
+    mountains_640x480_rgb332_frc2 + 17920, mountains_640x480_rgb332_frc2 + 171520, mountains_640x480_rgb332_frc2 + 18560, mountains_640x480_rgb332_frc2 + 172160,
+    mountains_640x480_rgb332_frc2 + 19200, mountains_640x480_rgb332_frc2 + 172800, mountains_640x480_rgb332_frc2 + 19840, mountains_640x480_rgb332_frc2 + 173440,
+    mountains_640x480_rgb332_frc2 + 20480, mountains_640x480_rgb332_frc2 + 174080, mountains_640x480_rgb332_frc2 + 21120, mountains_640x480_rgb332_frc2 + 174720,
+    mountains_640x480_rgb332_frc2 + 21760, mountains_640x480_rgb332_frc2 + 175360, mountains_640x480_rgb332_frc2 + 22400, mountains_640x480_rgb332_frc2 + 176000,
+    mountains_640x480_rgb332_frc2 + 23040, mountains_640x480_rgb332_frc2 + 176640, mountains_640x480_rgb332_frc2 + 23680, mountains_640x480_rgb332_frc2 + 177280,
+    mountains_640x480_rgb332_frc2 + 24320, mountains_640x480_rgb332_frc2 + 177920, mountains_640x480_rgb332_frc2 + 24960, mountains_640x480_rgb332_frc2 + 178560,
+    mountains_640x480_rgb332_frc2 + 25600, mountains_640x480_rgb332_frc2 + 179200, mountains_640x480_rgb332_frc2 + 26240, mountains_640x480_rgb332_frc2 + 179840,
+    mountains_640x480_rgb332_frc2 + 26880, mountains_640x480_rgb332_frc2 + 180480, mountains_640x480_rgb332_frc2 + 27520, mountains_640x480_rgb332_frc2 + 181120,
+    mountains_640x480_rgb332_frc2 + 28160, mountains_640x480_rgb332_frc2 + 181760, mountains_640x480_rgb332_frc2 + 28800, mountains_640x480_rgb332_frc2 + 182400,
+    mountains_640x480_rgb332_frc2 + 29440, mountains_640x480_rgb332_frc2 + 183040, mountains_640x480_rgb332_frc2 + 30080, mountains_640x480_rgb332_frc2 + 183680,
+    mountains_640x480_rgb332_frc2 + 30720, mountains_640x480_rgb332_frc2 + 184320, mountains_640x480_rgb332_frc2 + 31360, mountains_640x480_rgb332_frc2 + 184960,
+    mountains_640x480_rgb332_frc2 + 32000, mountains_640x480_rgb332_frc2 + 185600, mountains_640x480_rgb332_frc2 + 32640, mountains_640x480_rgb332_frc2 + 186240,
+    mountains_640x480_rgb332_frc2 + 33280, mountains_640x480_rgb332_frc2 + 186880, mountains_640x480_rgb332_frc2 + 33920, mountains_640x480_rgb332_frc2 + 187520,
+    mountains_640x480_rgb332_frc2 + 34560, mountains_640x480_rgb332_frc2 + 188160, mountains_640x480_rgb332_frc2 + 35200, mountains_640x480_rgb332_frc2 + 188800,
+    mountains_640x480_rgb332_frc2 + 35840, mountains_640x480_rgb332_frc2 + 189440, mountains_640x480_rgb332_frc2 + 36480, mountains_640x480_rgb332_frc2 + 190080,
+    mountains_640x480_rgb332_frc2 + 37120, mountains_640x480_rgb332_frc2 + 190720, mountains_640x480_rgb332_frc2 + 37760, mountains_640x480_rgb332_frc2 + 191360,
+    mountains_640x480_rgb332_frc2 + 38400, mountains_640x480_rgb332_frc2 + 192000, mountains_640x480_rgb332_frc2 + 39040, mountains_640x480_rgb332_frc2 + 192640,
+    mountains_640x480_rgb332_frc2 + 39680, mountains_640x480_rgb332_frc2 + 193280, mountains_640x480_rgb332_frc2 + 40320, mountains_640x480_rgb332_frc2 + 193920,
+    mountains_640x480_rgb332_frc2 + 40960, mountains_640x480_rgb332_frc2 + 194560, mountains_640x480_rgb332_frc2 + 41600, mountains_640x480_rgb332_frc2 + 195200,
+    mountains_640x480_rgb332_frc2 + 42240, mountains_640x480_rgb332_frc2 + 195840, mountains_640x480_rgb332_frc2 + 42880, mountains_640x480_rgb332_frc2 + 196480,
+    mountains_640x480_rgb332_frc2 + 43520, mountains_640x480_rgb332_frc2 + 197120, mountains_640x480_rgb332_frc2 + 44160, mountains_640x480_rgb332_frc2 + 197760,
+    mountains_640x480_rgb332_frc2 + 44800, mountains_640x480_rgb332_frc2 + 198400, mountains_640x480_rgb332_frc2 + 45440, mountains_640x480_rgb332_frc2 + 199040,
+    mountains_640x480_rgb332_frc2 + 46080, mountains_640x480_rgb332_frc2 + 199680, mountains_640x480_rgb332_frc2 + 46720, mountains_640x480_rgb332_frc2 + 200320,
+    mountains_640x480_rgb332_frc2 + 47360, mountains_640x480_rgb332_frc2 + 200960, mountains_640x480_rgb332_frc2 + 48000, mountains_640x480_rgb332_frc2 + 201600,
+    mountains_640x480_rgb332_frc2 + 48640, mountains_640x480_rgb332_frc2 + 202240, mountains_640x480_rgb332_frc2 + 49280, mountains_640x480_rgb332_frc2 + 202880,
+    mountains_640x480_rgb332_frc2 + 49920, mountains_640x480_rgb332_frc2 + 203520, mountains_640x480_rgb332_frc2 + 50560, mountains_640x480_rgb332_frc2 + 204160,
+    mountains_640x480_rgb332_frc2 + 51200, mountains_640x480_rgb332_frc2 + 204800, mountains_640x480_rgb332_frc2 + 51840, mountains_640x480_rgb332_frc2 + 205440,
+    mountains_640x480_rgb332_frc2 + 52480, mountains_640x480_rgb332_frc2 + 206080, mountains_640x480_rgb332_frc2 + 53120, mountains_640x480_rgb332_frc2 + 206720,
+    mountains_640x480_rgb332_frc2 + 53760, mountains_640x480_rgb332_frc2 + 207360, mountains_640x480_rgb332_frc2 + 54400, mountains_640x480_rgb332_frc2 + 208000,
+    mountains_640x480_rgb332_frc2 + 55040, mountains_640x480_rgb332_frc2 + 208640, mountains_640x480_rgb332_frc2 + 55680, mountains_640x480_rgb332_frc2 + 209280,
+    mountains_640x480_rgb332_frc2 + 56320, mountains_640x480_rgb332_frc2 + 209920, mountains_640x480_rgb332_frc2 + 56960, mountains_640x480_rgb332_frc2 + 210560,
+    mountains_640x480_rgb332_frc2 + 57600, mountains_640x480_rgb332_frc2 + 211200, mountains_640x480_rgb332_frc2 + 58240, mountains_640x480_rgb332_frc2 + 211840,
+    mountains_640x480_rgb332_frc2 + 58880, mountains_640x480_rgb332_frc2 + 212480, mountains_640x480_rgb332_frc2 + 59520, mountains_640x480_rgb332_frc2 + 213120,
+    mountains_640x480_rgb332_frc2 + 60160, mountains_640x480_rgb332_frc2 + 213760, mountains_640x480_rgb332_frc2 + 60800, mountains_640x480_rgb332_frc2 + 214400,
+    mountains_640x480_rgb332_frc2 + 61440, mountains_640x480_rgb332_frc2 + 215040, mountains_640x480_rgb332_frc2 + 62080, mountains_640x480_rgb332_frc2 + 215680,
+    mountains_640x480_rgb332_frc2 + 62720, mountains_640x480_rgb332_frc2 + 216320, mountains_640x480_rgb332_frc2 + 63360, mountains_640x480_rgb332_frc2 + 216960,
+    mountains_640x480_rgb332_frc2 + 64000, mountains_640x480_rgb332_frc2 + 217600, mountains_640x480_rgb332_frc2 + 64640, mountains_640x480_rgb332_frc2 + 218240,
+    mountains_640x480_rgb332_frc2 + 65280, mountains_640x480_rgb332_frc2 + 218880, mountains_640x480_rgb332_frc2 + 65920, mountains_640x480_rgb332_frc2 + 219520,
+    mountains_640x480_rgb332_frc2 + 66560, mountains_640x480_rgb332_frc2 + 220160, mountains_640x480_rgb332_frc2 + 67200, mountains_640x480_rgb332_frc2 + 220800,
+    mountains_640x480_rgb332_frc2 + 67840, mountains_640x480_rgb332_frc2 + 221440, mountains_640x480_rgb332_frc2 + 68480, mountains_640x480_rgb332_frc2 + 222080,
+    mountains_640x480_rgb332_frc2 + 69120, mountains_640x480_rgb332_frc2 + 222720, mountains_640x480_rgb332_frc2 + 69760, mountains_640x480_rgb332_frc2 + 223360,
+    mountains_640x480_rgb332_frc2 + 70400, mountains_640x480_rgb332_frc2 + 224000, mountains_640x480_rgb332_frc2 + 71040, mountains_640x480_rgb332_frc2 + 224640,
+    mountains_640x480_rgb332_frc2 + 71680, mountains_640x480_rgb332_frc2 + 225280, mountains_640x480_rgb332_frc2 + 72320, mountains_640x480_rgb332_frc2 + 225920,
+    mountains_640x480_rgb332_frc2 + 72960, mountains_640x480_rgb332_frc2 + 226560, mountains_640x480_rgb332_frc2 + 73600, mountains_640x480_rgb332_frc2 + 227200,
+    mountains_640x480_rgb332_frc2 + 74240, mountains_640x480_rgb332_frc2 + 227840, mountains_640x480_rgb332_frc2 + 74880, mountains_640x480_rgb332_frc2 + 228480,
+    mountains_640x480_rgb332_frc2 + 75520, mountains_640x480_rgb332_frc2 + 229120, mountains_640x480_rgb332_frc2 + 76160, mountains_640x480_rgb332_frc2 + 229760,
+    mountains_640x480_rgb332_frc2 + 76800, mountains_640x480_rgb332_frc2 + 230400, mountains_640x480_rgb332_frc2 + 77440, mountains_640x480_rgb332_frc2 + 231040,
+    mountains_640x480_rgb332_frc2 + 78080, mountains_640x480_rgb332_frc2 + 231680, mountains_640x480_rgb332_frc2 + 78720, mountains_640x480_rgb332_frc2 + 232320,
+    mountains_640x480_rgb332_frc2 + 79360, mountains_640x480_rgb332_frc2 + 232960, mountains_640x480_rgb332_frc2 + 80000, mountains_640x480_rgb332_frc2 + 233600,
+    mountains_640x480_rgb332_frc2 + 80640, mountains_640x480_rgb332_frc2 + 234240, mountains_640x480_rgb332_frc2 + 81280, mountains_640x480_rgb332_frc2 + 234880,
+    mountains_640x480_rgb332_frc2 + 81920, mountains_640x480_rgb332_frc2 + 235520, mountains_640x480_rgb332_frc2 + 82560, mountains_640x480_rgb332_frc2 + 236160,
+    mountains_640x480_rgb332_frc2 + 83200, mountains_640x480_rgb332_frc2 + 236800, mountains_640x480_rgb332_frc2 + 83840, mountains_640x480_rgb332_frc2 + 237440,
+    mountains_640x480_rgb332_frc2 + 84480, mountains_640x480_rgb332_frc2 + 238080, mountains_640x480_rgb332_frc2 + 85120, mountains_640x480_rgb332_frc2 + 238720,
+    mountains_640x480_rgb332_frc2 + 85760, mountains_640x480_rgb332_frc2 + 239360, mountains_640x480_rgb332_frc2 + 86400, mountains_640x480_rgb332_frc2 + 240000,
+    mountains_640x480_rgb332_frc2 + 87040, mountains_640x480_rgb332_frc2 + 240640, mountains_640x480_rgb332_frc2 + 87680, mountains_640x480_rgb332_frc2 + 241280,
+    mountains_640x480_rgb332_frc2 + 88320, mountains_640x480_rgb332_frc2 + 241920, mountains_640x480_rgb332_frc2 + 88960, mountains_640x480_rgb332_frc2 + 242560,
+    mountains_640x480_rgb332_frc2 + 89600, mountains_640x480_rgb332_frc2 + 243200, mountains_640x480_rgb332_frc2 + 90240, mountains_640x480_rgb332_frc2 + 243840,
+    mountains_640x480_rgb332_frc2 + 90880, mountains_640x480_rgb332_frc2 + 244480, mountains_640x480_rgb332_frc2 + 91520, mountains_640x480_rgb332_frc2 + 245120,
+    mountains_640x480_rgb332_frc2 + 92160, mountains_640x480_rgb332_frc2 + 245760, mountains_640x480_rgb332_frc2 + 92800, mountains_640x480_rgb332_frc2 + 246400,
+    mountains_640x480_rgb332_frc2 + 93440, mountains_640x480_rgb332_frc2 + 247040, mountains_640x480_rgb332_frc2 + 94080, mountains_640x480_rgb332_frc2 + 247680,
+    mountains_640x480_rgb332_frc2 + 94720, mountains_640x480_rgb332_frc2 + 248320, mountains_640x480_rgb332_frc2 + 95360, mountains_640x480_rgb332_frc2 + 248960,
+    mountains_640x480_rgb332_frc2 + 96000, mountains_640x480_rgb332_frc2 + 249600, mountains_640x480_rgb332_frc2 + 96640, mountains_640x480_rgb332_frc2 + 250240,
+    mountains_640x480_rgb332_frc2 + 97280, mountains_640x480_rgb332_frc2 + 250880, mountains_640x480_rgb332_frc2 + 97920, mountains_640x480_rgb332_frc2 + 251520,
+    mountains_640x480_rgb332_frc2 + 98560, mountains_640x480_rgb332_frc2 + 252160, mountains_640x480_rgb332_frc2 + 99200, mountains_640x480_rgb332_frc2 + 252800,
+    mountains_640x480_rgb332_frc2 + 99840, mountains_640x480_rgb332_frc2 + 253440, mountains_640x480_rgb332_frc2 + 100480, mountains_640x480_rgb332_frc2 + 254080,
+    mountains_640x480_rgb332_frc2 + 101120, mountains_640x480_rgb332_frc2 + 254720, mountains_640x480_rgb332_frc2 + 101760, mountains_640x480_rgb332_frc2 + 255360,
+    mountains_640x480_rgb332_frc2 + 102400, mountains_640x480_rgb332_frc2 + 256000, mountains_640x480_rgb332_frc2 + 103040, mountains_640x480_rgb332_frc2 + 256640,
+    mountains_640x480_rgb332_frc2 + 103680, mountains_640x480_rgb332_frc2 + 257280, mountains_640x480_rgb332_frc2 + 104320, mountains_640x480_rgb332_frc2 + 257920,
+    mountains_640x480_rgb332_frc2 + 104960, mountains_640x480_rgb332_frc2 + 258560, mountains_640x480_rgb332_frc2 + 105600, mountains_640x480_rgb332_frc2 + 259200,
+    mountains_640x480_rgb332_frc2 + 106240, mountains_640x480_rgb332_frc2 + 259840, mountains_640x480_rgb332_frc2 + 106880, mountains_640x480_rgb332_frc2 + 260480,
+    mountains_640x480_rgb332_frc2 + 107520, mountains_640x480_rgb332_frc2 + 261120, mountains_640x480_rgb332_frc2 + 108160, mountains_640x480_rgb332_frc2 + 261760,
+    mountains_640x480_rgb332_frc2 + 108800, mountains_640x480_rgb332_frc2 + 262400, mountains_640x480_rgb332_frc2 + 109440, mountains_640x480_rgb332_frc2 + 263040,
+    mountains_640x480_rgb332_frc2 + 110080, mountains_640x480_rgb332_frc2 + 263680, mountains_640x480_rgb332_frc2 + 110720, mountains_640x480_rgb332_frc2 + 264320,
+    mountains_640x480_rgb332_frc2 + 111360, mountains_640x480_rgb332_frc2 + 264960, mountains_640x480_rgb332_frc2 + 112000, mountains_640x480_rgb332_frc2 + 265600,
+    mountains_640x480_rgb332_frc2 + 112640, mountains_640x480_rgb332_frc2 + 266240, mountains_640x480_rgb332_frc2 + 113280, mountains_640x480_rgb332_frc2 + 266880,
+    mountains_640x480_rgb332_frc2 + 113920, mountains_640x480_rgb332_frc2 + 267520, mountains_640x480_rgb332_frc2 + 114560, mountains_640x480_rgb332_frc2 + 268160,
+    mountains_640x480_rgb332_frc2 + 115200, mountains_640x480_rgb332_frc2 + 268800, mountains_640x480_rgb332_frc2 + 115840, mountains_640x480_rgb332_frc2 + 269440,
+    mountains_640x480_rgb332_frc2 + 116480, mountains_640x480_rgb332_frc2 + 270080, mountains_640x480_rgb332_frc2 + 117120, mountains_640x480_rgb332_frc2 + 270720,
+    mountains_640x480_rgb332_frc2 + 117760, mountains_640x480_rgb332_frc2 + 271360, mountains_640x480_rgb332_frc2 + 118400, mountains_640x480_rgb332_frc2 + 272000,
+    mountains_640x480_rgb332_frc2 + 119040, mountains_640x480_rgb332_frc2 + 272640, mountains_640x480_rgb332_frc2 + 119680, mountains_640x480_rgb332_frc2 + 273280,
+    mountains_640x480_rgb332_frc2 + 120320, mountains_640x480_rgb332_frc2 + 273920, mountains_640x480_rgb332_frc2 + 120960, mountains_640x480_rgb332_frc2 + 274560,
+    mountains_640x480_rgb332_frc2 + 121600, mountains_640x480_rgb332_frc2 + 275200, mountains_640x480_rgb332_frc2 + 122240, mountains_640x480_rgb332_frc2 + 275840,
+    mountains_640x480_rgb332_frc2 + 122880, mountains_640x480_rgb332_frc2 + 276480, mountains_640x480_rgb332_frc2 + 123520, mountains_640x480_rgb332_frc2 + 277120,
+    mountains_640x480_rgb332_frc2 + 124160, mountains_640x480_rgb332_frc2 + 277760, mountains_640x480_rgb332_frc2 + 124800, mountains_640x480_rgb332_frc2 + 278400,
+    mountains_640x480_rgb332_frc2 + 125440, mountains_640x480_rgb332_frc2 + 279040, mountains_640x480_rgb332_frc2 + 126080, mountains_640x480_rgb332_frc2 + 279680,
+    mountains_640x480_rgb332_frc2 + 126720, mountains_640x480_rgb332_frc2 + 280320, mountains_640x480_rgb332_frc2 + 127360, mountains_640x480_rgb332_frc2 + 280960,
+    mountains_640x480_rgb332_frc2 + 128000, mountains_640x480_rgb332_frc2 + 281600, mountains_640x480_rgb332_frc2 + 128640, mountains_640x480_rgb332_frc2 + 282240,
+    mountains_640x480_rgb332_frc2 + 129280, mountains_640x480_rgb332_frc2 + 282880, mountains_640x480_rgb332_frc2 + 129920, mountains_640x480_rgb332_frc2 + 283520,
+    mountains_640x480_rgb332_frc2 + 130560, mountains_640x480_rgb332_frc2 + 284160, mountains_640x480_rgb332_frc2 + 131200, mountains_640x480_rgb332_frc2 + 284800,
+    mountains_640x480_rgb332_frc2 + 131840, mountains_640x480_rgb332_frc2 + 285440, mountains_640x480_rgb332_frc2 + 132480, mountains_640x480_rgb332_frc2 + 286080,
+    mountains_640x480_rgb332_frc2 + 133120, mountains_640x480_rgb332_frc2 + 286720, mountains_640x480_rgb332_frc2 + 133760, mountains_640x480_rgb332_frc2 + 287360,
+    mountains_640x480_rgb332_frc2 + 134400, mountains_640x480_rgb332_frc2 + 288000, mountains_640x480_rgb332_frc2 + 135040, mountains_640x480_rgb332_frc2 + 288640,
+    mountains_640x480_rgb332_frc2 + 135680, mountains_640x480_rgb332_frc2 + 289280, mountains_640x480_rgb332_frc2 + 136320, mountains_640x480_rgb332_frc2 + 289920,
+    mountains_640x480_rgb332_frc2 + 136960, mountains_640x480_rgb332_frc2 + 290560, mountains_640x480_rgb332_frc2 + 137600, mountains_640x480_rgb332_frc2 + 291200,
+    mountains_640x480_rgb332_frc2 + 138240, mountains_640x480_rgb332_frc2 + 291840, mountains_640x480_rgb332_frc2 + 138880, mountains_640x480_rgb332_frc2 + 292480,
+    mountains_640x480_rgb332_frc2 + 139520, mountains_640x480_rgb332_frc2 + 293120, mountains_640x480_rgb332_frc2 + 140160, mountains_640x480_rgb332_frc2 + 293760,
+    mountains_640x480_rgb332_frc2 + 140800, mountains_640x480_rgb332_frc2 + 294400, mountains_640x480_rgb332_frc2 + 141440, mountains_640x480_rgb332_frc2 + 295040,
+    mountains_640x480_rgb332_frc2 + 142080, mountains_640x480_rgb332_frc2 + 295680, mountains_640x480_rgb332_frc2 + 142720, mountains_640x480_rgb332_frc2 + 296320,
+    mountains_640x480_rgb332_frc2 + 143360, mountains_640x480_rgb332_frc2 + 296960, mountains_640x480_rgb332_frc2 + 144000, mountains_640x480_rgb332_frc2 + 297600,
+    mountains_640x480_rgb332_frc2 + 144640, mountains_640x480_rgb332_frc2 + 298240, mountains_640x480_rgb332_frc2 + 145280, mountains_640x480_rgb332_frc2 + 298880,
+    mountains_640x480_rgb332_frc2 + 145920, mountains_640x480_rgb332_frc2 + 299520, mountains_640x480_rgb332_frc2 + 146560, mountains_640x480_rgb332_frc2 + 300160,
+    mountains_640x480_rgb332_frc2 + 147200, mountains_640x480_rgb332_frc2 + 300800, mountains_640x480_rgb332_frc2 + 147840, mountains_640x480_rgb332_frc2 + 301440,
+    mountains_640x480_rgb332_frc2 + 148480, mountains_640x480_rgb332_frc2 + 302080, mountains_640x480_rgb332_frc2 + 149120, mountains_640x480_rgb332_frc2 + 302720,
+    mountains_640x480_rgb332_frc2 + 149760, mountains_640x480_rgb332_frc2 + 303360, mountains_640x480_rgb332_frc2 + 150400, mountains_640x480_rgb332_frc2 + 304000,
+    mountains_640x480_rgb332_frc2 + 151040, mountains_640x480_rgb332_frc2 + 304640, mountains_640x480_rgb332_frc2 + 151680, mountains_640x480_rgb332_frc2 + 305280,
+    mountains_640x480_rgb332_frc2 + 152320, mountains_640x480_rgb332_frc2 + 305920, mountains_640x480_rgb332_frc2 + 152960, mountains_640x480_rgb332_frc2 + 306560,
+    mountains_640x480_rgb332_frc2 + 153600, mountains_640x480_rgb332_frc2 + 0, mountains_640x480_rgb332_frc2 + 154240, mountains_640x480_rgb332_frc2 + 640,
+    mountains_640x480_rgb332_frc2 + 154880, mountains_640x480_rgb332_frc2 + 1280, mountains_640x480_rgb332_frc2 + 155520, mountains_640x480_rgb332_frc2 + 1920,
+    mountains_640x480_rgb332_frc2 + 156160, mountains_640x480_rgb332_frc2 + 2560, mountains_640x480_rgb332_frc2 + 156800, mountains_640x480_rgb332_frc2 + 3200,
+    mountains_640x480_rgb332_frc2 + 157440, mountains_640x480_rgb332_frc2 + 3840, mountains_640x480_rgb332_frc2 + 158080, mountains_640x480_rgb332_frc2 + 4480,
+    mountains_640x480_rgb332_frc2 + 158720, mountains_640x480_rgb332_frc2 + 5120, mountains_640x480_rgb332_frc2 + 159360, mountains_640x480_rgb332_frc2 + 5760,
+    mountains_640x480_rgb332_frc2 + 160000, mountains_640x480_rgb332_frc2 + 6400, mountains_640x480_rgb332_frc2 + 160640, mountains_640x480_rgb332_frc2 + 7040,
+    mountains_640x480_rgb332_frc2 + 161280, mountains_640x480_rgb332_frc2 + 7680, mountains_640x480_rgb332_frc2 + 161920, mountains_640x480_rgb332_frc2 + 8320,
+    mountains_640x480_rgb332_frc2 + 162560, mountains_640x480_rgb332_frc2 + 8960, mountains_640x480_rgb332_frc2 + 163200, mountains_640x480_rgb332_frc2 + 9600,
+    mountains_640x480_rgb332_frc2 + 163840, mountains_640x480_rgb332_frc2 + 10240, mountains_640x480_rgb332_frc2 + 164480, mountains_640x480_rgb332_frc2 + 10880,
+    mountains_640x480_rgb332_frc2 + 165120, mountains_640x480_rgb332_frc2 + 11520, mountains_640x480_rgb332_frc2 + 165760, mountains_640x480_rgb332_frc2 + 12160,
+    mountains_640x480_rgb332_frc2 + 166400, mountains_640x480_rgb332_frc2 + 12800, mountains_640x480_rgb332_frc2 + 167040, mountains_640x480_rgb332_frc2 + 13440,
+    mountains_640x480_rgb332_frc2 + 167680, mountains_640x480_rgb332_frc2 + 14080, mountains_640x480_rgb332_frc2 + 168320, mountains_640x480_rgb332_frc2 + 14720,
+    mountains_640x480_rgb332_frc2 + 168960, mountains_640x480_rgb332_frc2 + 15360, mountains_640x480_rgb332_frc2 + 169600, mountains_640x480_rgb332_frc2 + 16000,
+    mountains_640x480_rgb332_frc2 + 170240, mountains_640x480_rgb332_frc2 + 16640, mountains_640x480_rgb332_frc2 + 170880, mountains_640x480_rgb332_frc2 + 17280,
+    mountains_640x480_rgb332_frc2 + 171520, mountains_640x480_rgb332_frc2 + 17920, mountains_640x480_rgb332_frc2 + 172160, mountains_640x480_rgb332_frc2 + 18560,
+    mountains_640x480_rgb332_frc2 + 172800, mountains_640x480_rgb332_frc2 + 19200, mountains_640x480_rgb332_frc2 + 173440, mountains_640x480_rgb332_frc2 + 19840,
+    mountains_640x480_rgb332_frc2 + 174080, mountains_640x480_rgb332_frc2 + 20480, mountains_640x480_rgb332_frc2 + 174720, mountains_640x480_rgb332_frc2 + 21120,
+    mountains_640x480_rgb332_frc2 + 175360, mountains_640x480_rgb332_frc2 + 21760, mountains_640x480_rgb332_frc2 + 176000, mountains_640x480_rgb332_frc2 + 22400,
+    mountains_640x480_rgb332_frc2 + 176640, mountains_640x480_rgb332_frc2 + 23040, mountains_640x480_rgb332_frc2 + 177280, mountains_640x480_rgb332_frc2 + 23680,
+    mountains_640x480_rgb332_frc2 + 177920, mountains_640x480_rgb332_frc2 + 24320, mountains_640x480_rgb332_frc2 + 178560, mountains_640x480_rgb332_frc2 + 24960,
+    mountains_640x480_rgb332_frc2 + 179200, mountains_640x480_rgb332_frc2 + 25600, mountains_640x480_rgb332_frc2 + 179840, mountains_640x480_rgb332_frc2 + 26240,
+    mountains_640x480_rgb332_frc2 + 180480, mountains_640x480_rgb332_frc2 + 26880, mountains_640x480_rgb332_frc2 + 181120, mountains_640x480_rgb332_frc2 + 27520,
+    mountains_640x480_rgb332_frc2 + 181760, mountains_640x480_rgb332_frc2 + 28160, mountains_640x480_rgb332_frc2 + 182400, mountains_640x480_rgb332_frc2 + 28800,
+    mountains_640x480_rgb332_frc2 + 183040, mountains_640x480_rgb332_frc2 + 29440, mountains_640x480_rgb332_frc2 + 183680, mountains_640x480_rgb332_frc2 + 30080,
+    mountains_640x480_rgb332_frc2 + 184320, mountains_640x480_rgb332_frc2 + 30720, mountains_640x480_rgb332_frc2 + 184960, mountains_640x480_rgb332_frc2 + 31360,
+    mountains_640x480_rgb332_frc2 + 185600, mountains_640x480_rgb332_frc2 + 32000, mountains_640x480_rgb332_frc2 + 186240, mountains_640x480_rgb332_frc2 + 32640,
+    mountains_640x480_rgb332_frc2 + 186880, mountains_640x480_rgb332_frc2 + 33280, mountains_640x480_rgb332_frc2 + 187520, mountains_640x480_rgb332_frc2 + 33920,
+    mountains_640x480_rgb332_frc2 + 188160, mountains_640x480_rgb332_frc2 + 34560, mountains_640x480_rgb332_frc2 + 188800, mountains_640x480_rgb332_frc2 + 35200,
+    mountains_640x480_rgb332_frc2 + 189440, mountains_640x480_rgb332_frc2 + 35840, mountains_640x480_rgb332_frc2 + 190080, mountains_640x480_rgb332_frc2 + 36480,
+    mountains_640x480_rgb332_frc2 + 190720, mountains_640x480_rgb332_frc2 + 37120, mountains_640x480_rgb332_frc2 + 191360, mountains_640x480_rgb332_frc2 + 37760,
+    mountains_640x480_rgb332_frc2 + 192000, mountains_640x480_rgb332_frc2 + 38400, mountains_640x480_rgb332_frc2 + 192640, mountains_640x480_rgb332_frc2 + 39040,
+    mountains_640x480_rgb332_frc2 + 193280, mountains_640x480_rgb332_frc2 + 39680, mountains_640x480_rgb332_frc2 + 193920, mountains_640x480_rgb332_frc2 + 40320,
+    mountains_640x480_rgb332_frc2 + 194560, mountains_640x480_rgb332_frc2 + 40960, mountains_640x480_rgb332_frc2 + 195200, mountains_640x480_rgb332_frc2 + 41600,
+    mountains_640x480_rgb332_frc2 + 195840, mountains_640x480_rgb332_frc2 + 42240, mountains_640x480_rgb332_frc2 + 196480, mountains_640x480_rgb332_frc2 + 42880,
+    mountains_640x480_rgb332_frc2 + 197120, mountains_640x480_rgb332_frc2 + 43520, mountains_640x480_rgb332_frc2 + 197760, mountains_640x480_rgb332_frc2 + 44160,
+    mountains_640x480_rgb332_frc2 + 198400, mountains_640x480_rgb332_frc2 + 44800, mountains_640x480_rgb332_frc2 + 199040, mountains_640x480_rgb332_frc2 + 45440,
+    mountains_640x480_rgb332_frc2 + 199680, mountains_640x480_rgb332_frc2 + 46080, mountains_640x480_rgb332_frc2 + 200320, mountains_640x480_rgb332_frc2 + 46720,
+    mountains_640x480_rgb332_frc2 + 200960, mountains_640x480_rgb332_frc2 + 47360, mountains_640x480_rgb332_frc2 + 201600, mountains_640x480_rgb332_frc2 + 48000,
+    mountains_640x480_rgb332_frc2 + 202240, mountains_640x480_rgb332_frc2 + 48640, mountains_640x480_rgb332_frc2 + 202880, mountains_640x480_rgb332_frc2 + 49280,
+    mountains_640x480_rgb332_frc2 + 203520, mountains_640x480_rgb332_frc2 + 49920, mountains_640x480_rgb332_frc2 + 204160, mountains_640x480_rgb332_frc2 + 50560,
+    mountains_640x480_rgb332_frc2 + 204800, mountains_640x480_rgb332_frc2 + 51200, mountains_640x480_rgb332_frc2 + 205440, mountains_640x480_rgb332_frc2 + 51840,
+    mountains_640x480_rgb332_frc2 + 206080, mountains_640x480_rgb332_frc2 + 52480, mountains_640x480_rgb332_frc2 + 206720, mountains_640x480_rgb332_frc2 + 53120,
+    mountains_640x480_rgb332_frc2 + 207360, mountains_640x480_rgb332_frc2 + 53760, mountains_640x480_rgb332_frc2 + 208000, mountains_640x480_rgb332_frc2 + 54400,
+    mountains_640x480_rgb332_frc2 + 208640, mountains_640x480_rgb332_frc2 + 55040, mountains_640x480_rgb332_frc2 + 209280, mountains_640x480_rgb332_frc2 + 55680,
+    mountains_640x480_rgb332_frc2 + 209920, mountains_640x480_rgb332_frc2 + 56320, mountains_640x480_rgb332_frc2 + 210560, mountains_640x480_rgb332_frc2 + 56960,
+    mountains_640x480_rgb332_frc2 + 211200, mountains_640x480_rgb332_frc2 + 57600, mountains_640x480_rgb332_frc2 + 211840, mountains_640x480_rgb332_frc2 + 58240,
+    mountains_640x480_rgb332_frc2 + 212480, mountains_640x480_rgb332_frc2 + 58880, mountains_640x480_rgb332_frc2 + 213120, mountains_640x480_rgb332_frc2 + 59520,
+    mountains_640x480_rgb332_frc2 + 213760, mountains_640x480_rgb332_frc2 + 60160, mountains_640x480_rgb332_frc2 + 214400, mountains_640x480_rgb332_frc2 + 60800,
+    mountains_640x480_rgb332_frc2 + 215040, mountains_640x480_rgb332_frc2 + 61440, mountains_640x480_rgb332_frc2 + 215680, mountains_640x480_rgb332_frc2 + 62080,
+    mountains_640x480_rgb332_frc2 + 216320, mountains_640x480_rgb332_frc2 + 62720, mountains_640x480_rgb332_frc2 + 216960, mountains_640x480_rgb332_frc2 + 63360,
+    mountains_640x480_rgb332_frc2 + 217600, mountains_640x480_rgb332_frc2 + 64000, mountains_640x480_rgb332_frc2 + 218240, mountains_640x480_rgb332_frc2 + 64640,
+    mountains_640x480_rgb332_frc2 + 218880, mountains_640x480_rgb332_frc2 + 65280, mountains_640x480_rgb332_frc2 + 219520, mountains_640x480_rgb332_frc2 + 65920,
+    mountains_640x480_rgb332_frc2 + 220160, mountains_640x480_rgb332_frc2 + 66560, mountains_640x480_rgb332_frc2 + 220800, mountains_640x480_rgb332_frc2 + 67200,
+    mountains_640x480_rgb332_frc2 + 221440, mountains_640x480_rgb332_frc2 + 67840, mountains_640x480_rgb332_frc2 + 222080, mountains_640x480_rgb332_frc2 + 68480,
+    mountains_640x480_rgb332_frc2 + 222720, mountains_640x480_rgb332_frc2 + 69120, mountains_640x480_rgb332_frc2 + 223360, mountains_640x480_rgb332_frc2 + 69760,
+    mountains_640x480_rgb332_frc2 + 224000, mountains_640x480_rgb332_frc2 + 70400, mountains_640x480_rgb332_frc2 + 224640, mountains_640x480_rgb332_frc2 + 71040,
+    mountains_640x480_rgb332_frc2 + 225280, mountains_640x480_rgb332_frc2 + 71680, mountains_640x480_rgb332_frc2 + 225920, mountains_640x480_rgb332_frc2 + 72320,
+    mountains_640x480_rgb332_frc2 + 226560, mountains_640x480_rgb332_frc2 + 72960, mountains_640x480_rgb332_frc2 + 227200, mountains_640x480_rgb332_frc2 + 73600,
+    mountains_640x480_rgb332_frc2 + 227840, mountains_640x480_rgb332_frc2 + 74240, mountains_640x480_rgb332_frc2 + 228480, mountains_640x480_rgb332_frc2 + 74880,
+    mountains_640x480_rgb332_frc2 + 229120, mountains_640x480_rgb332_frc2 + 75520, mountains_640x480_rgb332_frc2 + 229760, mountains_640x480_rgb332_frc2 + 76160,
+    mountains_640x480_rgb332_frc2 + 230400, mountains_640x480_rgb332_frc2 + 76800, mountains_640x480_rgb332_frc2 + 231040, mountains_640x480_rgb332_frc2 + 77440,
+    mountains_640x480_rgb332_frc2 + 231680, mountains_640x480_rgb332_frc2 + 78080, mountains_640x480_rgb332_frc2 + 232320, mountains_640x480_rgb332_frc2 + 78720,
+    mountains_640x480_rgb332_frc2 + 232960, mountains_640x480_rgb332_frc2 + 79360, mountains_640x480_rgb332_frc2 + 233600, mountains_640x480_rgb332_frc2 + 80000,
+    mountains_640x480_rgb332_frc2 + 234240, mountains_640x480_rgb332_frc2 + 80640, mountains_640x480_rgb332_frc2 + 234880, mountains_640x480_rgb332_frc2 + 81280,
+    mountains_640x480_rgb332_frc2 + 235520, mountains_640x480_rgb332_frc2 + 81920, mountains_640x480_rgb332_frc2 + 236160, mountains_640x480_rgb332_frc2 + 82560,
+    mountains_640x480_rgb332_frc2 + 236800, mountains_640x480_rgb332_frc2 + 83200, mountains_640x480_rgb332_frc2 + 237440, mountains_640x480_rgb332_frc2 + 83840,
+    mountains_640x480_rgb332_frc2 + 238080, mountains_640x480_rgb332_frc2 + 84480, mountains_640x480_rgb332_frc2 + 238720, mountains_640x480_rgb332_frc2 + 85120,
+    mountains_640x480_rgb332_frc2 + 239360, mountains_640x480_rgb332_frc2 + 85760, mountains_640x480_rgb332_frc2 + 240000, mountains_640x480_rgb332_frc2 + 86400,
+    mountains_640x480_rgb332_frc2 + 240640, mountains_640x480_rgb332_frc2 + 87040, mountains_640x480_rgb332_frc2 + 241280, mountains_640x480_rgb332_frc2 + 87680,
+    mountains_640x480_rgb332_frc2 + 241920, mountains_640x480_rgb332_frc2 + 88320, mountains_640x480_rgb332_frc2 + 242560, mountains_640x480_rgb332_frc2 + 88960,
+    mountains_640x480_rgb332_frc2 + 243200, mountains_640x480_rgb332_frc2 + 89600, mountains_640x480_rgb332_frc2 + 243840, mountains_640x480_rgb332_frc2 + 90240,
+    mountains_640x480_rgb332_frc2 + 244480, mountains_640x480_rgb332_frc2 + 90880, mountains_640x480_rgb332_frc2 + 245120, mountains_640x480_rgb332_frc2 + 91520,
+    mountains_640x480_rgb332_frc2 + 245760, mountains_640x480_rgb332_frc2 + 92160, mountains_640x480_rgb332_frc2 + 246400, mountains_640x480_rgb332_frc2 + 92800,
+    mountains_640x480_rgb332_frc2 + 247040, mountains_640x480_rgb332_frc2 + 93440, mountains_640x480_rgb332_frc2 + 247680, mountains_640x480_rgb332_frc2 + 94080,
+    mountains_640x480_rgb332_frc2 + 248320, mountains_640x480_rgb332_frc2 + 94720, mountains_640x480_rgb332_frc2 + 248960, mountains_640x480_rgb332_frc2 + 95360,
+    mountains_640x480_rgb332_frc2 + 249600, mountains_640x480_rgb332_frc2 + 96000, mountains_640x480_rgb332_frc2 + 250240, mountains_640x480_rgb332_frc2 + 96640,
+    mountains_640x480_rgb332_frc2 + 250880, mountains_640x480_rgb332_frc2 + 97280, mountains_640x480_rgb332_frc2 + 251520, mountains_640x480_rgb332_frc2 + 97920,
+    mountains_640x480_rgb332_frc2 + 252160, mountains_640x480_rgb332_frc2 + 98560, mountains_640x480_rgb332_frc2 + 252800, mountains_640x480_rgb332_frc2 + 99200,
+    mountains_640x480_rgb332_frc2 + 253440, mountains_640x480_rgb332_frc2 + 99840, mountains_640x480_rgb332_frc2 + 254080, mountains_640x480_rgb332_frc2 + 100480,
+    mountains_640x480_rgb332_frc2 + 254720, mountains_640x480_rgb332_frc2 + 101120, mountains_640x480_rgb332_frc2 + 255360, mountains_640x480_rgb332_frc2 + 101760,
+    mountains_640x480_rgb332_frc2 + 256000, mountains_640x480_rgb332_frc2 + 102400, mountains_640x480_rgb332_frc2 + 256640, mountains_640x480_rgb332_frc2 + 103040,
+    mountains_640x480_rgb332_frc2 + 257280, mountains_640x480_rgb332_frc2 + 103680, mountains_640x480_rgb332_frc2 + 257920, mountains_640x480_rgb332_frc2 + 104320,
+    mountains_640x480_rgb332_frc2 + 258560, mountains_640x480_rgb332_frc2 + 104960, mountains_640x480_rgb332_frc2 + 259200, mountains_640x480_rgb332_frc2 + 105600,
+    mountains_640x480_rgb332_frc2 + 259840, mountains_640x480_rgb332_frc2 + 106240, mountains_640x480_rgb332_frc2 + 260480, mountains_640x480_rgb332_frc2 + 106880,
+    mountains_640x480_rgb332_frc2 + 261120, mountains_640x480_rgb332_frc2 + 107520, mountains_640x480_rgb332_frc2 + 261760, mountains_640x480_rgb332_frc2 + 108160,
+    mountains_640x480_rgb332_frc2 + 262400, mountains_640x480_rgb332_frc2 + 108800, mountains_640x480_rgb332_frc2 + 263040, mountains_640x480_rgb332_frc2 + 109440,
+    mountains_640x480_rgb332_frc2 + 263680, mountains_640x480_rgb332_frc2 + 110080, mountains_640x480_rgb332_frc2 + 264320, mountains_640x480_rgb332_frc2 + 110720,
+    mountains_640x480_rgb332_frc2 + 264960, mountains_640x480_rgb332_frc2 + 111360, mountains_640x480_rgb332_frc2 + 265600, mountains_640x480_rgb332_frc2 + 112000,
+    mountains_640x480_rgb332_frc2 + 266240, mountains_640x480_rgb332_frc2 + 112640, mountains_640x480_rgb332_frc2 + 266880, mountains_640x480_rgb332_frc2 + 113280,
+    mountains_640x480_rgb332_frc2 + 267520, mountains_640x480_rgb332_frc2 + 113920, mountains_640x480_rgb332_frc2 + 268160, mountains_640x480_rgb332_frc2 + 114560,
+    mountains_640x480_rgb332_frc2 + 268800, mountains_640x480_rgb332_frc2 + 115200, mountains_640x480_rgb332_frc2 + 269440, mountains_640x480_rgb332_frc2 + 115840,
+    mountains_640x480_rgb332_frc2 + 270080, mountains_640x480_rgb332_frc2 + 116480, mountains_640x480_rgb332_frc2 + 270720, mountains_640x480_rgb332_frc2 + 117120,
+    mountains_640x480_rgb332_frc2 + 271360, mountains_640x480_rgb332_frc2 + 117760, mountains_640x480_rgb332_frc2 + 272000, mountains_640x480_rgb332_frc2 + 118400,
+    mountains_640x480_rgb332_frc2 + 272640, mountains_640x480_rgb332_frc2 + 119040, mountains_640x480_rgb332_frc2 + 273280, mountains_640x480_rgb332_frc2 + 119680,
+    mountains_640x480_rgb332_frc2 + 273920, mountains_640x480_rgb332_frc2 + 120320, mountains_640x480_rgb332_frc2 + 274560, mountains_640x480_rgb332_frc2 + 120960,
+    mountains_640x480_rgb332_frc2 + 275200, mountains_640x480_rgb332_frc2 + 121600, mountains_640x480_rgb332_frc2 + 275840, mountains_640x480_rgb332_frc2 + 122240,
+    mountains_640x480_rgb332_frc2 + 276480, mountains_640x480_rgb332_frc2 + 122880, mountains_640x480_rgb332_frc2 + 277120, mountains_640x480_rgb332_frc2 + 123520,
+    mountains_640x480_rgb332_frc2 + 277760, mountains_640x480_rgb332_frc2 + 124160, mountains_640x480_rgb332_frc2 + 278400, mountains_640x480_rgb332_frc2 + 124800,
+    mountains_640x480_rgb332_frc2 + 279040, mountains_640x480_rgb332_frc2 + 125440, mountains_640x480_rgb332_frc2 + 279680, mountains_640x480_rgb332_frc2 + 126080,
+    mountains_640x480_rgb332_frc2 + 280320, mountains_640x480_rgb332_frc2 + 126720, mountains_640x480_rgb332_frc2 + 280960, mountains_640x480_rgb332_frc2 + 127360,
+    mountains_640x480_rgb332_frc2 + 281600, mountains_640x480_rgb332_frc2 + 128000, mountains_640x480_rgb332_frc2 + 282240, mountains_640x480_rgb332_frc2 + 128640,
+    mountains_640x480_rgb332_frc2 + 282880, mountains_640x480_rgb332_frc2 + 129280, mountains_640x480_rgb332_frc2 + 283520, mountains_640x480_rgb332_frc2 + 129920,
+    mountains_640x480_rgb332_frc2 + 284160, mountains_640x480_rgb332_frc2 + 130560, mountains_640x480_rgb332_frc2 + 284800, mountains_640x480_rgb332_frc2 + 131200,
+    mountains_640x480_rgb332_frc2 + 285440, mountains_640x480_rgb332_frc2 + 131840, mountains_640x480_rgb332_frc2 + 286080, mountains_640x480_rgb332_frc2 + 132480,
+    mountains_640x480_rgb332_frc2 + 286720, mountains_640x480_rgb332_frc2 + 133120, mountains_640x480_rgb332_frc2 + 287360, mountains_640x480_rgb332_frc2 + 133760,
+    mountains_640x480_rgb332_frc2 + 288000, mountains_640x480_rgb332_frc2 + 134400, mountains_640x480_rgb332_frc2 + 288640, mountains_640x480_rgb332_frc2 + 135040,
+    mountains_640x480_rgb332_frc2 + 289280, mountains_640x480_rgb332_frc2 + 135680, mountains_640x480_rgb332_frc2 + 289920, mountains_640x480_rgb332_frc2 + 136320,
+    mountains_640x480_rgb332_frc2 + 290560, mountains_640x480_rgb332_frc2 + 136960, mountains_640x480_rgb332_frc2 + 291200, mountains_640x480_rgb332_frc2 + 137600,
+    mountains_640x480_rgb332_frc2 + 291840, mountains_640x480_rgb332_frc2 + 138240, mountains_640x480_rgb332_frc2 + 292480, mountains_640x480_rgb332_frc2 + 138880,
+    mountains_640x480_rgb332_frc2 + 293120, mountains_640x480_rgb332_frc2 + 139520, mountains_640x480_rgb332_frc2 + 293760, mountains_640x480_rgb332_frc2 + 140160,
+    mountains_640x480_rgb332_frc2 + 294400, mountains_640x480_rgb332_frc2 + 140800, mountains_640x480_rgb332_frc2 + 295040, mountains_640x480_rgb332_frc2 + 141440,
+    mountains_640x480_rgb332_frc2 + 295680, mountains_640x480_rgb332_frc2 + 142080, mountains_640x480_rgb332_frc2 + 296320, mountains_640x480_rgb332_frc2 + 142720,
+    mountains_640x480_rgb332_frc2 + 296960, mountains_640x480_rgb332_frc2 + 143360, mountains_640x480_rgb332_frc2 + 297600, mountains_640x480_rgb332_frc2 + 144000,
+    mountains_640x480_rgb332_frc2 + 298240, mountains_640x480_rgb332_frc2 + 144640, mountains_640x480_rgb332_frc2 + 298880, mountains_640x480_rgb332_frc2 + 145280,
+    mountains_640x480_rgb332_frc2 + 299520, mountains_640x480_rgb332_frc2 + 145920, mountains_640x480_rgb332_frc2 + 300160, mountains_640x480_rgb332_frc2 + 146560,
+    mountains_640x480_rgb332_frc2 + 300800, mountains_640x480_rgb332_frc2 + 147200, mountains_640x480_rgb332_frc2 + 301440, mountains_640x480_rgb332_frc2 + 147840,
+    mountains_640x480_rgb332_frc2 + 302080, mountains_640x480_rgb332_frc2 + 148480, mountains_640x480_rgb332_frc2 + 302720, mountains_640x480_rgb332_frc2 + 149120,
+    mountains_640x480_rgb332_frc2 + 303360, mountains_640x480_rgb332_frc2 + 149760, mountains_640x480_rgb332_frc2 + 304000, mountains_640x480_rgb332_frc2 + 150400,
+    mountains_640x480_rgb332_frc2 + 304640, mountains_640x480_rgb332_frc2 + 151040, mountains_640x480_rgb332_frc2 + 305280, mountains_640x480_rgb332_frc2 + 151680,
+    mountains_640x480_rgb332_frc2 + 305920, mountains_640x480_rgb332_frc2 + 152320, mountains_640x480_rgb332_frc2 + 306560, mountains_640x480_rgb332_frc2 + 152960,
+};
+
+#endif
@@ -0,0 +1,535 @@
+// Asset hot-reload over the UART, see reload.h.
+
+#include "reload.h"
+#include <string.h>
+
+enum
+{
+    RX_MAGIC0,
+    RX_MAGIC1,
+    RX_TYPE,
+    RX_LENGTH,
+    RX_PAYLOAD,
+    RX_CRC,
+};
+
+// CRC-32 (reflected 0x04C11DB7) a nibble at a time, to keep the table small.
+static uint32_t crc32_byte(uint32_t crc, uint8_t byte)
+{
+    static const uint32_t table[16] = {
+        0x00000000, 0x1db71064, 0x3b6e20c8, 0x26d930ac, 0x76dc4190, 0x6b6b51f4, 0x4db26158, 0x5005713c,
+        0xedb88320, 0xf00f9344, 0xd6d6a3e8, 0xcb61b38c, 0x9b64c2b0, 0x86d3d2d4, 0xa00ae278, 0xbdbdf21c,
+    };
+    crc ^= byte;
+    crc = (crc >> 4) ^ table[crc & 15];
+    return (crc >> 4) ^ table[crc & 15];
+}
+
+uint32_t reload_crc32(uint32_t crc, const void *data, size_t n)
+{
+    const uint8_t *p = (const uint8_t *)data;
+    crc = ~crc;
+    while (n--)
+        crc = crc32_byte(crc, *p++);
+    return ~crc;
+}
+
+void reload_rx_init(reload_rx_t *rx)
+{
+    memset(rx, 0, sizeof(*rx));
+}
+
+bool reload_rx_busy(const reload_rx_t *rx)
+{
+    return rx->state != RX_MAGIC0;
+}
+
+reload_rx_event_t reload_rx_feed(reload_rx_t *rx, uint8_t byte)
+{
+    switch (rx->state)
+    {
+    case RX_MAGIC0:
+        if (byte != RELOAD_MAGIC0)
+            return RELOAD_RX_IDLE;
+        rx->state = RX_MAGIC1;
+        return RELOAD_RX_BUSY;
+    case RX_MAGIC1:
+        rx->state = byte == RELOAD_MAGIC1 ? RX_TYPE : RX_MAGIC0;
+        return RELOAD_RX_BUSY;
+    case RX_TYPE:
+        rx->type = byte;
+        rx->crc = crc32_byte(0xffffffff, byte);
+        rx->length = 0;
+        rx->received = 0;
+        rx->state = RX_LENGTH;
+        return RELOAD_RX_BUSY;
+    case RX_LENGTH:
+        rx->crc = crc32_byte(rx->crc, byte);
+        rx->length |= (uint32_t)byte << (8 * rx->received);
+        if (++rx->received < 4)
+            return RELOAD_RX_BUSY;
+        rx->buf = NULL;
+        rx->received = 0;
+        rx->state = rx->length ? RX_PAYLOAD : RX_CRC;
+        return RELOAD_RX_HEADER;
+    case RX_PAYLOAD:
+        rx->crc = crc32_byte(rx->crc, byte);
+        if (rx->buf)
+            rx->buf[rx->received] = byte;
+        if (++rx->received == rx->length)
+        {
+            rx->received = 0;
+            rx->state = RX_CRC;
+        }
+        return RELOAD_RX_BUSY;
+    default:
+        // The sent CRC is the complement of the register, so XORing it in
+        // leaves all ones if they match.
+        rx->crc ^= (uint32_t)byte << (8 * rx->received);
+        if (++rx->received < 4)
+            return RELOAD_RX_BUSY;
+        rx->state = RX_MAGIC0;
+        if (rx->crc != 0xffffffff)
+            return RELOAD_RX_BAD_CRC;
+        return rx->buf || !rx->length ? RELOAD_RX_DONE : RELOAD_RX_DROPPED;
+    }
+}
+
+bool reload_image(const uint8_t *payload, uint32_t length, asset_image_t *image)
+{
+    reload_image_header_t h;
+    if (length < sizeof(h))
+        return false;
+    memcpy(&h, payload, sizeof(h));
+    uint32_t palette_bytes = (h.palette_size * 2u + 3) & ~3u;
+    unsigned bpp = h.format == ASSET_FORMAT_RGB565 ? 2 : 1;
+    if (h.format >= ASSET_FORMAT_PAL4 || h.pack > ASSET_PACK_QOI || !h.width || !h.height ||
+        h.stride % 4 || h.stride < (uint32_t)h.width * bpp || h.palette_size > 256 ||
+        (h.format == ASSET_FORMAT_PAL8) != (h.palette_size != 0) ||
+        (uint64_t)sizeof(h) + palette_bytes + h.size != length ||
+        (h.pack == ASSET_PACK_NONE && (uint64_t)h.stride * h.height > h.size))
+        return false;
+    image->palette = h.palette_size ? (const uint16_t *)(payload + sizeof(h)) : NULL;
+    image->palette_size = h.palette_size;
+    image->data = payload + sizeof(h) + palette_bytes;
+    image->size = h.size;
+    image->width = h.width;
+    image->height = h.height;
+    image->stride = h.stride;
+    image->format = h.format;
+    image->pack = h.pack;
+    return true;
+}
+
+// Called with the number of bytes about to be written to the image, at
+// most a line at a time, so the device can spread an update over several
+// blanking periods.
+typedef void (*reload_pace_t)(uint32_t bytes);
+
+// Run the RELOAD_RECT_XOR stream src over the rectangle's lines, each
+// line_bytes long from dst, line stride bytes apart. Only checks that the
+// stream covers them exactly when dst is NULL.
+static bool xor_rect(const uint8_t *src, uint32_t size, uint8_t *dst, uint32_t stride, uint32_t line_bytes,
+                     uint32_t lines, reload_pace_t pace)
+{
+    const uint8_t *end = src + size;
+    uint32_t total = line_bytes * lines;
+    uint32_t pos = 0;
+    while (pos < total)
+    {
+        if (src >= end)
+            return false;
+        unsigned c = *src++;
+        uint32_t n = c < 128 ? c + 1 : c - 126;
+        if (n > total - pos || (c < 128 ? n : 1) > (uint32_t)(end - src))
+            return false;
+        if (!dst)
+        {
+            src += c < 128 ? n : 1;
+            pos += n;
+            continue;
+        }
+        const uint8_t value = *src;
+        while (n)
+        {
+            uint32_t x = pos % line_bytes;
+            uint32_t k = line_bytes - x < n ? line_bytes - x : n;
+            uint8_t *out = dst + pos / line_bytes * stride + x;
+            if (pace)
+                pace(k);
+            if (c < 128)
+            {
+                for (uint32_t i = 0; i < k; ++i)
+                    out[i] ^= src[i];
+                src += k;
+            }
+            else if (value)
+            {
+                for (uint32_t i = 0; i < k; ++i)
+                    out[i] ^= value;
+            }
+            pos += k;
+            n -= k;
+        }
+        if (c >= 128)
+            ++src;
+    }
+    return src == end;
+}
+
+// Walk the records of an update, checking them, and apply them if apply,
+// pacing the writes through pace if not NULL.
+static bool update_rects(const uint8_t *payload, uint32_t length, uint8_t *pixels, uint32_t stride,
+                         unsigned width, unsigned height, unsigned bpp, bool apply, reload_pace_t pace)
+{
+    uint32_t at = 0;
+    while (at < length)
+    {
+        reload_rect_t r;
+        if (length - at < sizeof(r))
+            return false;
+        memcpy(&r, payload + at, sizeof(r));
+        at += sizeof(r);
+        uint32_t line_bytes = (uint32_t)r.width * bpp;
+        if (r.size > length - at || (uint32_t)r.x + r.width > width || (uint32_t)r.y + r.height > height)
+            return false;
+        const uint8_t *src = payload + at;
+        uint8_t *dst = pixels + r.y * stride + r.x * bpp;
+        at += r.size;
+        switch (r.kind)
+        {
+        case RELOAD_RECT_RAW:
+            if (r.size != line_bytes * r.height)
+                return false;
+            for (unsigned y = 0; apply && y < r.height; ++y)
+            {
+                if (pace)
+                    pace(line_bytes);
+                memcpy(dst + y * stride, src + y * line_bytes, line_bytes);
+            }
+            break;
+        case RELOAD_RECT_XOR:
+            if (!xor_rect(src, r.size, apply ? dst : NULL, stride, line_bytes, r.height, pace))
+                return false;
+            break;
+        default:
+            return false;
+        }
+    }
+    return true;
+}
+
+bool reload_update(const uint8_t *payload, uint32_t length, uint8_t *pixels, uint32_t stride, unsigned width,
+                   unsigned height, unsigned bytes_per_pixel)
+{
+    if (!update_rects(payload, length, pixels, stride, width, height, bytes_per_pixel, false, NULL))
+        return false;
+    return update_rects(payload, length, pixels, stride, width, height, bytes_per_pixel, true, NULL);
+}
+
+#ifndef RELOAD_HOST
+#include "pico/stdlib.h"
+
+#ifndef RELOAD_RAM_SIZE
+#define RELOAD_RAM_SIZE (384 * 1024)
+#endif
+// Bytes of an update written per vertical blanking period. 640x480 has 45
+// blank lines, 1.4 ms; at a few cycles a byte this takes well under that,
+// so the writes are done before active scanout resumes and no line is
+// shown half written. Larger updates continue at the next vblank.
+#ifndef RELOAD_VBLANK_BYTES
+#define RELOAD_VBLANK_BYTES 8192
+#endif
+// A frame that stops arriving for this long is abandoned.
+#ifndef RELOAD_FRAME_TIMEOUT_US
+#define RELOAD_FRAME_TIMEOUT_US 500000
+#endif
+
+// The shown image, and the payload it came in, occupy [shown_lo, shown_hi)
+// at one end of reload_ram, and the next one is received at the other.
+static uint8_t __attribute__((aligned(4))) reload_ram[RELOAD_RAM_SIZE];
+static uint32_t shown_lo, shown_hi;
+static asset_image_t shown; // unpacked, in reload_ram; width 0 if none
+static reload_rx_t rx;
+static bool rx_at_low; // the payload being received starts at reload_ram[0]
+
+static dvi_format_t fallback_format;
+static dvi_scanline_cb_t fallback_cb;
+static void *fallback_user;
+
+// Sources are latched at a vblank; after two, the old one is surely unused.
+static void wait_latched(void)
+{
+    dvi_wait_vblank();
+    dvi_wait_vblank();
+}
+
+static void show_fallback(void)
+{
+    if (shown_lo == shown_hi)
+        return;
+    dvi_set_scanline_callback(fallback_format, fallback_cb, fallback_user);
+    wait_latched();
+    shown_lo = shown_hi = 0;
+    shown.width = 0;
+}
+
+void reload_init(dvi_format_t format, dvi_scanline_cb_t fallback, void *user)
+{
+    fallback_format = format;
+    fallback_cb = fallback;
+    fallback_user = user;
+    reload_rx_init(&rx);
+    shown_lo = shown_hi = 0;
+    shown.width = 0;
+    dvi_set_scanline_callback(format, fallback, user);
+}
+
+static void reply(uint8_t type, reload_status_t status)
+{
+    stdio_putchar_raw(RELOAD_REPLY0);
+    stdio_putchar_raw(RELOAD_REPLY1);
+    stdio_putchar_raw(type);
+    stdio_putchar_raw(status);
+}
+
+// Bytes free below and above the shown image.
+static uint32_t free_low(void)
+{
+    return shown_lo == shown_hi ? RELOAD_RAM_SIZE : shown_lo;
+}
+
+static uint32_t free_high(void)
+{
+    return shown_lo == shown_hi ? RELOAD_RAM_SIZE : RELOAD_RAM_SIZE - shown_hi;
+}
+
+static void place_payload(void)
+{
+    uint32_t n = (rx.length + 3) & ~3u;
+    if ((rx.type != RELOAD_IMAGE && rx.type != RELOAD_UPDATE) || n > RELOAD_RAM_SIZE)
+        return;
+    // Updates need the image on show, so they must fit beside it.
+    if (n > free_low() && n > free_high())
+    {
+        if (rx.type == RELOAD_UPDATE)
+            return;
+        show_fallback();
+    }
+    rx_at_low = free_low() >= free_high();
+    rx.buf = rx_at_low ? reload_ram : reload_ram + RELOAD_RAM_SIZE - n;
+}
+
+static reload_status_t show_image(void)
+{
+    asset_image_t img;
+    // The scanout reads whole display lines from each line of the image.
+    if (!reload_image(rx.buf, rx.length, &img) || img.width != dvi_get_mode()->h_active_pixels)
+        return RELOAD_ERR_IMAGE;
+    uint32_t n = (rx.length + 3) & ~3u;
+    uint32_t lo = rx_at_low ? 0 : RELOAD_RAM_SIZE - n;
+    uint32_t hi = lo + n;
+    if (img.pack != ASSET_PACK_NONE)
+    {
+        // Unpack next to the payload, further from the arena end.
+        uint32_t bytes = img.stride * img.height;
+        if (bytes > (rx_at_low ? free_low() : free_high()) - n)
+        {
+            show_fallback();
+            if (bytes > RELOAD_RAM_SIZE - n)
+                return RELOAD_ERR_SIZE;
+        }
+        uint8_t *dst = rx_at_low ? reload_ram + n : reload_ram + lo - bytes;
+        if (!asset_unpack(&img, dst))
+            return RELOAD_ERR_IMAGE;
+        img.data = dst;
+        if (rx_at_low)
+            hi += bytes;
+        else
+            lo -= bytes;
+    }
+    // asset_format_t matches dvi_format_t for the formats reload_image()
+    // accepts.
+    dvi_set_framebuffer(&(dvi_framebuffer_t){
+        .pixels = img.data,
+        .format = (dvi_format_t)img.format,
+        .lines = img.height,
+        .stride = img.stride,
+        .flags = DVI_FB_STAGED,
+        .palette = img.palette,
+        .palette_size = img.palette_size,
+    });
+    wait_latched();
+    shown_lo = lo;
+    shown_hi = hi;
+    shown = img;
+    return RELOAD_OK;
+}
+
+// Bytes left to write in this vertical blanking period.
+static uint32_t vblank_budget;
+
+// Write only at the start of vertical blanking, RELOAD_VBLANK_BYTES at a
+// time, so scanout never meets a line being written.
+static void pace_vblank(uint32_t bytes)
+{
+    if (bytes > vblank_budget)
+    {
+        dvi_wait_vblank();
+        vblank_budget = RELOAD_VBLANK_BYTES;
+    }
+    vblank_budget = bytes < vblank_budget ? vblank_budget - bytes : 0;
+}
+
+static reload_status_t apply_update(void)
+{
+    if (!shown.width)
+        return RELOAD_ERR_IMAGE;
+    // shown.data is in reload_ram.
+    uint8_t *pixels = (uint8_t *)shown.data;
+    unsigned bpp = shown.format == ASSET_FORMAT_RGB565 ? 2 : 1;
+    if (!update_rects(rx.buf, rx.length, pixels, shown.stride, shown.width, shown.height, bpp, false, NULL))
+        return RELOAD_ERR_IMAGE;
+    // The first write waits for the next vblank.
+    vblank_budget = 0;
+    update_rects(rx.buf, rx.length, pixels, shown.stride, shown.width, shown.height, bpp, true, pace_vblank);
+    return RELOAD_OK;
+}
+
+int reload_poll(uint32_t timeout_us)
+{
+    while (1)
+    {
+        int c = stdio_getchar_timeout_us(reload_rx_busy(&rx) ? RELOAD_FRAME_TIMEOUT_US : timeout_us);
+        if (c < 0)
+        {
+            if (reload_rx_busy(&rx))
+            {
+                reply(rx.type, RELOAD_ERR_TIMEOUT);
+                reload_rx_init(&rx);
+            }
+            return -1;
+        }
+        switch (reload_rx_feed(&rx, (uint8_t)c))
+        {
+        case RELOAD_RX_IDLE:
+            return c;
+        case RELOAD_RX_HEADER:
+            place_payload();
+            break;
+        case RELOAD_RX_DONE:
+            reply(rx.type, rx.type == RELOAD_PING     ? RELOAD_OK
+                           : rx.type == RELOAD_IMAGE  ? show_image()
+                           : rx.type == RELOAD_UPDATE ? apply_update()
+                                                      : RELOAD_ERR_TYPE);
+            break;
+        case RELOAD_RX_BAD_CRC:
+            reply(rx.type, RELOAD_ERR_CRC);
+            break;
+        case RELOAD_RX_DROPPED:
+            reply(rx.type, rx.type == RELOAD_IMAGE || rx.type == RELOAD_UPDATE ? RELOAD_ERR_SIZE
+                                                                               : RELOAD_ERR_TYPE);
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+#else
+#include "capture.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+static bool write_image(const char *path, const asset_image_t *img, const uint8_t *pixels)
+{
+    FILE *f = fopen(path, "wb");
+    bool ok = f && fwrite(pixels, img->stride, img->height, f) == img->height;
+    if (f)
+        fclose(f);
+    return ok;
+}
+
+// Loopback device for tools/reload.py, tools/remote.py and tools/capture.py:
+// frames on stdin, replies on stdout. The image on show is written unpacked
+// to the file named by the argument when it arrives and at the end of the
+// input, and captured (capture.h) when 's' arrives outside a frame.
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+        return 2;
+    reload_rx_t rx;
+    reload_rx_init(&rx);
+    uint8_t *payload = NULL;
+    uint8_t *pixels = NULL;
+    asset_image_t shown = {0};
+    uint16_t palette[256]; // the payload holding shown's goes with the next frame
+    int c;
+    while ((c = getchar()) != EOF)
+    {
+        reload_rx_event_t ev = reload_rx_feed(&rx, (uint8_t)c);
+        reload_status_t status = RELOAD_OK;
+        if (ev == RELOAD_RX_IDLE && c == 's')
+        {
+            capture_source_t src = {
+                .width = shown.width,
+                .height = shown.height,
+                .format = shown.format,
+                .pixels = pixels,
+                .stride = shown.stride,
+                .lines = shown.height,
+                .palette = palette,
+                .palette_size = shown.palette_size,
+            };
+            capture_frames(pixels ? &src : NULL, NULL);
+            continue;
+        }
+        if (ev == RELOAD_RX_HEADER)
+        {
+            free(payload);
+            payload = rx.buf = malloc(rx.length + 4);
+            continue;
+        }
+        if (ev == RELOAD_RX_BAD_CRC)
+            status = RELOAD_ERR_CRC;
+        else if (ev == RELOAD_RX_DROPPED)
+            status = RELOAD_ERR_SIZE;
+        else if (ev != RELOAD_RX_DONE)
+            continue;
+        else if (rx.type == RELOAD_IMAGE)
+        {
+            asset_image_t img;
+            uint8_t *unpacked = NULL;
+            status = RELOAD_ERR_IMAGE;
+            if (reload_image(rx.buf, rx.length, &img) &&
+                (unpacked = malloc((size_t)img.stride * img.height)) && asset_unpack(&img, unpacked) &&
+                write_image(argv[1], &img, unpacked))
+            {
+                free(pixels);
+                pixels = unpacked;
+                unpacked = NULL;
+                shown = img;
+                if (img.palette_size)
+                    memcpy(palette, img.palette, img.palette_size * 2u);
+                status = RELOAD_OK;
+            }
+            free(unpacked);
+        }
+        else if (rx.type == RELOAD_UPDATE)
+        {
+            if (!pixels || !reload_update(rx.buf, rx.length, pixels, shown.stride, shown.width, shown.height,
+                                          shown.format == ASSET_FORMAT_RGB565 ? 2 : 1))
+                status = RELOAD_ERR_IMAGE;
+        }
+        else if (rx.type != RELOAD_PING)
+            status = RELOAD_ERR_TYPE;
+        printf("%c%c%c%c", RELOAD_REPLY0, RELOAD_REPLY1, rx.type, status);
+        fflush(stdout);
+    }
+    if (pixels && !write_image(argv[1], &shown, pixels))
+        return 1;
+    free(pixels);
+    free(payload);
+    return 0;
+}
+#endif
@@ -0,0 +1,151 @@
+// Asset hot-reload over the UART: images sent by tools/reload.py are
+// received into RAM and swapped in at the next vblank, so screen art can be
+// changed without reflashing.
+
+// Frames share the UART with stdio. Bytes outside a frame are left to the
+// caller (the demo's 't' trace dump still works), and the host skips any
+// printf output between replies. A frame is
+//
+//   'R' 'L' type length payload crc
+//
+// with type one byte, length and crc 32-bit little-endian, and crc the
+// CRC-32 (as zlib's crc32()) of type, length and payload. Every frame is
+// answered with 'r' 'l' type status, status being a reload_status_t.
+//
+// A RELOAD_IMAGE payload is a reload_image_header_t, the palette as
+// palette_size RGB565 words padded to 4 bytes, then size bytes of pixels
+// stored as in assets/asset.h, optionally packed with RLE or QOI.
+//
+// A RELOAD_UPDATE payload patches the image on show, for driving the
+// display remotely: a sequence of reload_rect_t records, each followed by
+// size bytes of data, checked together and then written only during
+// vertical blanking, RELOAD_VBLANK_BYTES a vblank, so a large update lands
+// over several frames but no line is ever shown half written. A
+// RELOAD_RECT_RAW record holds the rectangle's pixels line by line; a
+// RELOAD_RECT_XOR record holds the XOR of the new and current bytes of
+// those lines, coded as a single stream with the ASSET_PACK_RLE control
+// bytes over bytes, so unchanged spans are runs of zero.
+//
+// reload_rx_t, reload_image() and reload_update() only depend on the C
+// library; with RELOAD_HOST, reload.c builds into the loopback device that
+// tools/reload.py --loopback and tools/remote.py talk to.
+
+#ifndef _RELOAD_H
+#define _RELOAD_H
+
+#include "asset.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RELOAD_MAGIC0 'R'
+#define RELOAD_MAGIC1 'L'
+#define RELOAD_REPLY0 'r'
+#define RELOAD_REPLY1 'l'
+
+typedef enum
+{
+    RELOAD_PING,   // empty payload, answered with RELOAD_OK
+    RELOAD_IMAGE,  // show the image in the payload from the next vblank
+    RELOAD_UPDATE, // change rectangles of the image on show, during vblanks
+    // Sent by the device, not answered; see capture.h.
+    RELOAD_CAPTURE,      // a screenshot starts: header and palette
+    RELOAD_CAPTURE_DATA, // the next bytes of its pixels
+    RELOAD_CAPTURE_END,  // it is complete: a capture_end_t
+} reload_type_t;
+
+typedef enum
+{
+    RELOAD_OK,
+    RELOAD_ERR_CRC,     // the frame was damaged
+    RELOAD_ERR_SIZE,    // the payload or unpacked image does not fit in RAM
+    RELOAD_ERR_IMAGE,   // malformed or undisplayable image or update
+    RELOAD_ERR_TYPE,    // unknown frame type
+    RELOAD_ERR_TIMEOUT, // the frame stopped arriving
+} reload_status_t;
+
+typedef struct
+{
+    uint16_t width;
+    uint16_t height;
+    uint32_t stride;       // bytes per unpacked line, a multiple of 4
+    uint8_t format;        // asset_format_t
+    uint8_t pack;          // asset_pack_t
+    uint16_t palette_size; // RGB565 entries, 0 for direct colour
+    uint32_t size;         // bytes of pixel data
+} reload_image_header_t;
+
+typedef enum
+{
+    RELOAD_RECT_RAW,
+    RELOAD_RECT_XOR,
+} reload_rect_kind_t;
+
+typedef struct
+{
+    uint16_t x, y; // in pixels
+    uint16_t width, height;
+    uint32_t size; // bytes of data after this record
+    uint8_t kind;  // reload_rect_kind_t
+    uint8_t reserved[3];
+} reload_rect_t;
+
+// What reload_rx_feed() made of a byte.
+typedef enum
+{
+    RELOAD_RX_IDLE,    // not part of a frame
+    RELOAD_RX_BUSY,    // consumed
+    RELOAD_RX_HEADER,  // type and length are known: set buf before the next byte
+    RELOAD_RX_DONE,    // a frame arrived intact; its payload is in buf
+    RELOAD_RX_BAD_CRC, // a frame arrived damaged
+    RELOAD_RX_DROPPED, // a frame arrived with buf NULL, so its payload was dropped
+} reload_rx_event_t;
+
+// Frame receiver, fed one byte at a time.
+typedef struct
+{
+    uint8_t *buf;      // where the payload goes, at least length bytes, or NULL
+    uint8_t type;
+    uint32_t length;
+    uint32_t crc;      // running, and received
+    uint32_t received; // bytes of the current field
+    uint8_t state;
+} reload_rx_t;
+
+// CRC-32 of n bytes continuing from crc, as zlib's crc32(); start from 0.
+uint32_t reload_crc32(uint32_t crc, const void *data, size_t n);
+
+void reload_rx_init(reload_rx_t *rx);
+reload_rx_event_t reload_rx_feed(reload_rx_t *rx, uint8_t byte);
+// True in the middle of a frame.
+bool reload_rx_busy(const reload_rx_t *rx);
+
+// Check a RELOAD_IMAGE payload and describe its pixels in place. Refuses
+// PAL4, which the display cannot show.
+bool reload_image(const uint8_t *payload, uint32_t length, asset_image_t *image);
+
+// Apply a RELOAD_UPDATE payload to an unpacked image of width x height
+// pixels of bytes_per_pixel bytes. Checks every record first; if any is
+// malformed or outside the image, returns false without changing it.
+bool reload_update(const uint8_t *payload, uint32_t length, uint8_t *pixels, uint32_t stride, unsigned width,
+                   unsigned height, unsigned bytes_per_pixel);
+
+#ifndef RELOAD_HOST
+#include "dvi_hstx.h"
+
+// Reloaded images live in a RELOAD_RAM_SIZE byte region. While a new image
+// fits in it next to the one shown, the swap is seamless; otherwise the
+// display shows fallback, a scanline callback, while the image arrives.
+void reload_init(dvi_format_t format, dvi_scanline_cb_t fallback, void *user);
+
+// Poll the UART for up to timeout_us and handle what arrived. Returns the
+// first byte that is not part of a frame, or -1 if there was none.
+int reload_poll(uint32_t timeout_us);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,530 @@
+// VT100/ANSI terminal on the text mode, see term.h.
+
+#include "term.h"
+#include <string.h>
+
+enum
+{
+    ST_GROUND,
+    ST_ESC,
+    ST_CSI,
+    ST_CHARSET, // ESC ( or ESC ): one more byte
+};
+
+// ANSI colour order (black, red, green, yellow, ...) to text.h's.
+static const uint8_t ansi_colour[8] = {TEXT_BLACK, TEXT_RED,     TEXT_GREEN, TEXT_BROWN,
+                                       TEXT_BLUE,  TEXT_MAGENTA, TEXT_CYAN,  TEXT_LIGHT_GREY};
+
+// DEC special graphics for 0x60-0x7e, in the font's CP437 box drawing where
+// it has them.
+static const uint8_t dec_graphics[31] = {
+    '*',  0xb1, ' ',  ' ',  ' ',  ' ',  'o',  '+',  ' ',  ' ',  0xd9, 0xbf, 0xda, 0xc0, 0xc5, 0xc4,
+    0xc4, 0xc4, 0xc4, 0xc4, 0xc3, 0xb4, 0xc1, 0xc2, 0xb3, '<',  '>',  'n',  '#',  'L',  '.',
+};
+
+#define DEFAULT_FG TEXT_LIGHT_GREY
+#define DEFAULT_BG TEXT_BLACK
+
+static void update_attr(term_t *t)
+{
+    t->attr = t->reverse ? TEXT_ATTR(t->bg, t->fg) : TEXT_ATTR(t->fg, t->bg);
+}
+
+// Spaces cleared by erasing and scrolling take the current background.
+static uint8_t blank_attr(const term_t *t)
+{
+    return t->attr;
+}
+
+static void hide_cursor(term_t *t)
+{
+    if (t->cursor_cell)
+        *t->cursor_cell = t->cursor_saved;
+    t->cursor_cell = NULL;
+}
+
+static void show_cursor(term_t *t)
+{
+    if (!t->cursor_visible)
+        return;
+    uint16_t *cell = &t->screen->rows[t->row][t->col];
+    uint16_t c = *cell;
+    t->cursor_cell = cell;
+    t->cursor_saved = c;
+    // Swap foreground and background.
+    *cell = (c & 0xff) | (uint16_t)((c >> 12 & 15) | (c >> 8 & 15) << 4) << 8;
+}
+
+static void reset(term_t *t)
+{
+    t->col = t->row = 0;
+    t->fg = DEFAULT_FG;
+    t->bg = DEFAULT_BG;
+    t->reverse = false;
+    update_attr(t);
+    t->wrap_pending = false;
+    t->autowrap = true;
+    t->newline_mode = true;
+    t->cursor_visible = true;
+    t->line_drawing = false;
+    t->top = 0;
+    t->bottom = TEXT_ROWS - 1;
+    t->saved_col = t->saved_row = 0;
+    t->saved_fg = DEFAULT_FG;
+    t->saved_bg = DEFAULT_BG;
+    t->saved_reverse = false;
+    t->state = ST_GROUND;
+    t->cursor_cell = NULL;
+    text_clear(t->screen, t->attr);
+}
+
+void term_init(term_t *t, text_screen_t *screen)
+{
+    t->screen = screen;
+    reset(t);
+    show_cursor(t);
+}
+
+static uint clamp(int v, int lo, int hi)
+{
+    return (uint)(v < lo ? lo : v > hi ? hi : v);
+}
+
+static void move_to(term_t *t, int col, int row)
+{
+    t->col = clamp(col, 0, TEXT_COLS - 1);
+    t->row = clamp(row, 0, TEXT_ROWS - 1);
+    t->wrap_pending = false;
+}
+
+// Down a line, scrolling at the bottom of the region.
+static void line_feed(term_t *t)
+{
+    if (t->row == t->bottom)
+        text_scroll(t->screen, t->top, t->bottom, 1, blank_attr(t));
+    else if (t->row < TEXT_ROWS - 1)
+        ++t->row;
+    t->wrap_pending = false;
+}
+
+static void reverse_index(term_t *t)
+{
+    if (t->row == t->top)
+        text_scroll(t->screen, t->top, t->bottom, -1, blank_attr(t));
+    else if (t->row > 0)
+        --t->row;
+    t->wrap_pending = false;
+}
+
+static void put_char(term_t *t, uint8_t c)
+{
+    if (t->line_drawing && c >= 0x60 && c <= 0x7e)
+        c = dec_graphics[c - 0x60];
+    if (t->wrap_pending)
+    {
+        t->col = 0;
+        line_feed(t);
+    }
+    t->screen->rows[t->row][t->col] = TEXT_CELL(c, t->attr);
+    if (t->col < TEXT_COLS - 1)
+        ++t->col;
+    else
+        t->wrap_pending = t->autowrap;
+}
+
+// Parameter i, or def if missing or 0 where 0 means the default.
+static uint param(const term_t *t, uint i, uint def)
+{
+    return i < t->nparams && t->params[i] ? t->params[i] : def;
+}
+
+// Nearest of the 16 colours to an xterm 256-colour index.
+static uint8_t colour_256(uint n)
+{
+    if (n < 16)
+        return n < 8 ? ansi_colour[n] : ansi_colour[n - 8] + 8;
+    uint r, g, b;
+    if (n >= 232)
+    {
+        r = g = b = (n - 232) * 10 + 8;
+    }
+    else
+    {
+        static const uint8_t level[6] = {0, 95, 135, 175, 215, 255};
+        n -= 16;
+        r = level[n / 36];
+        g = level[n / 6 % 6];
+        b = level[n % 6];
+    }
+    uint max = r > g ? (r > b ? r : b) : (g > b ? g : b);
+    if (max < 64)
+        return TEXT_BLACK;
+    // Channels at least half the brightest are on; bright when that is high.
+    uint8_t c = ansi_colour[(r * 2 >= max) | (g * 2 >= max) << 1 | (b * 2 >= max) << 2];
+    if (c == TEXT_LIGHT_GREY && max < 160)
+        return TEXT_DARK_GREY;
+    return max >= 192 ? c | 8 : c;
+}
+
+static uint8_t colour_rgb(uint r, uint g, uint b)
+{
+    // The 6x6x6 cube index of the colour.
+    uint n = 16 + (r * 5 + 127) / 255 * 36 + (g * 5 + 127) / 255 * 6 + (b * 5 + 127) / 255;
+    return colour_256(n);
+}
+
+static void sgr(term_t *t)
+{
+    if (!t->nparams)
+        t->params[t->nparams++] = 0;
+    for (uint i = 0; i < t->nparams; ++i)
+    {
+        uint p = t->params[i];
+        if (p == 0)
+        {
+            t->fg = DEFAULT_FG;
+            t->bg = DEFAULT_BG;
+            t->reverse = false;
+        }
+        else if (p == 1)
+            t->fg |= 8;
+        else if (p == 2 || p == 22)
+            t->fg &= 7;
+        else if (p == 7)
+            t->reverse = true;
+        else if (p == 27)
+            t->reverse = false;
+        else if (p >= 30 && p <= 37)
+            t->fg = (t->fg & 8) | ansi_colour[p - 30];
+        else if (p == 39)
+            t->fg = DEFAULT_FG;
+        else if (p >= 40 && p <= 47)
+            t->bg = ansi_colour[p - 40];
+        else if (p == 49)
+            t->bg = DEFAULT_BG;
+        else if (p >= 90 && p <= 97)
+            t->fg = ansi_colour[p - 90] | 8;
+        else if (p >= 100 && p <= 107)
+            t->bg = ansi_colour[p - 100] | 8;
+        else if ((p == 38 || p == 48) && i + 1 < t->nparams)
+        {
+            uint8_t c;
+            if (t->params[i + 1] == 5 && i + 2 < t->nparams)
+            {
+                c = colour_256(t->params[i + 2] & 255);
+                i += 2;
+            }
+            else if (t->params[i + 1] == 2 && i + 4 < t->nparams)
+            {
+                c = colour_rgb(t->params[i + 2] & 255, t->params[i + 3] & 255, t->params[i + 4] & 255);
+                i += 4;
+            }
+            else
+                break;
+            if (p == 38)
+                t->fg = c;
+            else
+                t->bg = c;
+        }
+    }
+    update_attr(t);
+}
+
+static void erase_display(term_t *t, uint mode)
+{
+    text_screen_t *s = t->screen;
+    uint8_t a = blank_attr(t);
+    if (mode == 0)
+    {
+        text_clear_row(s, t->row, t->col, TEXT_COLS, a);
+        for (uint r = t->row + 1; r < TEXT_ROWS; ++r)
+            text_clear_row(s, r, 0, TEXT_COLS, a);
+    }
+    else if (mode == 1)
+    {
+        for (uint r = 0; r < t->row; ++r)
+            text_clear_row(s, r, 0, TEXT_COLS, a);
+        text_clear_row(s, t->row, 0, t->col + 1, a);
+    }
+    else
+    {
+        text_clear(s, a);
+    }
+}
+
+static void erase_line(term_t *t, uint mode)
+{
+    uint from = mode == 0 ? t->col : 0;
+    uint to = mode == 1 ? t->col + 1 : TEXT_COLS;
+    text_clear_row(t->screen, t->row, from, to, blank_attr(t));
+}
+
+// Insert (n > 0) or delete (n < 0) blank cells at the cursor, shifting the
+// rest of the line.
+static void shift_chars(term_t *t, int n)
+{
+    uint16_t *line = t->screen->rows[t->row];
+    uint k = clamp(n < 0 ? -n : n, 0, TEXT_COLS - t->col);
+    uint rest = TEXT_COLS - t->col - k;
+    if (n > 0)
+    {
+        memmove(line + t->col + k, line + t->col, rest * sizeof(*line));
+        text_clear_row(t->screen, t->row, t->col, t->col + k, blank_attr(t));
+    }
+    else
+    {
+        memmove(line + t->col, line + t->col + k, rest * sizeof(*line));
+        text_clear_row(t->screen, t->row, TEXT_COLS - k, TEXT_COLS, blank_attr(t));
+    }
+}
+
+static void set_mode(term_t *t, bool on)
+{
+    for (uint i = 0; i < t->nparams; ++i)
+    {
+        uint p = t->params[i];
+        if (t->private_marker && p == 7)
+            t->autowrap = on;
+        else if (t->private_marker && p == 25)
+            t->cursor_visible = on;
+        else if (!t->private_marker && p == 20)
+            t->newline_mode = on;
+    }
+}
+
+static void csi(term_t *t, uint8_t final)
+{
+    switch (final)
+    {
+    case 'A':
+        move_to(t, t->col, (int)t->row - (int)param(t, 0, 1));
+        break;
+    case 'B':
+        move_to(t, t->col, t->row + param(t, 0, 1));
+        break;
+    case 'C':
+        move_to(t, t->col + param(t, 0, 1), t->row);
+        break;
+    case 'D':
+        move_to(t, (int)t->col - (int)param(t, 0, 1), t->row);
+        break;
+    case 'E':
+        move_to(t, 0, t->row + param(t, 0, 1));
+        break;
+    case 'F':
+        move_to(t, 0, (int)t->row - (int)param(t, 0, 1));
+        break;
+    case 'G':
+        move_to(t, param(t, 0, 1) - 1, t->row);
+        break;
+    case 'H':
+    case 'f':
+        move_to(t, param(t, 1, 1) - 1, param(t, 0, 1) - 1);
+        break;
+    case 'd':
+        move_to(t, t->col, param(t, 0, 1) - 1);
+        break;
+    case 'J':
+        erase_display(t, param(t, 0, 0));
+        break;
+    case 'K':
+        erase_line(t, param(t, 0, 0));
+        break;
+    case 'X':
+        text_clear_row(t->screen, t->row, t->col, clamp(t->col + param(t, 0, 1), 0, TEXT_COLS), blank_attr(t));
+        break;
+    case '@':
+        shift_chars(t, param(t, 0, 1));
+        break;
+    case 'P':
+        shift_chars(t, -(int)param(t, 0, 1));
+        break;
+    case 'L':
+    case 'M':
+        // Within the region from the cursor row down.
+        if (t->row >= t->top && t->row <= t->bottom)
+        {
+            int n = (int)param(t, 0, 1);
+            text_scroll(t->screen, t->row, t->bottom, final == 'L' ? -n : n, blank_attr(t));
+            t->col = 0;
+            t->wrap_pending = false;
+        }
+        break;
+    case 'S':
+        text_scroll(t->screen, t->top, t->bottom, param(t, 0, 1), blank_attr(t));
+        break;
+    case 'T':
+        text_scroll(t->screen, t->top, t->bottom, -(int)param(t, 0, 1), blank_attr(t));
+        break;
+    case 'r':
+    {
+        uint top = param(t, 0, 1) - 1, bottom = param(t, 1, TEXT_ROWS) - 1;
+        if (top < bottom && bottom < TEXT_ROWS)
+        {
+            t->top = top;
+            t->bottom = bottom;
+            move_to(t, 0, 0);
+        }
+        break;
+    }
+    case 's':
+        t->saved_col = t->col;
+        t->saved_row = t->row;
+        break;
+    case 'u':
+        move_to(t, t->saved_col, t->saved_row);
+        break;
+    case 'h':
+        set_mode(t, true);
+        break;
+    case 'l':
+        set_mode(t, false);
+        break;
+    case 'm':
+        sgr(t);
+        break;
+    default:
+        break;
+    }
+}
+
+static void esc(term_t *t, uint8_t c)
+{
+    t->state = ST_GROUND;
+    switch (c)
+    {
+    case '[':
+        t->state = ST_CSI;
+        t->private_marker = false;
+        t->nparams = 0;
+        memset(t->params, 0, sizeof(t->params));
+        break;
+    case '(':
+    case ')':
+        t->state = ST_CHARSET;
+        t->private_marker = c == ')'; // G1, which is never shifted in
+        break;
+    case '7':
+        t->saved_col = t->col;
+        t->saved_row = t->row;
+        t->saved_fg = t->fg;
+        t->saved_bg = t->bg;
+        t->saved_reverse = t->reverse;
+        break;
+    case '8':
+        move_to(t, t->saved_col, t->saved_row);
+        t->fg = t->saved_fg;
+        t->bg = t->saved_bg;
+        t->reverse = t->saved_reverse;
+        update_attr(t);
+        break;
+    case 'D':
+        line_feed(t);
+        break;
+    case 'E':
+        t->col = 0;
+        line_feed(t);
+        break;
+    case 'M':
+        reverse_index(t);
+        break;
+    case 'c':
+        reset(t);
+        break;
+    default:
+        break;
+    }
+}
+
+static void control(term_t *t, uint8_t c)
+{
+    switch (c)
+    {
+    case '\b':
+        if (t->col > 0)
+            --t->col;
+        t->wrap_pending = false;
+        break;
+    case '\t':
+        move_to(t, (t->col | 7) + 1, t->row);
+        break;
+    case '\n':
+    case '\v':
+    case '\f':
+        if (t->newline_mode)
+            t->col = 0;
+        line_feed(t);
+        break;
+    case '\r':
+        t->col = 0;
+        t->wrap_pending = false;
+        break;
+    case 0x1b:
+        t->state = ST_ESC;
+        break;
+    case 0x18: // CAN and SUB abort a sequence
+    case 0x1a:
+        t->state = ST_GROUND;
+        break;
+    default:
+        break;
+    }
+}
+
+void term_write(term_t *t, const char *s, size_t n)
+{
+    hide_cursor(t);
+    for (size_t i = 0; i < n; ++i)
+    {
+        uint8_t c = (uint8_t)s[i];
+        if (c < 0x20 || c == 0x7f)
+        {
+            // Controls act even inside sequences, except ESC restarting one.
+            if (c != 0x7f)
+                control(t, c);
+            continue;
+        }
+        switch (t->state)
+        {
+        case ST_GROUND:
+            put_char(t, c);
+            break;
+        case ST_ESC:
+            esc(t, c);
+            break;
+        case ST_CHARSET:
+            if (!t->private_marker)
+                t->line_drawing = c == '0';
+            t->state = ST_GROUND;
+            break;
+        default:
+            if (c >= '0' && c <= '9')
+            {
+                if (!t->nparams)
+                    t->nparams = 1;
+                uint16_t *p = &t->params[t->nparams - 1];
+                if (*p < 10000)
+                    *p = *p * 10 + (c - '0');
+            }
+            else if (c == ';')
+            {
+                if (!t->nparams)
+                    t->nparams = 1;
+                if (t->nparams < TERM_MAX_PARAMS)
+                    ++t->nparams;
+            }
+            else if (c == '?' || c == '>' || c == '=')
+            {
+                t->private_marker = true;
+            }
+            else if (c >= 0x40 && c <= 0x7e)
+            {
+                // ';' leaves an empty last parameter, which reads as 0.
+                csi(t, c);
+                t->state = ST_GROUND;
+            }
+            break;
+        }
+    }
+    show_cursor(t);
+}
@@ -0,0 +1,64 @@
+// VT100/ANSI terminal on the text mode (dvi_hstx/text.h): bytes written
+// to it are parsed on the calling core and update the cells, so the display
+// can follow a serial log or a shell.
+//
+// Handles the control characters, ESC 7/8/D/E/M/c, the DEC line drawing
+// character set (ESC ( 0), and the CSI sequences for cursor movement
+// (A-H, d, f, s, u), erasing (J, K, X), inserting and deleting (@, P, L,
+// M), scrolling (S, T, r), modes (?7 autowrap, ?25 cursor, 20 newline) and
+// SGR colours, bright and reverse; 256-colour and RGB SGR colours map to
+// the nearest of the 16. Queries that want a reply are ignored. As serial
+// logs usually end lines with a bare LF, newline mode (LF also returns the
+// carriage) starts on; CSI 20 l turns it off.
+//
+// Scrolling rotates the text mode's row pointers, so it costs the same
+// for a full screen as for a region, whatever the content: clearing one
+// row.
+
+#ifndef _TERM_H
+#define _TERM_H
+
+#include "text.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TERM_MAX_PARAMS 8
+
+typedef struct
+{
+    text_screen_t *screen;
+    uint8_t col, row;
+    uint8_t attr;          // for new characters, reverse applied
+    uint8_t fg, bg;        // colour indices, before reverse
+    bool reverse;
+    bool wrap_pending;     // the last column was written; wrap before the next character
+    bool autowrap;
+    bool newline_mode;
+    bool cursor_visible;
+    bool line_drawing;     // G0 is the DEC special graphics set
+    uint8_t top, bottom;   // scrolling region, inclusive
+    uint8_t saved_col, saved_row, saved_fg, saved_bg;
+    bool saved_reverse;
+    // Parser
+    uint8_t state;
+    bool private_marker;   // '?' after the CSI
+    uint8_t nparams;
+    uint16_t params[TERM_MAX_PARAMS];
+    // The cell the cursor is drawn on, with its attribute before drawing.
+    uint16_t *cursor_cell;
+    uint16_t cursor_saved;
+} term_t;
+
+// Start on a cleared screen with the cursor at the top left.
+void term_init(term_t *t, text_screen_t *screen);
+
+// Parse and apply n bytes.
+void term_write(term_t *t, const char *s, size_t n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,142 @@
+#!/usr/bin/env python3
+"""Pack images into an asset archive for assets/archive.h.
+
+    python3 tools/archive.py -o images/screens.bin \\
+        images/Mario.jpg:format=rgb332,dither=bluenoise \\
+        images/Mountains.png:name=mountains,format=pal8,pack=qoi
+
+converts each source as tools/imgconv.py would and writes one archive with
+an index of names, sizes, formats and packing. Options follow the source
+after a colon: name (default: the file name, lower case, without
+extension), format, pack, dither, colours, crop=X+Y+W+H and resize=WxH,
+with -f, -p, -d and --resize giving the defaults. --list prints the index
+of an existing archive.
+
+The archive goes to its own region of flash, away from the firmware, e.g.
+
+    picotool load -o 0x10200000 -t bin images/screens.bin
+
+for ARCHIVE_FLASH_OFFSET 0x200000, so screens can change without
+rebuilding. Needs Pillow and numpy.
+"""
+
+import argparse
+import os
+import struct
+import sys
+
+from dither import METHODS
+from imgconv import FORMATS, PACKS, encode, load, pack_lines, pad_lines, parse_size, rgb565_word
+
+# Must match archive.h.
+MAGIC = 0x41495644
+VERSION = 1
+NAME_MAX = 24
+HEADER = struct.Struct("<IHHI")
+ENTRY = struct.Struct("<24sIIHHIBBHI")
+
+
+def align(data):
+    return data + bytes(-len(data) % 4)
+
+
+def parse_spec(spec, defaults):
+    source, _, opts = spec.partition(":")
+    entry = dict(defaults, source=source,
+                 name=os.path.splitext(os.path.basename(source))[0].lower())
+    for opt in filter(None, opts.split(",")):
+        key, _, value = opt.partition("=")
+        if key not in entry or key == "source":
+            sys.exit("archive: unknown option %r in %s" % (key, spec))
+        entry[key] = value
+    if entry["format"] not in FORMATS or entry["pack"] not in PACKS or entry["dither"] not in METHODS:
+        sys.exit("archive: bad format, pack or dither in %s" % spec)
+    if not 0 < len(entry["name"].encode()) < NAME_MAX:
+        sys.exit("archive: name of %s must be 1 to %d bytes" % (spec, NAME_MAX - 1))
+    return entry
+
+
+def convert(entry, jobs=None):
+    """Return (width, height, stride, palette or None, packed data) for an
+    entry from parse_spec()."""
+    crop = tuple(int(v) for v in entry["crop"].split("+")) if entry["crop"] else None
+    resize = parse_size(entry["resize"]) if entry["resize"] else None
+    rgb = load(entry["source"], crop, resize)
+    height, width = rgb.shape[:2]
+    colours = int(entry["colours"]) if entry["colours"] else None
+    lines, palette = encode(rgb, entry["format"], colours, entry["dither"], jobs)
+    lines, stride = pad_lines(lines)
+    return width, height, stride, palette, pack_lines(lines, entry["format"], entry["pack"])
+
+
+def build(entries, jobs=None):
+    """Return the archive bytes and a line per entry for the report."""
+    entries = sorted(entries, key=lambda e: e["name"].encode())
+    for a, b in zip(entries, entries[1:]):
+        if a["name"] == b["name"]:
+            sys.exit("archive: %s is packed twice" % a["name"])
+    blobs, index, report = [], [], []
+    offset = HEADER.size + ENTRY.size * len(entries)
+    for e in entries:
+        width, height, stride, palette, data = convert(e, jobs)
+        pixels_at = offset
+        blobs.append(align(data))
+        offset += len(blobs[-1])
+        palette_at = 0
+        if palette:
+            palette_at = offset
+            blobs.append(align(b"".join(struct.pack("<H", rgb565_word(*c)) for c in palette)))
+            offset += len(blobs[-1])
+        index.append(ENTRY.pack(e["name"].encode(), pixels_at, len(data), width, height, stride,
+                                FORMATS[e["format"]], PACKS[e["pack"]], len(palette or []), palette_at))
+        report.append("%-23s %-6s %-4s %4dx%-4d %7d bytes at 0x%06x"
+                      % (e["name"], e["format"], e["pack"], width, height, len(data), pixels_at))
+    header = HEADER.pack(MAGIC, VERSION, len(entries), offset)
+    return header + b"".join(index) + b"".join(blobs), report
+
+
+def list_archive(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    magic, version, count, size = HEADER.unpack_from(data)
+    if magic != MAGIC or version != VERSION:
+        sys.exit("archive: %s is not a version %d archive" % (path, VERSION))
+    names = {v: k for k, v in FORMATS.items()}
+    packs = {v: k for k, v in PACKS.items()}
+    print("%s: %d entries, %d bytes" % (path, count, size))
+    for i in range(count):
+        name, offset, length, width, height, _, fmt, pack, colours, _ = \
+            ENTRY.unpack_from(data, HEADER.size + i * ENTRY.size)
+        print("%-23s %-6s %-4s %4dx%-4d %7d bytes at 0x%06x%s"
+              % (name.rstrip(b"\0").decode(), names[fmt], packs[pack], width, height, length, offset,
+                 ", %d colours" % colours if colours else ""))
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("sources", nargs="*", metavar="SOURCE[:OPTION=VALUE,...]")
+    ap.add_argument("-o", "--output", help="archive to write")
+    ap.add_argument("-f", "--format", choices=FORMATS, default="rgb332")
+    ap.add_argument("-p", "--pack", choices=PACKS, default="none")
+    ap.add_argument("-d", "--dither", choices=METHODS, default="none")
+    ap.add_argument("--resize", metavar="WxH")
+    ap.add_argument("-j", "--jobs", type=int, help="workers (default: CPU count)")
+    ap.add_argument("--list", metavar="ARCHIVE", help="print the index of an archive")
+    args = ap.parse_args()
+
+    if args.list:
+        list_archive(args.list)
+        return
+    if not args.output or not args.sources:
+        ap.error("need -o and at least one source")
+    defaults = {"format": args.format, "pack": args.pack, "dither": args.dither, "colours": None,
+                "crop": None, "resize": args.resize}
+    data, report = build([parse_spec(s, defaults) for s in args.sources], args.jobs)
+    with open(args.output, "wb") as f:
+        f.write(data)
+    print("\n".join(report))
+    print("%s: %d entries, %d bytes" % (args.output, len(report), len(data)))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,84 @@
+#!/usr/bin/env python3
+"""Compare compile times of images embedded as C arrays and with .incbin.
+
+    python3 tools/bench_compile.py images/mario_640x480_rgb332.bin [--cc arm-none-eabi-gcc]
+
+For each binary asset, times compiling a translation unit that includes it
+as a hex C array header (how images used to be embedded) against
+assembling the asset_embed() .incbin wrapper plus compiling a unit that
+includes the generated metadata header. Prints the median of --runs runs.
+"""
+
+import argparse
+import os
+import shutil
+import statistics
+import subprocess
+import sys
+import tempfile
+import time
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from imgconv import write_c_array  # noqa: E402
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+
+def timed(cmd, runs):
+    times = []
+    for _ in range(runs):
+        t = time.perf_counter()
+        subprocess.run(cmd, check=True)
+        times.append(time.perf_counter() - t)
+    return statistics.median(times)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("assets", nargs="+", help="images/<name>.bin with its <name>.h")
+    ap.add_argument("--cc", default=os.environ.get("CC", "cc"))
+    ap.add_argument("--runs", type=int, default=5)
+    args = ap.parse_args()
+
+    with open(os.path.join(ROOT, "assets", "incbin.S.in")) as f:
+        incbin = f.read()
+    tmp = tempfile.mkdtemp(prefix="bench_compile.")
+    cflags = ["-O2", "-c", "-I", os.path.join(ROOT, "assets")]
+    print("%-28s %12s %10s %12s %10s %8s" % ("asset", "array_bytes", "array_s", "incbin_bytes",
+                                             "incbin_s", "speedup"))
+    try:
+        for path in args.assets:
+            path = os.path.abspath(path)
+            name = os.path.splitext(os.path.basename(path))[0]
+            with open(path, "rb") as f:
+                data = f.read()
+
+            array_h = os.path.join(tmp, name + "_array.h")
+            write_c_array(array_h, name, data)
+            before = os.path.join(tmp, name + "_array.c")
+            with open(before, "w") as f:
+                f.write('#include "%s"\n' % array_h)
+
+            asm = os.path.join(tmp, name + ".S")
+            with open(asm, "w") as f:
+                f.write(incbin.replace("@ASSET_SECTION@", ".data." + name)
+                        .replace("@ASSET_FLAGS@", "aw").replace("@ASSET_SYMBOL@", name)
+                        .replace("@ASSET_BIN@", path))
+            after = os.path.join(tmp, name + "_meta.c")
+            with open(after, "w") as f:
+                f.write('#include "%s"\nconst void *use_%s(void) { return &%s_image; }\n'
+                        % (os.path.splitext(path)[0] + ".h", name, name))
+
+            t_before = timed([args.cc] + cflags + [before, "-o", os.devnull], args.runs)
+            t_after = timed([args.cc] + cflags + [asm, "-o", os.devnull], args.runs) + \
+                timed([args.cc] + cflags + [after, "-o", os.devnull], args.runs)
+            print("%-28s %12d %10.3f %12d %10.3f %7.1fx"
+                  % (name, os.path.getsize(array_h), t_before,
+                     os.path.getsize(asm) + os.path.getsize(os.path.splitext(path)[0] + ".h"),
+                     t_after, t_before / t_after))
+    finally:
+        shutil.rmtree(tmp)
+
+
+if __name__ == "__main__":
+    main()
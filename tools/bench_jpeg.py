@@ -0,0 +1,77 @@
+#!/usr/bin/env python3
+"""Benchmark and check the JPEG decoder in assets/jpeg.c on the host.
+
+    python3 tools/bench_jpeg.py images/Mario.jpg [--cc clang] [--cflags "-O3"]
+
+Builds bench_jpeg.c with BENCH_JPEG_HOST and, for each image and output
+format, prints what it reports (fastest of five decodes, decoder state,
+peak stack) along with the PSNR of the result against Pillow's decode
+reduced to the same format. The same bench_jpeg() runs on the target in
+the demo's JPEG mode.
+"""
+
+import argparse
+import os
+import shlex
+import shutil
+import subprocess
+import sys
+import tempfile
+
+import numpy as np
+from PIL import Image
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from palette import psnr  # noqa: E402
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+
+def shown(raw, fmt, width, height):
+    """Decoded pixels as 8-bit RGB with the low bits zero, as scanned out."""
+    if fmt == "rgb565":
+        p = np.frombuffer(raw, "<u2").reshape(height, width).astype(np.int32)
+        return np.stack([(p >> 11) << 3, ((p >> 5) & 63) << 2, (p & 31) << 3], axis=-1)
+    p = np.frombuffer(raw, np.uint8).reshape(height, width).astype(np.int32)
+    return np.stack([p & 0xE0, (p << 3) & 0xE0, (p << 6) & 0xC0], axis=-1)
+
+
+def truncated(rgb, fmt):
+    mask = (0xF8, 0xFC, 0xF8) if fmt == "rgb565" else (0xE0, 0xE0, 0xC0)
+    return rgb.astype(np.int32) & np.array(mask)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("images", nargs="+")
+    ap.add_argument("--cc", default=os.environ.get("CC", "cc"))
+    ap.add_argument("--cflags", default="-O2")
+    args = ap.parse_args()
+
+    tmp = tempfile.mkdtemp(prefix="bench_jpeg.")
+    try:
+        exe = os.path.join(tmp, "bench_jpeg")
+        subprocess.run([args.cc] + shlex.split(args.cflags) +
+                       ["-DBENCH_JPEG_HOST", "-I", os.path.join(ROOT, "assets"),
+                        os.path.join(ROOT, "bench_jpeg.c"), os.path.join(ROOT, "assets", "jpeg.c"),
+                        "-o", exe], check=True)
+        for path in args.images:
+            img = Image.open(path)
+            ref = np.asarray(img.convert("RGB"))
+            for fmt in ("rgb332", "rgb565"):
+                out = os.path.join(tmp, "out.raw")
+                run = subprocess.run([exe, path, fmt, out], capture_output=True, text=True)
+                if run.returncode:
+                    print("%s %s: decode failed" % (os.path.basename(path), fmt))
+                    continue
+                with open(out, "rb") as f:
+                    got = shown(f.read(), fmt, img.width, img.height)
+                report = run.stdout.strip().removeprefix("# jpeg: ")
+                print("%s %s, PSNR %.2f dB against Pillow" % (os.path.basename(path), report,
+                                                              psnr(truncated(ref, fmt), got)))
+    finally:
+        shutil.rmtree(tmp)
+
+
+if __name__ == "__main__":
+    main()
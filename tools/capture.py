@@ -0,0 +1,183 @@
+#!/usr/bin/env python3
+"""Save what a running device shows as a PNG.
+
+    python3 tools/capture.py --port /dev/ttyUSB0 shot.png
+    python3 tools/capture.py --loopback images/Mountains.png:format=pal8 shot.png
+    python3 tools/capture.py --loopback noise:seed=4 shot.png
+
+sends 's' to the demo, which captures the frame on show and streams it
+back packed with QOI (see capture.h), and writes it out as 8-bit RGB, with
+channels widened by repeating their top bits. Prints the size sent and the
+device's capture time: the time spent packing, and in all until the last
+byte was queued, which at low baud rates is mostly the UART. The UART is
+shared with stdio, so printf output from the device is passed through.
+
+--loopback sends the image given, converted as tools/reload.py would, to
+reload.c built for the host and captures that instead, then checks the
+capture against the image. The image "noise" is 640x480 of uniform random
+bytes (and a random palette for pal8), the most QOI can expand a screen.
+--port needs pyserial.
+"""
+
+import argparse
+import os
+import struct
+import sys
+import tempfile
+import time
+import zlib
+
+import numpy as np
+from PIL import Image
+
+from archive import convert, parse_spec
+from dither import METHODS
+from imgconv import FORMATS, qoi_unpack, rgb565_word
+from reload import IMAGE, IMAGE_HEADER, STATUS, Loopback, Serial, image_payload, send
+
+# Must match reload.h and capture.h.
+CAPTURE, CAPTURE_DATA, CAPTURE_END = 3, 4, 5
+END = struct.Struct("<IIIH2x")
+
+
+def frames(link, timeout):
+    """Yield (type, payload) of the frames arriving until timeout, passing
+    the text between them on."""
+    pending = b""
+    deadline = time.monotonic() + timeout
+    while time.monotonic() < deadline:
+        pending += link.read()
+        while True:
+            at = pending.find(b"RL")
+            if at < 0:
+                keep = 1 if pending.endswith(b"R") else 0
+                sys.stdout.write(pending[:len(pending) - keep].decode(errors="replace"))
+                pending = pending[len(pending) - keep:]
+                break
+            sys.stdout.write(pending[:at].decode(errors="replace"))
+            pending = pending[at:]
+            if len(pending) < 7:
+                break
+            kind, length = struct.unpack_from("<BI", pending, 2)
+            if kind not in (CAPTURE, CAPTURE_DATA, CAPTURE_END) or length > 1 << 20:
+                # Text that happens to contain "RL".
+                sys.stdout.write("RL")
+                pending = pending[2:]
+                continue
+            if len(pending) < 11 + length:
+                break
+            body = pending[2:7 + length]
+            (crc,) = struct.unpack_from("<I", pending, 7 + length)
+            pending = pending[11 + length:]
+            if crc != zlib.crc32(body):
+                raise ValueError("capture frame damaged in transit")
+            yield kind, body[5:]
+
+
+def receive(link, timeout):
+    """The captured header, palette words, pixel bytes and capture_end_t."""
+    header, palette, data = None, (), bytearray()
+    for kind, payload in frames(link, timeout):
+        if kind == CAPTURE:
+            header = IMAGE_HEADER.unpack_from(payload)
+            colours = header[5]
+            palette = struct.unpack_from("<%dH" % colours, payload, IMAGE_HEADER.size)
+            data = bytearray()
+        elif kind == CAPTURE_DATA:
+            data += payload
+        else:
+            return header, palette, bytes(data), END.unpack_from(payload)
+    return None
+
+
+def to_rgb(pixels, fmt, palette, width, height, stride):
+    """Unpacked lines as an HxWx3 array of 8-bit RGB."""
+    lines = np.frombuffer(pixels, np.uint8).reshape(height, stride)
+    if fmt == "rgb332":
+        p = lines[:, :width].astype(np.uint32)
+        r, g, b = p >> 5, (p >> 2) & 7, p & 3
+        return np.stack([r * 255 // 7, g * 255 // 7, b * 85], axis=-1).astype(np.uint8)
+    if fmt == "rgb565":
+        p = lines[:, :2 * width].copy().view("<u2").astype(np.uint32)
+    else:
+        p = np.asarray(palette, np.uint32)[lines[:, :width]]
+    r, g, b = p >> 11, (p >> 5) & 63, p & 31
+    return np.stack([r * 255 // 31, g * 255 // 63, b * 255 // 31], axis=-1).astype(np.uint8)
+
+
+def noise(fmt, seed, width=640, height=480):
+    """A random image as convert() returns it."""
+    rng = np.random.default_rng(seed)
+    unit = 2 if fmt == "rgb565" else 1
+    raw = rng.integers(0, 256, width * height * unit, np.uint8).tobytes()
+    palette = [tuple(c) for c in rng.integers(0, 256, (256, 3))] if fmt == "pal8" else None
+    return width, height, width * unit, palette, raw
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("source", nargs="?", metavar="SOURCE[:OPTION=VALUE,...]",
+                    help="with --loopback, the image to show before capturing")
+    ap.add_argument("output", help="PNG to write")
+    link = ap.add_mutually_exclusive_group(required=True)
+    link.add_argument("--port", help="serial device of the board's UART")
+    link.add_argument("--loopback", action="store_true", help="talk to reload.c built for the host")
+    ap.add_argument("--baud", type=int, default=115200)
+    ap.add_argument("-f", "--format", choices=("rgb332", "rgb565", "pal8"), default="rgb332")
+    ap.add_argument("-d", "--dither", choices=METHODS, default="none")
+    ap.add_argument("--resize", metavar="WxH")
+    ap.add_argument("--cc", default=os.environ.get("CC", "cc"), help="host compiler for --loopback")
+    ap.add_argument("--cflags", default="-O2")
+    args = ap.parse_args()
+    if bool(args.source) != bool(args.loopback):
+        ap.error("give an image to show with --loopback, and only then")
+
+    shown = None
+    if args.loopback:
+        entry = parse_spec(args.source, {"format": args.format, "pack": "none", "dither": args.dither,
+                                         "colours": None, "crop": None, "resize": args.resize, "seed": "0"})
+        if entry["source"] == "noise":
+            width, height, stride, palette, raw = noise(entry["format"], int(entry["seed"]))
+        else:
+            width, height, stride, palette, raw = convert(entry)
+        words = [rgb565_word(*c) for c in palette or []]
+        shown = (entry["format"], words, raw)
+        path = tempfile.NamedTemporaryFile(suffix=".raw", delete=False).name
+        link = Loopback(args.cc, args.cflags, path)
+        status = send(link, IMAGE, image_payload(width, height, stride, entry["format"], "none", words, raw))
+        if status != 0:
+            sys.exit("capture: loopback: %s" % ("no reply" if status is None else STATUS[status]))
+    else:
+        link = Serial(args.port, args.baud)
+
+    try:
+        link.write(b"s")
+        # A raw 640x480 RGB565 frame, should QOI not pack it at all.
+        got = receive(link, 5 + 640 * 480 * 3 * 10 / args.baud)
+    finally:
+        if args.loopback:
+            link.close()
+            os.unlink(path)
+    if got is None:
+        sys.exit("capture: no capture arrived")
+    header, palette, data, (size, encode_us, total_us, lines) = got
+    if not lines:
+        sys.exit("capture: the display is drawn by a scanline callback, nothing to read back")
+
+    width, height, stride, fmt, _, _, _ = header
+    fmt = [k for k, v in FORMATS.items() if v == fmt][0]
+    pixels = qoi_unpack(data, fmt, stride * height // (2 if fmt == "rgb565" else 1))
+    Image.fromarray(to_rgb(pixels, fmt, palette, width, height, stride)).save(args.output)
+    raw_size = stride * height + 2 * len(palette)
+    print("%dx%d %s: %d bytes sent for %d (%.1f%%), %.1f s at %d baud"
+          % (width, height, fmt, size, raw_size, 100.0 * size / raw_size, size * 10 / args.baud, args.baud))
+    print("capture: packing %.1f ms, in all %.1f ms" % (encode_us / 1000, total_us / 1000))
+    print("wrote %s" % args.output)
+    if shown:
+        ok = (fmt, list(palette), pixels) == shown
+        print("loopback: capture %s the image shown" % ("matches" if ok else "DIFFERS from"))
+        sys.exit(not ok)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,232 @@
+"""Dithering for tools/imgconv.py.
+
+Direct colour formats keep the top bits of each channel and the TMDS
+encoders zero-fill the rest, so a channel with b bits can show the levels
+0, s, 2s, ... (2^b - 1)s with s = 2^(8 - b). dither_rgb() maps an image onto
+those levels; dither_palette() maps it onto the entries of a palette.
+
+Methods:
+  none       round down (direct) or nearest entry (palette), which bands
+  ordered    8x8 Bayer threshold matrix
+  bluenoise  64x64 void-and-cluster threshold texture, no visible pattern
+  fs         Floyd-Steinberg error diffusion
+
+frc_phases() instead makes several images to be shown in turn, whose
+average over time comes closer to the original than any one of them.
+
+The image is split into horizontal bands that are dithered in parallel
+worker processes. Threshold methods tile by absolute position, so bands
+join seamlessly; error diffusion does not carry error across a band edge.
+Within a band, Floyd-Steinberg is vectorised along anti-diagonals
+(x + 2y = t), whose pixels do not depend on each other.
+"""
+
+import functools
+import os
+from concurrent.futures import ProcessPoolExecutor
+
+import numpy as np
+
+METHODS = ("none", "ordered", "bluenoise", "fs")
+
+# Rows per band, at least; small bands cost more in fs seams than they save.
+MIN_BAND_ROWS = 32
+
+
+def bayer(n=8):
+    """n x n Bayer thresholds in [0, 1)."""
+    m = np.zeros((1, 1))
+    while m.shape[0] < n:
+        m = np.block([[4 * m, 4 * m + 2], [4 * m + 3, 4 * m + 1]])
+    return (m + 0.5) / m.size
+
+
+@functools.lru_cache(maxsize=None)
+def blue_noise(size=64, sigma=1.5, seed=1):
+    """size x size blue-noise thresholds in [0, 1) by void-and-cluster."""
+    n = size * size
+    d = np.minimum(np.arange(size), size - np.arange(size))
+    kernel = np.exp(-(d[:, None] ** 2 + d[None, :] ** 2) / (2 * sigma ** 2))
+
+    def splat(energy, y, x, sign):
+        energy += sign * np.roll(np.roll(kernel, y, 0), x, 1)
+
+    def energy_of(bits):
+        return np.real(np.fft.ifft2(np.fft.fft2(bits) * np.fft.fft2(kernel)))
+
+    rng = np.random.default_rng(seed)
+    bits = np.zeros((size, size), dtype=bool)
+    bits.flat[rng.choice(n, n // 10, replace=False)] = True
+
+    # Relax the initial pattern: move the tightest cluster into the largest
+    # void until that stops changing anything.
+    energy = energy_of(bits)
+    while True:
+        cluster = np.unravel_index(np.argmax(np.where(bits, energy, -np.inf)), bits.shape)
+        bits[cluster] = False
+        splat(energy, *cluster, -1)
+        void = np.unravel_index(np.argmin(np.where(bits, np.inf, energy)), bits.shape)
+        bits[void] = True
+        splat(energy, *void, +1)
+        if void == cluster:
+            break
+    initial, initial_energy = bits.copy(), energy.copy()
+
+    rank = np.zeros((size, size), dtype=np.int32)
+    ones = int(bits.sum())
+    # Ranks below the initial pattern: remove tightest clusters.
+    for r in range(ones - 1, -1, -1):
+        cluster = np.unravel_index(np.argmax(np.where(bits, energy, -np.inf)), bits.shape)
+        bits[cluster] = False
+        splat(energy, *cluster, -1)
+        rank[cluster] = r
+    # Ranks above it: fill the largest voids.
+    bits, energy = initial, initial_energy
+    for r in range(ones, n):
+        void = np.unravel_index(np.argmin(np.where(bits, np.inf, energy)), bits.shape)
+        bits[void] = True
+        splat(energy, *void, +1)
+        rank[void] = r
+    return (rank + 0.5) / n
+
+
+def threshold_matrix(method):
+    return bayer() if method == "ordered" else blue_noise()
+
+
+def threshold_map(m, y0, height, width):
+    """Tile m over rows y0..y0+height by absolute position."""
+    ys = (np.arange(y0, y0 + height) % m.shape[0])[:, None]
+    xs = (np.arange(width) % m.shape[1])[None, :]
+    return m[ys, xs]
+
+
+# ----------------------------------------------------------------------------
+# Quantisers: map float RGB pixels (..., 3) to representable colours.
+
+class Levels:
+    """Per-channel levels of a direct colour format with the given bits."""
+
+    def __init__(self, bits):
+        self.step = np.array([1 << (8 - b) for b in bits], dtype=np.float32)
+        self.top = np.array([(1 << b) - 1 for b in bits], dtype=np.float32)
+        self.spread = self.step
+
+    def clamp(self, v):
+        return np.clip(v, 0, self.top * self.step)
+
+    def nearest(self, v):
+        return np.clip(np.floor(v / self.step + 0.5), 0, self.top) * self.step
+
+    def floor(self, v):
+        return np.clip(np.floor(v / self.step), 0, self.top) * self.step
+
+
+class Palette:
+    """Nearest-entry lookup into an (K, 3) palette."""
+
+    def __init__(self, palette):
+        self.colours = np.asarray(palette, dtype=np.float32)
+        self.norms = (self.colours ** 2).sum(axis=1)
+        # Typical distance between neighbouring entries, as the threshold
+        # amplitude for ordered dithering.
+        d = ((self.colours[:, None, :] - self.colours[None, :, :]) ** 2).sum(axis=2)
+        np.fill_diagonal(d, np.inf)
+        near = np.sqrt(d.min(axis=1)) if len(self.colours) > 1 else np.array([255.0])
+        self.spread = np.float32(np.median(near))
+
+    def clamp(self, v):
+        return np.clip(v, 0, 255)
+
+    def index(self, v):
+        flat = v.reshape(-1, 3)
+        out = np.empty(len(flat), dtype=np.uint8)
+        for i in range(0, len(flat), 4096):
+            p = flat[i:i + 4096]
+            out[i:i + 4096] = np.argmin(self.norms[None, :] - 2 * p @ self.colours.T, axis=1)
+        return out.reshape(v.shape[:-1])
+
+    def nearest(self, v):
+        return self.colours[self.index(v)]
+
+    floor = nearest
+
+
+# ----------------------------------------------------------------------------
+# Band workers. Return float RGB of representable colours.
+
+def floyd_steinberg(img, q):
+    work = img.astype(np.float32)
+    h, w, _ = work.shape
+    out = np.empty_like(work)
+    for t in range(w + 2 * (h - 1)):
+        ys = np.arange(max(0, (t - w + 2) // 2), min(h - 1, t // 2) + 1)
+        xs = t - 2 * ys
+        old = q.clamp(work[ys, xs])
+        new = q.nearest(old)
+        out[ys, xs] = new
+        err = old - new
+        right = xs + 1 < w
+        work[ys[right], xs[right] + 1] += err[right] * (7 / 16)
+        below = ys + 1 < h
+        m = below & (xs > 0)
+        work[ys[m] + 1, xs[m] - 1] += err[m] * (3 / 16)
+        work[ys[below] + 1, xs[below]] += err[below] * (5 / 16)
+        m = below & right
+        work[ys[m] + 1, xs[m] + 1] += err[m] * (1 / 16)
+    return out
+
+
+def dither_band(img, q, method, y0, matrix):
+    if method == "none":
+        return q.floor(img.astype(np.float32))
+    if method == "fs":
+        return floyd_steinberg(img, q)
+    t = threshold_map(matrix, y0, img.shape[0], img.shape[1])[..., None]
+    return q.nearest(img.astype(np.float32) + (t - 0.5) * q.spread)
+
+
+def run_bands(rgb, q, method, jobs):
+    jobs = jobs or os.cpu_count() or 1
+    rows = rgb.shape[0]
+    bands = max(1, min(jobs, rows // MIN_BAND_ROWS))
+    # Built once here and handed to the workers.
+    matrix = threshold_matrix(method) if method in ("ordered", "bluenoise") else None
+    if bands == 1:
+        return dither_band(rgb, q, method, 0, matrix)
+    edges = [rows * i // bands for i in range(bands + 1)]
+    with ProcessPoolExecutor(max_workers=bands) as pool:
+        parts = pool.map(dither_band, [rgb[a:b] for a, b in zip(edges, edges[1:])],
+                         [q] * bands, [method] * bands, edges[:-1], [matrix] * bands)
+        return np.concatenate(list(parts))
+
+
+def dither_rgb(rgb, bits, method="none", jobs=None):
+    """Map HxWx3 uint8 RGB onto the levels of a format with per-channel
+    bits (e.g. (3, 3, 2)); returns uint8 RGB that packs without loss."""
+    out = run_bands(rgb, Levels(bits), method, jobs)
+    return out.astype(np.uint8)
+
+
+def dither_palette(rgb, palette, method="none", jobs=None):
+    """Map HxWx3 uint8 RGB onto palette entries; returns HxW indices."""
+    q = Palette(palette)
+    out = run_bands(rgb, q, method, jobs)
+    return q.index(out)
+
+
+def frc_phases(rgb, bits, phases, method="none"):
+    """phases HxWx3 uint8 images for frame-rate control. Each pixel's
+    threshold advances by 1/phases from one phase to the next, so a pixel
+    a fraction f of the way between two levels shows the upper one in
+    about f of the phases. "ordered" and "bluenoise" offset the thresholds
+    spatially as well, so neighbours do not switch together."""
+    q = Levels(bits)
+    h, w, _ = rgb.shape
+    if method == "none":
+        t = np.full((h, w), 0.5 / phases, dtype=np.float32)
+    else:
+        t = threshold_map(threshold_matrix(method), 0, h, w)
+    img = rgb.astype(np.float32)
+    return [q.nearest(img + (np.mod(t + k / phases, 1.0)[..., None] - 0.5) * q.spread).astype(np.uint8)
+            for k in range(phases)]
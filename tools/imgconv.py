@@ -0,0 +1,460 @@
+#!/usr/bin/env python3
+"""Convert PNG/JPEG images into binary assets for the firmware.
+
+    python3 tools/imgconv.py images/Mario.jpg -f rgb332 -o images/mario_640x480_rgb332.bin
+
+writes the pixels to the .bin and their metadata (size, format, packing,
+palette) to a header next to it, here images/mario_640x480_rgb332.h. Link
+the binary in with asset_embed() from assets/CMakeLists.txt and include the
+header; assets/asset.h describes the formats. Needs Pillow and numpy.
+
+--c-array writes the pixels as a C array header instead, the way images
+were embedded before; tools/bench_compile.py compares the two.
+
+--phases 2 or 4 writes frame-rate control phases of a direct colour image
+for dvi_set_line_table(): the distinct lines of all phases go to the .bin,
+and the header holds the per-frame line pointer tables.
+"""
+
+import argparse
+import os
+import sys
+
+import numpy as np
+from PIL import Image
+
+import palette as pal
+from dither import METHODS, dither_palette, dither_rgb, frc_phases
+
+# Must match asset_format_t and asset_pack_t in assets/asset.h.
+FORMATS = {"rgb332": 0, "rgb565": 1, "pal8": 2, "pal4": 3}
+PACKS = {"none": 0, "rle": 1, "qoi": 2}
+# Bits kept per channel by the direct colour formats.
+CHANNEL_BITS = {"rgb332": (3, 3, 2), "rgb565": (5, 6, 5)}
+
+
+def load(path, crop=None, resize=None):
+    """Return the image as an HxWx3 uint8 array."""
+    img = Image.open(path).convert("RGB")
+    if crop:
+        x, y, w, h = crop
+        img = img.crop((x, y, x + w, y + h))
+    if resize:
+        img = img.resize(resize, Image.Resampling.LANCZOS)
+    return np.asarray(img, dtype=np.uint8)
+
+
+def rgb332(rgb):
+    r, g, b = (rgb[..., i].astype(np.uint8) for i in range(3))
+    return (r & 0xE0) | ((g & 0xE0) >> 3) | (b >> 6)
+
+
+def rgb565(rgb):
+    r, g, b = (rgb[..., i].astype(np.uint16) for i in range(3))
+    return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3)
+
+
+def rgb565_word(r, g, b):
+    return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3)
+
+
+def encode(rgb, fmt, colours=None, dither="none", jobs=None, palette=None):
+    """Return (HxN array of line bytes before padding, palette or None).
+    Indexed formats build a palette for the image unless one is given."""
+    if fmt in CHANNEL_BITS:
+        # Dithered pixels are exactly representable, so packing only drops
+        # zero bits.
+        rgb = dither_rgb(rgb, CHANNEL_BITS[fmt], dither, jobs)
+        if fmt == "rgb332":
+            return rgb332(rgb), None
+        return rgb565(rgb).astype("<u2").view(np.uint8), None
+    if palette is None:
+        palette = pal.build([rgb], colours or (256 if fmt == "pal8" else 16), jobs=jobs)
+    if dither != "none":
+        idx = dither_palette(rgb, palette, dither, jobs)
+    else:
+        idx = pal.index(rgb, palette, jobs)
+    if fmt == "pal4":
+        if idx.shape[1] % 2:
+            idx = np.pad(idx, ((0, 0), (0, 1)))
+        idx = idx[:, 0::2] | (idx[:, 1::2] << 4)
+    return idx, palette
+
+
+def pad_lines(lines):
+    """Pad each line to a multiple of 4 bytes, as the DMA moves words."""
+    stride = (lines.shape[1] + 3) & ~3
+    return np.pad(lines, ((0, 0), (0, stride - lines.shape[1]))), stride
+
+
+def rle_line(line, unit):
+    """Run-length code one line of units, see ASSET_PACK_RLE."""
+    units = [bytes(line[i:i + unit]) for i in range(0, len(line), unit)]
+    out = bytearray()
+    i = 0
+    n = len(units)
+    while i < n:
+        j = i + 1
+        while j < n and j - i < 129 and units[j] == units[i]:
+            j += 1
+        if j - i >= 2:
+            out.append(j - i + 126)
+            out += units[i]
+            i = j
+            continue
+        j = i + 1
+        while j < n and j - i < 128 and not (j + 1 < n and units[j] == units[j + 1]):
+            j += 1
+        out.append(j - i - 1)
+        for u in units[i:j]:
+            out += u
+        i = j
+    return bytes(out)
+
+
+def qoi_hash(unit):
+    return ((unit * 2654435761) & 0xFFFFFFFF) >> 26
+
+
+def wrap(d, bits):
+    """d as a signed value of bits bits."""
+    half = 1 << (bits - 1)
+    return ((d + half) & (2 * half - 1)) - half
+
+
+def qoi_delta(p, u, fmt):
+    """The 01/10 op taking unit p to u, or None. See ASSET_PACK_QOI."""
+    if fmt == "rgb565":
+        dr, dg, db = (wrap((u >> s) - (p >> s), n) for s, n in ((11, 5), (5, 6), (0, 5)))
+        if -2 <= dr < 2 and -2 <= dg < 2 and -2 <= db < 2:
+            return bytes([0x40 | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2)])
+        dr, db = wrap(dr - (dg >> 1), 5), wrap(db - (dg >> 1), 5)
+        if -8 <= dr < 8 and -8 <= db < 8:
+            return bytes([0x80 | (dg + 32), (dr + 8) << 4 | (db + 8)])
+        return None
+    if fmt == "rgb332":
+        dr, dg, db = (wrap((u >> s) - (p >> s), n) for s, n in ((5, 3), (2, 3), (0, 2)))
+        if -2 <= dr < 2 and -2 <= dg < 2:
+            return bytes([0x40 | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2)])
+        return None
+    d = wrap(u - p, 8)
+    return bytes([0x40 | (d + 32)]) if -32 <= d < 32 else None
+
+
+def qoi_pack(data, fmt):
+    """Code the padded lines as one ASSET_PACK_QOI stream."""
+    unit = 2 if fmt == "rgb565" else 1
+    units = np.frombuffer(data, "<u2" if unit == 2 else np.uint8).tolist()
+    out = bytearray()
+    index = [0] * 64
+    p, run = 0, 0
+    for u in units:
+        if u == p:
+            run += 1
+            if run == 62:
+                out.append(0xC0 | 61)
+                run = 0
+            continue
+        if run:
+            out.append(0xC0 | (run - 1))
+            run = 0
+        h = qoi_hash(u)
+        if index[h] == u:
+            out.append(h)
+        else:
+            index[h] = u
+            op = qoi_delta(p, u, fmt)
+            out += op if op else bytes([0xFE]) + u.to_bytes(unit, "little")
+        p = u
+    if run:
+        out.append(0xC0 | (run - 1))
+    return bytes(out)
+
+
+def qoi_unpack(data, fmt, count):
+    """Decode count pixel units from an ASSET_PACK_QOI stream, as bytes."""
+    unit = 2 if fmt == "rgb565" else 1
+    out = np.zeros(count, "<u2" if unit == 2 else np.uint8)
+    index = [0] * 64
+    p, n, i = 0, 0, 0
+    while n < count:
+        op = data[i]
+        i += 1
+        if op < 0x40:
+            p = index[op]
+        elif op >= 0xFE:
+            if op == 0xFF:
+                raise ValueError("reserved QOI op at byte %d" % (i - 1))
+            p = int.from_bytes(data[i:i + unit], "little")
+            i += unit
+            index[qoi_hash(p)] = p
+        elif op >= 0xC0:
+            k = min((op & 63) + 1, count - n)
+            out[n:n + k] = p
+            n += k
+            continue
+        elif fmt == "rgb565":
+            if op < 0x80:
+                dr, dg, db = (op >> 4 & 3) - 2, (op >> 2 & 3) - 2, (op & 3) - 2
+            else:
+                dg = (op & 63) - 32
+                rb = data[i]
+                i += 1
+                dr, db = (dg >> 1) + (rb >> 4) - 8, (dg >> 1) + (rb & 15) - 8
+            p = ((p >> 11) + dr & 31) << 11 | ((p >> 5) + dg & 63) << 5 | (p + db & 31)
+            index[qoi_hash(p)] = p
+        elif op >= 0x80:
+            raise ValueError("QOI luma op in %s at byte %d" % (fmt, i - 1))
+        elif fmt == "rgb332":
+            dr, dg, db = (op >> 4 & 3) - 2, (op >> 2 & 3) - 2, (op & 3) - 2
+            p = ((p >> 5) + dr & 7) << 5 | ((p >> 2) + dg & 7) << 2 | (p + db & 3)
+            index[qoi_hash(p)] = p
+        else:
+            p = (p + (op & 63) - 32) & 255
+            index[qoi_hash(p)] = p
+        out[n] = p
+        n += 1
+    return out.tobytes()
+
+
+def pack_lines(lines, fmt, pack):
+    """The .bin contents for padded lines."""
+    if pack == "rle":
+        unit = 2 if fmt == "rgb565" else 1
+        return b"".join(rle_line(line.tobytes(), unit) for line in lines)
+    if pack == "qoi":
+        return qoi_pack(lines.tobytes(), fmt)
+    return lines.tobytes()
+
+
+def c_ident(name):
+    return "".join(c if c.isalnum() else "_" for c in name)
+
+
+def write_header(path, name, source, meta, palette, shared=None):
+    """shared is the (name, header path) of a palette written by
+    write_palette_header(), which the image then refers to."""
+    macro = c_ident(name).upper()
+    guard = "_%s_H" % macro
+    fmt, pack = meta["format"], meta["pack"]
+    out = [
+        "// Generated by tools/imgconv.py from %s; do not edit." % os.path.basename(source),
+        "// %s %dx%d, %d bytes" % (" ".join(v for v in (fmt, pack, meta["dither"]) if v != "none"),
+                                  meta["width"], meta["height"], meta["size"]),
+        "",
+        "#ifndef %s" % guard,
+        "#define %s" % guard,
+        "",
+        '#include "asset.h"',
+    ]
+    if shared:
+        out.append('#include "%s"' % os.path.basename(shared[1]))
+    out.append("")
+    for key in ("width", "height", "stride", "size"):
+        out.append("#define %s_%s %d" % (macro, key.upper(), meta[key]))
+    out += [
+        "",
+        "#ifdef __cplusplus",
+        'extern "C" {',
+        "#endif",
+        "extern const uint8_t %s[];" % name,
+        "#ifdef __cplusplus",
+        "}",
+        "#endif",
+        "",
+    ]
+    pal_name = "NULL"
+    if shared:
+        pal_name = shared[0]
+    elif palette:
+        pal_name = "%s_palette" % name
+        out += palette_array(pal_name, palette)
+    out += [
+        "static const asset_image_t %s_image = {" % name,
+        "    %s, %d, %d, %d, %d," % (name, meta["size"], meta["width"], meta["height"], meta["stride"]),
+        "    ASSET_FORMAT_%s, ASSET_PACK_%s, %d, %s," % (fmt.upper(), pack.upper(),
+                                                      len(palette or []), pal_name),
+        "};",
+        "",
+        "#endif",
+        "",
+    ]
+    with open(path, "w") as f:
+        f.write("\n".join(out))
+
+
+def palette_array(name, palette):
+    out = ["static const uint16_t %s[%d] = {" % (name, len(palette))]
+    words = ["0x%04x," % rgb565_word(r, g, b) for r, g, b in palette]
+    for i in range(0, len(words), 8):
+        out.append("    " + " ".join(words[i:i + 8]))
+    return out + ["};", ""]
+
+
+def write_palette_header(path, name, sources, palette):
+    """A palette shared by several images, in the driver's RGB565 format."""
+    guard = "_%s_H" % c_ident(name).upper()
+    out = [
+        "// Generated by tools/quantize.py from %s; do not edit."
+        % ", ".join(os.path.basename(s) for s in sources),
+        "// %d colours" % len(palette),
+        "",
+        "#ifndef %s" % guard,
+        "#define %s" % guard,
+        "",
+        "#include <stdint.h>",
+        "",
+        "#define %s_SIZE %d" % (c_ident(name).upper(), len(palette)),
+        "",
+    ]
+    out += palette_array(name, palette)
+    out += ["#endif", ""]
+    with open(path, "w") as f:
+        f.write("\n".join(out))
+
+
+def frc_tables(phases, lines):
+    """Pool the distinct lines of phases (lists of line bytes, one per
+    source row) and build one table per frame of pool indices for each of
+    lines display lines. Frame f shows source row y * rows // lines in
+    phase (f + y) % len(phases), so neighbouring lines are out of step."""
+    rows = len(phases[0])
+    pool, where = [], {}
+    for phase in phases:
+        for line in phase:
+            if line not in where:
+                where[line] = len(pool)
+                pool.append(line)
+    n = len(phases)
+    tables = [[where[phases[(f + y) % n][y * rows // lines]] for y in range(lines)] for f in range(n)]
+    return pool, tables
+
+
+def write_frc_header(path, name, source, meta, tables):
+    macro = c_ident(name).upper()
+    guard = "_%s_H" % macro
+    out = [
+        "// Generated by tools/imgconv.py from %s; do not edit." % os.path.basename(source),
+        "// %s %d FRC phases %dx%d, %d distinct lines, %d bytes"
+        % (meta["format"], len(tables), meta["width"], meta["lines"], meta["pool_lines"], meta["size"]),
+        "",
+        "#ifndef %s" % guard,
+        "#define %s" % guard,
+        "",
+        "#include <stdint.h>",
+        "",
+    ]
+    for key in ("width", "lines", "stride", "size", "phases"):
+        out.append("#define %s_%s %d" % (macro, key.upper(), meta[key]))
+    out += [
+        "",
+        "#ifdef __cplusplus",
+        'extern "C" {',
+        "#endif",
+        "extern const uint8_t %s[];" % name,
+        "#ifdef __cplusplus",
+        "}",
+        "#endif",
+        "",
+        "// One table per frame. Not const, so it is in RAM where the DMA IRQ reads",
+        "// it without touching flash.",
+        "static const void *%s_lines[%d] = {" % (name, len(tables) * meta["lines"]),
+    ]
+    for table in tables:
+        for i in range(0, len(table), 4):
+            out.append("    " + " ".join("%s + %d," % (name, n * meta["stride"]) for n in table[i:i + 4]))
+    out += ["};", "", "#endif", ""]
+    with open(path, "w") as f:
+        f.write("\n".join(out))
+
+
+def write_c_array(path, name, data):
+    """The pre-asset_embed() layout: a hex array in a named data section."""
+    with open(path, "w") as f:
+        f.write("#ifndef _IMG_ASSET_SECTION\n#define _IMG_ASSET_SECTION \".data\"\n#endif\n\n")
+        f.write("const char __attribute__((aligned(4), section(_IMG_ASSET_SECTION \".%s\"))) %s[] = {\n"
+                % (name, name))
+        for i in range(0, len(data), 12):
+            f.write("  " + "".join("0x%02X, " % b for b in data[i:i + 12]) + "\n")
+        f.write("};\n")
+
+
+def frc(args, name, rgb):
+    height, width = rgb.shape[:2]
+    phases = frc_phases(rgb, CHANNEL_BITS[args.format], args.phases, args.dither)
+    packed = [pad_lines(encode(p, args.format)[0]) for p in phases]
+    stride = packed[0][1]
+    lines = args.lines or height
+    pool, tables = frc_tables([[line.tobytes() for line in p[0]] for p in packed], lines)
+    data = b"".join(pool)
+    with open(args.output, "wb") as f:
+        f.write(data)
+    meta = {"width": width, "lines": lines, "stride": stride, "size": len(data),
+            "phases": args.phases, "pool_lines": len(pool), "format": args.format}
+    write_frc_header(args.header or os.path.splitext(args.output)[0] + ".h", name, args.source, meta, tables)
+    average = np.mean([p.astype(np.float64) for p in phases], axis=0)
+    print("%s: %s %d phases %dx%d, %d distinct lines, %d bytes; PSNR %.2f dB one phase, %.2f dB averaged"
+          % (name, args.format, args.phases, width, lines, len(pool), len(data),
+             pal.psnr(rgb, phases[0]), pal.psnr(rgb, average)))
+
+
+def parse_size(s):
+    w, h = s.lower().split("x")
+    return int(w), int(h)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("source", help="PNG, JPEG or anything else Pillow reads")
+    ap.add_argument("-o", "--output", required=True, help="output .bin")
+    ap.add_argument("-f", "--format", choices=FORMATS, default="rgb332")
+    ap.add_argument("-p", "--pack", choices=PACKS, default="none")
+    ap.add_argument("-n", "--name", help="C symbol (default: output file name)")
+    ap.add_argument("--header", help="metadata header (default: output with .h)")
+    ap.add_argument("--crop", type=lambda s: tuple(int(v) for v in s.split(",")),
+                    metavar="X,Y,W,H", help="crop before resizing")
+    ap.add_argument("--resize", type=parse_size, metavar="WxH")
+    ap.add_argument("--colours", type=int, help="palette size for pal8/pal4")
+    ap.add_argument("-d", "--dither", choices=METHODS, default="none",
+                    help="see tools/dither.py (default: truncate)")
+    ap.add_argument("-j", "--jobs", type=int, help="workers (default: CPU count)")
+    ap.add_argument("--phases", type=int, choices=(2, 4), help="write FRC phases (rgb332/rgb565)")
+    ap.add_argument("--lines", type=int, help="display lines of the FRC tables (default: height)")
+    ap.add_argument("--c-array", metavar="PATH", help="write a C array header instead")
+    args = ap.parse_args()
+
+    name = args.name or c_ident(os.path.splitext(os.path.basename(args.output))[0])
+    rgb = load(args.source, args.crop, args.resize)
+    height, width = rgb.shape[:2]
+    if height > 0xFFFF or width > 0xFFFF:
+        sys.exit("imgconv: %dx%d is too large" % (width, height))
+    if args.colours and not 2 <= args.colours <= (256 if args.format == "pal8" else 16):
+        sys.exit("imgconv: --colours out of range for %s" % args.format)
+
+    if args.phases:
+        if args.format not in CHANNEL_BITS or args.pack != "none" or args.dither == "fs":
+            sys.exit("imgconv: --phases needs rgb332 or rgb565, no packing and a threshold dither")
+        frc(args, name, rgb)
+        return
+
+    lines, palette = encode(rgb, args.format, args.colours, args.dither, args.jobs)
+    lines, stride = pad_lines(lines)
+    data = pack_lines(lines, args.format, args.pack)
+
+    if args.c_array:
+        write_c_array(args.c_array, name, data)
+        return
+
+    with open(args.output, "wb") as f:
+        f.write(data)
+    meta = {"width": width, "height": height, "stride": stride, "size": len(data),
+            "format": args.format, "pack": args.pack, "dither": args.dither}
+    header = args.header or os.path.splitext(args.output)[0] + ".h"
+    write_header(header, name, args.source, meta, palette)
+    print("%s: %s %dx%d stride %d, %d bytes (%.1f%% of unpacked)%s"
+          % (name, args.format, width, height, stride, len(data), 100.0 * len(data) / (stride * height),
+             ", %d colours" % len(palette) if palette else ""))
+
+
+if __name__ == "__main__":
+    main()
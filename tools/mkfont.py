@@ -0,0 +1,249 @@
+#!/usr/bin/env python3
+"""Write the text mode font, dvi_hstx/text_font.c.
+
+    python3 tools/mkfont.py
+    python3 tools/mkfont.py --psf /usr/share/consolefonts/Lat15-VGA16.psf.gz
+
+The built-in font has 8x8 ASCII glyphs after the public-domain IBM PC
+style font8x8, with each row doubled, and draws the CP437 shades, blocks
+and box-drawing characters (0xB0-0xDF) at the full 8x16. --psf takes the
+first 256 glyphs of an 8x16 PSF1 or PSF2 console font instead, as the
+Linux console stores them. Glyphs are 16 bytes, a byte per row, bit 7
+leftmost; text.h describes the cells that refer to them.
+"""
+
+import argparse
+import gzip
+import os
+import struct
+import sys
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+GLYPHS = 256
+HEIGHT = 16
+
+# Rows top to bottom, bit 0 leftmost.
+ASCII_8X8 = {
+    0x20: "0000000000000000",  # space
+    0x21: "183C3C1818001800",  # !
+    0x22: "3636000000000000",  # "
+    0x23: "36367F367F363600",  # #
+    0x24: "0C3E031E301F0C00",  # $
+    0x25: "006333180C666300",  # %
+    0x26: "1C361C6E3B336E00",  # &
+    0x27: "0606030000000000",  # '
+    0x28: "180C0606060C1800",  # (
+    0x29: "060C1818180C0600",  # )
+    0x2A: "00663CFF3C660000",  # *
+    0x2B: "000C0C3F0C0C0000",  # +
+    0x2C: "00000000000C0C06",  # ,
+    0x2D: "0000003F00000000",  # -
+    0x2E: "00000000000C0C00",  # .
+    0x2F: "6030180C06030100",  # /
+    0x30: "3E63737B6F673E00",  # 0
+    0x31: "0C0E0C0C0C0C3F00",  # 1
+    0x32: "1E33301C06333F00",  # 2
+    0x33: "1E33301C30331E00",  # 3
+    0x34: "383C36337F307800",  # 4
+    0x35: "3F031F3030331E00",  # 5
+    0x36: "1C06031F33331E00",  # 6
+    0x37: "3F3330180C0C0C00",  # 7
+    0x38: "1E33331E33331E00",  # 8
+    0x39: "1E33333E30180E00",  # 9
+    0x3A: "000C0C00000C0C00",  # :
+    0x3B: "000C0C00000C0C06",  # ;
+    0x3C: "180C0603060C1800",  # <
+    0x3D: "00003F00003F0000",  # =
+    0x3E: "060C1830180C0600",  # >
+    0x3F: "1E3330180C000C00",  # ?
+    0x40: "3E637B7B7B031E00",  # @
+    0x41: "0C1E33333F333300",  # A
+    0x42: "3F66663E66663F00",  # B
+    0x43: "3C66030303663C00",  # C
+    0x44: "1F36666666361F00",  # D
+    0x45: "7F46161E16467F00",  # E
+    0x46: "7F46161E16060F00",  # F
+    0x47: "3C66030373667C00",  # G
+    0x48: "3333333F33333300",  # H
+    0x49: "1E0C0C0C0C0C1E00",  # I
+    0x4A: "7830303033331E00",  # J
+    0x4B: "6766361E36666700",  # K
+    0x4C: "0F06060646667F00",  # L
+    0x4D: "63777F7F6B636300",  # M
+    0x4E: "63676F7B73636300",  # N
+    0x4F: "1C36636363361C00",  # O
+    0x50: "3F66663E06060F00",  # P
+    0x51: "1E3333333B1E3800",  # Q
+    0x52: "3F66663E36666700",  # R
+    0x53: "1E33070E38331E00",  # S
+    0x54: "3F2D0C0C0C0C1E00",  # T
+    0x55: "3333333333333F00",  # U
+    0x56: "33333333331E0C00",  # V
+    0x57: "6363636B7F776300",  # W
+    0x58: "6363361C1C366300",  # X
+    0x59: "3333331E0C0C1E00",  # Y
+    0x5A: "7F6331184C667F00",  # Z
+    0x5B: "1E06060606061E00",  # [
+    0x5C: "03060C1830604000",  # backslash
+    0x5D: "1E18181818181E00",  # ]
+    0x5E: "081C366300000000",  # ^
+    0x5F: "00000000000000FF",  # _
+    0x60: "0C0C180000000000",  # `
+    0x61: "00001E303E336E00",  # a
+    0x62: "0706063E66663B00",  # b
+    0x63: "00001E3303331E00",  # c
+    0x64: "3830303E33336E00",  # d
+    0x65: "00001E333F031E00",  # e
+    0x66: "1C36060F06060F00",  # f
+    0x67: "00006E33333E301F",  # g
+    0x68: "0706366E66666700",  # h
+    0x69: "0C000E0C0C0C1E00",  # i
+    0x6A: "300030303033331E",  # j
+    0x6B: "070666361E366700",  # k
+    0x6C: "0E0C0C0C0C0C1E00",  # l
+    0x6D: "0000337F7F6B6300",  # m
+    0x6E: "00001F3333333300",  # n
+    0x6F: "00001E3333331E00",  # o
+    0x70: "00003B66663E060F",  # p
+    0x71: "00006E33333E3078",  # q
+    0x72: "00003B6E66060F00",  # r
+    0x73: "00003E031E301F00",  # s
+    0x74: "080C3E0C0C2C1800",  # t
+    0x75: "0000333333336E00",  # u
+    0x76: "00003333331E0C00",  # v
+    0x77: "0000636B7F7F3600",  # w
+    0x78: "000063361C366300",  # x
+    0x79: "00003333333E301F",  # y
+    0x7A: "00003F190C263F00",  # z
+    0x7B: "380C0C070C0C3800",  # {
+    0x7C: "1818180018181800",  # |
+    0x7D: "070C0C380C0C0700",  # }
+    0x7E: "6E3B000000000000",  # ~
+}
+
+# CP437 box drawing as line weights (0 none, 1 single, 2 double) towards
+# up, down, left and right.
+BOX = {
+    0xB3: (1, 1, 0, 0), 0xB4: (1, 1, 1, 0), 0xB5: (1, 1, 2, 0), 0xB6: (2, 2, 1, 0),
+    0xB7: (0, 2, 1, 0), 0xB8: (0, 1, 2, 0), 0xB9: (2, 2, 2, 0), 0xBA: (2, 2, 0, 0),
+    0xBB: (0, 2, 2, 0), 0xBC: (2, 0, 2, 0), 0xBD: (2, 0, 1, 0), 0xBE: (1, 0, 2, 0),
+    0xBF: (0, 1, 1, 0), 0xC0: (1, 0, 0, 1), 0xC1: (1, 0, 1, 1), 0xC2: (0, 1, 1, 1),
+    0xC3: (1, 1, 0, 1), 0xC4: (0, 0, 1, 1), 0xC5: (1, 1, 1, 1), 0xC6: (1, 1, 0, 2),
+    0xC7: (2, 2, 0, 1), 0xC8: (2, 0, 0, 2), 0xC9: (0, 2, 0, 2), 0xCA: (2, 0, 2, 2),
+    0xCB: (0, 2, 2, 2), 0xCC: (2, 2, 0, 2), 0xCD: (0, 0, 2, 2), 0xCE: (2, 2, 2, 2),
+    0xCF: (1, 0, 2, 2), 0xD0: (2, 0, 1, 1), 0xD1: (0, 1, 2, 2), 0xD2: (0, 2, 1, 1),
+    0xD3: (2, 0, 0, 1), 0xD4: (1, 0, 0, 2), 0xD5: (0, 1, 0, 2), 0xD6: (0, 2, 0, 1),
+    0xD7: (2, 2, 1, 1), 0xD8: (1, 1, 2, 2), 0xD9: (1, 0, 1, 0), 0xDA: (0, 1, 0, 1),
+}
+
+# Centre of a cell, and the two strokes of a double line, the first on the
+# up or left side.
+CX, CY = 3, 7
+DX = (2, 5)
+DY = (5, 9)
+
+
+def box_glyph(up, down, left, right):
+    """Each stroke runs from the edge to the centre, or for a line meeting a
+    double line to its near or far stroke, so corners and tees stay open."""
+    arms = {"up": up, "down": down, "left": left, "right": right}
+    pix = [[0] * 8 for _ in range(HEIGHT)]
+    for arm, weight in arms.items():
+        if not weight:
+            continue
+        vertical = arm in ("up", "down")
+        sides = ("left", "right") if vertical else ("up", "down")
+        opposite = {"up": "down", "down": "up", "left": "right", "right": "left"}[arm]
+        cross = max(arms[s] for s in sides)
+        centre, strokes_at = (CY, DY) if vertical else (CX, DX)
+        near, far = strokes_at if arm in ("up", "left") else strokes_at[::-1]
+        strokes = [(CX if vertical else CY, None)] if weight == 1 else list(zip(DX if vertical else DY, sides))
+        for pos, side in strokes:
+            if cross < 2 or (weight == 2 and not arms[side] and arms[opposite]):
+                end = centre
+            elif weight == 1:
+                end = near if all(arms[s] for s in sides) else far
+            else:
+                end = near if arms[side] else far
+            limit = HEIGHT if vertical else 8
+            span = range(0, end + 1) if arm in ("up", "left") else range(end, limit)
+            for a in span:
+                if vertical:
+                    pix[a][pos] = 1
+                else:
+                    pix[pos][a] = 1
+    return pix
+
+
+def builtin():
+    font = bytearray(GLYPHS * HEIGHT)
+    for c, hexrows in ASCII_8X8.items():
+        for r in range(8):
+            bits = int(hexrows[2 * r:2 * r + 2], 16)
+            row = int("{:08b}".format(bits)[::-1], 2)
+            font[c * HEIGHT + 2 * r] = font[c * HEIGHT + 2 * r + 1] = row
+    glyphs = {c: box_glyph(*w) for c, w in BOX.items()}
+    # Light, medium and dark shades.
+    for c, on in ((0xB0, lambda x, y: (x + 2 * y) % 4 == 0), (0xB1, lambda x, y: (x + y) % 2 == 0),
+                  (0xB2, lambda x, y: (x + 2 * y) % 4 != 0)):
+        glyphs[c] = [[int(on(x, y)) for x in range(8)] for y in range(HEIGHT)]
+    # Full, lower half, left half, right half and upper half blocks.
+    for c, on in ((0xDB, lambda x, y: True), (0xDC, lambda x, y: y >= HEIGHT // 2),
+                  (0xDD, lambda x, y: x < 4), (0xDE, lambda x, y: x >= 4), (0xDF, lambda x, y: y < HEIGHT // 2)):
+        glyphs[c] = [[int(on(x, y)) for x in range(8)] for y in range(HEIGHT)]
+    for c, pix in glyphs.items():
+        for y, row in enumerate(pix):
+            font[c * HEIGHT + y] = sum(bit << (7 - x) for x, bit in enumerate(row))
+    return bytes(font)
+
+
+def read_psf(path):
+    opener = gzip.open if path.endswith(".gz") else open
+    with opener(path, "rb") as f:
+        data = f.read()
+    if data[:2] == b"\x36\x04":
+        count = 512 if data[2] & 1 else 256
+        size, offset, width = data[3], 4, 8
+    elif data[:4] == b"\x72\xb5\x4a\x86":
+        _, offset, _, count, size, height, width = struct.unpack_from("<7I", data, 4)
+        if height != size:
+            width = 0
+    else:
+        sys.exit("mkfont: %s is not a PSF font" % path)
+    if width != 8 or size != HEIGHT or count < GLYPHS:
+        sys.exit("mkfont: %s is not an 8x16 font of 256 glyphs" % path)
+    return data[offset:offset + GLYPHS * HEIGHT]
+
+
+def write_font(path, font, source):
+    out = [
+        "// Generated by tools/mkfont.py from %s; do not edit." % source,
+        "",
+        '#include "text.h"',
+        "",
+        "// In RAM, as the scanline callback reads it from the IRQ.",
+        "const uint8_t __not_in_flash(\"text_font\") text_font_8x16[%d] = {" % len(font),
+    ]
+    for c in range(GLYPHS):
+        glyph = font[c * HEIGHT:(c + 1) * HEIGHT]
+        label = " // %r" % chr(c) if 0x20 <= c < 0x7F else ""
+        out.append("    " + " ".join("0x%02x," % b for b in glyph) + label)
+    out += ["};", ""]
+    with open(path, "w") as f:
+        f.write("\n".join(out))
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("--psf", help="8x16 PSF1/PSF2 console font, optionally gzipped")
+    ap.add_argument("-o", "--output", default=os.path.join(ROOT, "dvi_hstx", "text_font.c"))
+    args = ap.parse_args()
+    if args.psf:
+        font, source = read_psf(args.psf), os.path.basename(args.psf)
+    else:
+        font, source = builtin(), "its built-in glyphs"
+    write_font(args.output, font, source)
+
+
+if __name__ == "__main__":
+    main()
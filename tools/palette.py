@@ -0,0 +1,136 @@
+"""Palette generation for tools/imgconv.py and tools/quantize.py.
+
+Palettes are built over the distinct colours of one or more images, each
+weighted by how often it occurs, so a set of images can share one palette.
+Median cut gives the starting palette: the box of colours with the largest
+weighted squared error is split at the weighted median of its widest
+channel until there are enough boxes. k-means (Lloyd) iterations then move
+each entry to the mean of the colours nearest to it. The nearest-entry
+search, where nearly all the time goes, runs in threads over chunks of
+colours; numpy releases the GIL for the matrix products.
+
+Entries are snapped to RGB565 as the driver shows them: 5/6/5 bits, with
+the low bits zero.
+"""
+
+import os
+from concurrent.futures import ThreadPoolExecutor
+
+import numpy as np
+
+RGB565_STEP = np.array([8, 4, 8], dtype=np.float32)
+RGB565_TOP = np.array([31, 63, 31], dtype=np.float32)
+
+# Colours per nearest-entry search task.
+CHUNK = 16384
+
+
+def histogram(images):
+    """Distinct colours of HxWx3 uint8 images and their pixel counts."""
+    keys = np.concatenate([
+        (img[..., 0].astype(np.uint32) << 16 | img[..., 1].astype(np.uint32) << 8 | img[..., 2]).ravel()
+        for img in images])
+    keys, counts = np.unique(keys, return_counts=True)
+    colours = np.stack([keys >> 16, (keys >> 8) & 0xFF, keys & 0xFF], axis=1)
+    return colours.astype(np.float32), counts.astype(np.float64)
+
+
+def snap_rgb565(colours):
+    """Nearest colours the RGB565 scanout can show."""
+    return np.clip(np.floor(np.asarray(colours) / RGB565_STEP + 0.5), 0, RGB565_TOP) * RGB565_STEP
+
+
+def median_cut(colours, counts, k):
+    """Up to k weighted-mean colours of boxes split from the colour cube."""
+    boxes = [np.arange(len(colours))]
+
+    def cost(box):
+        c, w = colours[box], counts[box]
+        mean = (c * w[:, None]).sum(axis=0) / w.sum()
+        return float((((c - mean) ** 2).sum(axis=1) * w).sum())
+
+    costs = [cost(boxes[0])]
+    while len(boxes) < k:
+        i = int(np.argmax(costs))
+        if costs[i] <= 0:
+            break
+        box = boxes[i]
+        c = colours[box]
+        axis = int(np.argmax(c.max(axis=0) - c.min(axis=0)))
+        order = box[np.argsort(c[:, axis], kind="stable")]
+        cum = np.cumsum(counts[order])
+        cut = int(np.searchsorted(cum, cum[-1] / 2)) + 1
+        cut = min(max(cut, 1), len(order) - 1)
+        boxes[i:i + 1] = [order[:cut], order[cut:]]
+        costs[i:i + 1] = [cost(order[:cut]), cost(order[cut:])]
+    return np.array([(colours[b] * counts[b][:, None]).sum(axis=0) / counts[b].sum() for b in boxes],
+                    dtype=np.float32)
+
+
+def nearest(colours, palette, pool=None):
+    """Index of the nearest palette entry to each colour, and its squared
+    distance."""
+    norms = (palette ** 2).sum(axis=1)
+
+    def search(i):
+        c = colours[i:i + CHUNK]
+        d = norms[None, :] - 2 * c @ palette.T
+        idx = np.argmin(d, axis=1)
+        dist = d[np.arange(len(c)), idx] + (c ** 2).sum(axis=1)
+        return idx, np.maximum(dist, 0)
+
+    starts = range(0, len(colours), CHUNK)
+    parts = list(pool.map(search, starts)) if pool else [search(i) for i in starts]
+    if not parts:
+        return np.zeros(0, dtype=np.intp), np.zeros(0, dtype=np.float32)
+    return np.concatenate([p[0] for p in parts]), np.concatenate([p[1] for p in parts])
+
+
+def kmeans(colours, counts, palette, iterations=16, pool=None):
+    """Refine palette by weighted Lloyd iterations, stopping early once the
+    error stops improving by 0.1%. Entries left without colours stay put."""
+    palette = palette.copy()
+    last = np.inf
+    for _ in range(iterations):
+        idx, dist = nearest(colours, palette, pool)
+        err = float((dist * counts).sum())
+        if err >= last * 0.999:
+            break
+        last = err
+        w = np.bincount(idx, weights=counts, minlength=len(palette))
+        used = w > 0
+        for ch in range(3):
+            s = np.bincount(idx, weights=colours[:, ch] * counts, minlength=len(palette))
+            palette[used, ch] = s[used] / w[used]
+    return palette
+
+
+def build(images, k, iterations=16, jobs=None):
+    """One palette of at most k RGB565 entries for all of images, as a list
+    of (r, g, b)."""
+    colours, counts = histogram(images)
+    jobs = jobs or os.cpu_count() or 1
+    with ThreadPoolExecutor(max_workers=jobs) as pool:
+        palette = median_cut(colours, counts, k)
+        palette = kmeans(colours, counts, palette, iterations, pool)
+        # Snapping can merge entries; one more pass after it lets the
+        # survivors take over their colours.
+        palette = np.unique(snap_rgb565(palette), axis=0).astype(np.float32)
+        palette = snap_rgb565(kmeans(colours, counts, palette, 1, pool))
+    palette = np.unique(palette, axis=0)
+    return [tuple(int(v) for v in p) for p in palette]
+
+
+def index(rgb, palette, jobs=None):
+    """HxW nearest-entry indices of an HxWx3 uint8 image."""
+    colours, inverse = np.unique(rgb.reshape(-1, 3), axis=0, return_inverse=True)
+    jobs = jobs or os.cpu_count() or 1
+    with ThreadPoolExecutor(max_workers=jobs) as pool:
+        idx, _ = nearest(colours.astype(np.float32), np.asarray(palette, dtype=np.float32), pool)
+    return idx[inverse.ravel()].astype(np.uint8).reshape(rgb.shape[:2])
+
+
+def psnr(original, shown):
+    """Peak signal-to-noise ratio in dB over all channels."""
+    mse = np.mean((original.astype(np.float64) - shown.astype(np.float64)) ** 2)
+    return float("inf") if mse == 0 else 10 * np.log10(255.0 ** 2 / mse)
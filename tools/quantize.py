@@ -0,0 +1,120 @@
+#!/usr/bin/env python3
+"""Build palettes for images, alone or shared by a set, and report quality.
+
+    python3 tools/quantize.py images/Mario.jpg images/Mountains.png \\
+        --resize 640x480 -f pal8 --shared scenery_palette -o images
+
+builds one 256-colour palette for both images, writes it to
+images/scenery_palette.h and each image's indices to
+images/<name>_<W>x<H>_pal8.bin with the usual imgconv.py metadata header,
+which refers to the shared palette. Without --shared, each image gets its
+own palette in its header. tools/palette.py has the algorithm.
+
+For every image, prints the PSNR of how it would look in each format and
+what that format costs, so the smallest one that still looks right can be
+picked; --min-psnr names it. Without -o, only the report is printed.
+"""
+
+import argparse
+import os
+import sys
+
+import numpy as np
+
+import palette as pal
+from dither import METHODS, dither_palette, dither_rgb
+from imgconv import (CHANNEL_BITS, PACKS, c_ident, encode, load, pack_lines, pad_lines, parse_size,
+                     write_header, write_palette_header)
+
+COLOURS = {"pal4": 16, "pal8": 256}
+
+
+def shown(rgb, fmt, palette, dither, jobs):
+    """The image as the display would show it in fmt."""
+    if fmt in CHANNEL_BITS:
+        return dither_rgb(rgb, CHANNEL_BITS[fmt], dither, jobs)
+    colours = np.asarray(palette, dtype=np.uint8)
+    if dither != "none":
+        return colours[dither_palette(rgb, palette, dither, jobs)]
+    return colours[pal.index(rgb, palette, jobs)]
+
+
+def cost(rgb, fmt):
+    """Bytes for pixels (unpacked) plus palette."""
+    h, w = rgb.shape[:2]
+    line = {"rgb332": w, "rgb565": 2 * w, "pal8": w, "pal4": (w + 1) // 2}[fmt]
+    return ((line + 3) & ~3) * h + 2 * COLOURS.get(fmt, 0)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("sources", nargs="+")
+    ap.add_argument("-o", "--output-dir", help="write assets here (default: report only)")
+    ap.add_argument("-f", "--format", choices=COLOURS, default="pal8")
+    ap.add_argument("-p", "--pack", choices=PACKS, default="none")
+    ap.add_argument("--shared", metavar="NAME", help="one palette for all sources, in NAME.h")
+    ap.add_argument("--resize", type=parse_size, metavar="WxH")
+    ap.add_argument("--colours", type=int, help="palette size (default: 16 for pal4, 256 for pal8)")
+    ap.add_argument("--iterations", type=int, default=16, help="k-means iterations at most")
+    ap.add_argument("-d", "--dither", choices=METHODS, default="none")
+    ap.add_argument("-j", "--jobs", type=int, help="threads (default: CPU count)")
+    ap.add_argument("--min-psnr", type=float, metavar="DB", help="name the smallest format reaching DB")
+    args = ap.parse_args()
+
+    colours = args.colours or COLOURS[args.format]
+    if not 2 <= colours <= COLOURS[args.format]:
+        sys.exit("quantize: --colours out of range for %s" % args.format)
+    images = [load(s, resize=args.resize) for s in args.sources]
+
+    # The palettes for every indexed format are needed for the report.
+    palettes = {}
+    for fmt, k in COLOURS.items():
+        if fmt == args.format:
+            k = colours
+        if args.shared:
+            shared = pal.build(images, k, args.iterations, args.jobs)
+            palettes[fmt] = [shared] * len(images)
+        else:
+            palettes[fmt] = [pal.build([rgb], k, args.iterations, args.jobs) for rgb in images]
+
+    formats = ("rgb332", "pal4", "pal8", "rgb565")
+    print("%-32s" % "asset" + "".join("%18s" % f for f in formats))
+    for i, (source, rgb) in enumerate(zip(args.sources, images)):
+        h, w = rgb.shape[:2]
+        name = c_ident("%s_%dx%d_%s" % (os.path.splitext(os.path.basename(source))[0].lower(),
+                                        w, h, args.format))
+        row, best = "%-32s" % name, None
+        for fmt in formats:
+            db = pal.psnr(rgb, shown(rgb, fmt, palettes.get(fmt, [None] * len(images))[i],
+                                     args.dither, args.jobs))
+            size = cost(rgb, fmt)
+            row += "%8.2f dB %6dK" % (db, (size + 1023) // 1024)
+            if args.min_psnr is not None and db >= args.min_psnr and (best is None or size < best[1]):
+                best = (fmt, size)
+        if args.min_psnr is not None:
+            row += "  -> %s" % (best[0] if best else "none")
+        print(row)
+
+        if not args.output_dir:
+            continue
+        lines, palette = encode(rgb, args.format, dither=args.dither, jobs=args.jobs,
+                                palette=palettes[args.format][i])
+        lines, stride = pad_lines(lines)
+        data = pack_lines(lines, args.format, args.pack)
+        base = os.path.join(args.output_dir, name)
+        with open(base + ".bin", "wb") as f:
+            f.write(data)
+        meta = {"width": w, "height": h, "stride": stride, "size": len(data),
+                "format": args.format, "pack": args.pack, "dither": args.dither}
+        shared = None
+        if args.shared:
+            shared = (c_ident(args.shared), os.path.join(args.output_dir, args.shared + ".h"))
+        write_header(base + ".h", name, source, meta, palette, shared)
+
+    if args.output_dir and args.shared:
+        write_palette_header(os.path.join(args.output_dir, args.shared + ".h"), c_ident(args.shared),
+                             args.sources, palettes[args.format][0])
+
+
+if __name__ == "__main__":
+    main()
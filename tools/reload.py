@@ -0,0 +1,195 @@
+#!/usr/bin/env python3
+"""Send an image to a running device to show instead of its current one.
+
+    python3 tools/reload.py --port /dev/ttyUSB0 images/Mario.jpg:format=rgb332,pack=qoi
+    python3 tools/reload.py --port /dev/ttyUSB0 --archive screens.bin mountains
+    python3 tools/reload.py --loopback images/Mountains.png:format=pal8
+
+converts the image as tools/archive.py would (same options after a colon,
+same -f/-p/-d/--resize defaults) or takes an entry from an archive as it
+is, and sends it in a RELOAD_IMAGE frame (see reload.h). The device
+unpacks it if packed and swaps it in at the next vblank. The UART is
+shared with stdio, so printf output from the device is passed through.
+
+--loopback builds reload.c with RELOAD_HOST and talks to that instead of
+a device, then checks that what it unpacked matches the image converted
+without packing, and that a damaged frame is refused.
+--port needs pyserial.
+"""
+
+import argparse
+import os
+import shlex
+import shutil
+import struct
+import subprocess
+import sys
+import tempfile
+import time
+import zlib
+
+from archive import ENTRY, HEADER, MAGIC, VERSION, convert, parse_spec
+from dither import METHODS
+from imgconv import FORMATS, PACKS, rgb565_word
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+# Must match reload.h.
+IMAGE = 1
+IMAGE_HEADER = struct.Struct("<HHIBBHI")
+STATUS = ["ok", "damaged in transit", "does not fit in RAM", "not displayable", "unknown frame type",
+          "timed out"]
+
+
+def frame(kind, payload):
+    body = struct.pack("<BI", kind, len(payload)) + payload
+    return b"RL" + body + struct.pack("<I", zlib.crc32(body))
+
+
+def image_payload(width, height, stride, fmt, pack, palette_words, data):
+    pal = b"".join(struct.pack("<H", w) for w in palette_words)
+    pal += bytes(-len(pal) % 4)
+    return IMAGE_HEADER.pack(width, height, stride, FORMATS[fmt], PACKS[pack], len(palette_words),
+                             len(data)) + pal + data
+
+
+def from_archive(path, name):
+    """The payload for an archive entry, unchanged."""
+    with open(path, "rb") as f:
+        data = f.read()
+    magic, version, count, _ = HEADER.unpack_from(data)
+    if magic != MAGIC or version != VERSION:
+        sys.exit("reload: %s is not an archive" % path)
+    formats = {v: k for k, v in FORMATS.items()}
+    packs = {v: k for k, v in PACKS.items()}
+    for i in range(count):
+        entry, offset, size, width, height, stride, fmt, pack, colours, pal_at = \
+            ENTRY.unpack_from(data, HEADER.size + i * ENTRY.size)
+        if entry.rstrip(b"\0").decode() == name:
+            words = struct.unpack_from("<%dH" % colours, data, pal_at) if colours else ()
+            return image_payload(width, height, stride, formats[fmt], packs[pack], words,
+                                 data[offset:offset + size])
+    sys.exit("reload: no %s in %s" % (name, path))
+
+
+class Serial:
+    def __init__(self, port, baud):
+        import serial
+        self.link = serial.Serial(port, baud, timeout=0.1)
+
+    def write(self, data):
+        self.link.write(data)
+
+    def read(self):
+        return self.link.read(256)
+
+
+class Loopback:
+    """reload.c built for the host, on the other end of a pipe."""
+
+    def __init__(self, cc, cflags, shown):
+        self.tmp = tempfile.mkdtemp(prefix="reload.")
+        exe = os.path.join(self.tmp, "reload")
+        subprocess.run([cc] + shlex.split(cflags) +
+                       ["-DRELOAD_HOST", "-I", ROOT, "-I", os.path.join(ROOT, "assets"),
+                        os.path.join(ROOT, "reload.c"), os.path.join(ROOT, "capture.c"),
+                        os.path.join(ROOT, "assets", "asset.c"),
+                        "-o", exe], check=True)
+        self.proc = subprocess.Popen([exe, shown], stdin=subprocess.PIPE, stdout=subprocess.PIPE)
+        os.set_blocking(self.proc.stdout.fileno(), False)
+
+    def write(self, data):
+        self.proc.stdin.write(data)
+        self.proc.stdin.flush()
+
+    def read(self):
+        time.sleep(0.001)
+        return self.proc.stdout.read() or b""
+
+    def close(self):
+        self.proc.stdin.close()
+        self.proc.wait()
+        shutil.rmtree(self.tmp)
+
+
+def send(link, kind, payload, timeout=5.0):
+    """Send a frame of kind (or, with kind None, an image frame already
+    made) and return the device's status, passing other output on."""
+    link.write(payload if kind is None else frame(kind, payload))
+    reply = b"rl" + bytes([IMAGE if kind is None else kind])
+    pending = b""
+    deadline = time.monotonic() + timeout
+    while time.monotonic() < deadline:
+        pending += link.read()
+        at = pending.find(reply)
+        if at >= 0 and len(pending) >= at + 4:
+            sys.stdout.write(pending[:at].decode(errors="replace"))
+            return pending[at + 3]
+    sys.stdout.write(pending.decode(errors="replace"))
+    return None
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("source", metavar="SOURCE[:OPTION=VALUE,...] | NAME")
+    link = ap.add_mutually_exclusive_group(required=True)
+    link.add_argument("--port", help="serial device of the board's UART")
+    link.add_argument("--loopback", action="store_true", help="talk to reload.c built for the host")
+    ap.add_argument("--baud", type=int, default=115200)
+    ap.add_argument("--archive", help="send the entry called SOURCE from this archive")
+    ap.add_argument("-f", "--format", choices=FORMATS, default="rgb332")
+    ap.add_argument("-p", "--pack", choices=PACKS, default="qoi")
+    ap.add_argument("-d", "--dither", choices=METHODS, default="none")
+    ap.add_argument("--resize", metavar="WxH")
+    ap.add_argument("-j", "--jobs", type=int, help="workers (default: CPU count)")
+    ap.add_argument("--cc", default=os.environ.get("CC", "cc"), help="host compiler for --loopback")
+    ap.add_argument("--cflags", default="-O2")
+    args = ap.parse_args()
+
+    raw = None
+    if args.archive:
+        payload = from_archive(args.archive, args.source)
+    else:
+        entry = parse_spec(args.source, {"format": args.format, "pack": args.pack, "dither": args.dither,
+                                         "colours": None, "crop": None, "resize": args.resize})
+        width, height, stride, palette, data = convert(entry, args.jobs)
+        payload = image_payload(width, height, stride, entry["format"], entry["pack"],
+                                [rgb565_word(*c) for c in palette or []], data)
+        if args.loopback:
+            raw = convert(dict(entry, pack="none"), args.jobs)[4]
+    width, height, _, fmt, pack, _, _ = IMAGE_HEADER.unpack_from(payload)
+    print("%dx%d %s %s, %d bytes to send, %.1f s at %d baud"
+          % (width, height, [k for k, v in FORMATS.items() if v == fmt][0],
+             [k for k, v in PACKS.items() if v == pack][0], len(payload) + 14,
+             (len(payload) + 14) * 10 / args.baud, args.baud))
+
+    if args.port:
+        status = send(Serial(args.port, args.baud), IMAGE, payload,
+                      timeout=5 + (len(payload) + 14) * 10 / args.baud)
+        print("device: %s" % ("no reply" if status is None else STATUS[status]))
+        sys.exit(status != 0)
+
+    shown = tempfile.NamedTemporaryFile(suffix=".raw", delete=False).name
+    loop = Loopback(args.cc, args.cflags, shown)
+    try:
+        start = time.monotonic()
+        status = send(loop, IMAGE, payload)
+        elapsed = time.monotonic() - start
+        print("loopback: %s in %.1f ms" % ("no reply" if status is None else STATUS[status], 1000 * elapsed))
+        bad = bytearray(frame(IMAGE, payload))
+        bad[len(bad) // 2] ^= 1
+        damaged = send(loop, None, bytes(bad))
+        with open(shown, "rb") as f:
+            got = f.read()
+        ok = status == 0 and damaged == 1 and (raw is None or got == raw)
+        print("loopback: damaged frame %s, unpacked image %s"
+              % ("refused" if damaged == 1 else "NOT REFUSED",
+                 "unchecked" if raw is None else "matches" if got == raw else "DIFFERS"))
+    finally:
+        loop.close()
+        os.unlink(shown)
+    sys.exit(not ok)
+
+
+if __name__ == "__main__":
+    main()
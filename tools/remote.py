@@ -0,0 +1,204 @@
+#!/usr/bin/env python3
+"""Drive the display remotely, sending only what changed between frames.
+
+    python3 tools/remote.py --loopback --demo 120
+    python3 tools/remote.py --port /dev/ttyUSB0 --baud 921600 screen*.png
+
+sends the first frame as a RELOAD_IMAGE and each later one as a
+RELOAD_UPDATE (see reload.h): the 16x16 tiles that changed are merged into
+rectangles, and each rectangle goes either as raw pixels or as the
+run-length coded XOR against what the device shows, whichever is smaller.
+When an update is over FULL_CHECK bytes and the whole frame packed with
+QOI would be smaller, the whole frame is sent instead. --demo N makes N frames of a box bouncing
+over images/Mario.jpg with a progress bar, instead of reading images.
+
+Prints the bytes sent against full frames and the latency of each
+update: encoding here, the time on the wire at --baud, and the time until
+the device (or with --loopback, reload.c built for the host) answered.
+With --loopback, the device's framebuffer is checked against the last
+frame at the end.
+"""
+
+import argparse
+import os
+import struct
+import sys
+import tempfile
+import time
+
+import numpy as np
+
+from imgconv import encode, load, pad_lines, qoi_pack, rle_line
+from reload import IMAGE, STATUS, Loopback, Serial, image_payload, send
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+# Must match reload.h.
+UPDATE = 2
+RECT = struct.Struct("<HHHHIB3x")
+RECT_RAW, RECT_XOR = 0, 1
+FRAME_BYTES = 14  # magic, type, length and CRC around a payload
+TILE = 16
+# Updates smaller than this are sent without trying a whole frame.
+FULL_CHECK = 4096
+
+
+def pixels(rgb, fmt):
+    """Frame as an HxW array of pixel units."""
+    lines, _ = encode(rgb, fmt)
+    return lines.view("<u2") if fmt == "rgb565" else lines
+
+
+def demo_frames(count, fmt):
+    background = load(os.path.join(ROOT, "images", "Mario.jpg"), resize=(640, 480))
+    h, w = background.shape[:2]
+    x, y, dx, dy, size = 40, 60, 7, 5, 48
+    for n in range(count):
+        rgb = background.copy()
+        rgb[y:y + size, x:x + size] = (255, 255, 0)
+        rgb[h - 24:h - 8, 16:w - 16] = (32, 32, 32)
+        rgb[h - 24:h - 8, 16:16 + (w - 32) * (n + 1) // count] = (0, 200, 255)
+        yield pixels(rgb, fmt)
+        if not 0 <= x + dx <= w - size:
+            dx = -dx
+        if not 0 <= y + dy <= h - 32 - size:
+            dy = -dy
+        x, y = x + dx, y + dy
+
+
+def file_frames(paths, fmt):
+    for path in paths:
+        yield pixels(load(path), fmt)
+
+
+def dirty_rects(prev, cur):
+    """Rectangles (x, y, w, h) covering the changed pixels: rows of changed
+    tiles merged across, then with the band below when they line up."""
+    h, w = cur.shape
+    changed = prev != cur
+    th, tw = -(-h // TILE), -(-w // TILE)
+    padded = np.zeros((th * TILE, tw * TILE), bool)
+    padded[:h, :w] = changed
+    tiles = padded.reshape(th, TILE, tw, TILE).any(axis=(1, 3))
+    rects, open_rects = [], {}
+    for ty in range(th):
+        row = {}
+        tx = 0
+        while tx < tw:
+            if not tiles[ty, tx]:
+                tx += 1
+                continue
+            start = tx
+            while tx < tw and tiles[ty, tx]:
+                tx += 1
+            span = (start, tx)
+            r = open_rects.pop(span, None)
+            row[span] = [start, r[1] if r else ty, tx, ty + 1]
+        rects += open_rects.values()
+        open_rects = row
+    rects += open_rects.values()
+    return [(x0 * TILE, y0 * TILE, min(x1 * TILE, w) - x0 * TILE, min(y1 * TILE, h) - y0 * TILE)
+            for x0, y0, x1, y1 in rects]
+
+
+def update_payload(prev, cur):
+    """RELOAD_UPDATE payload taking prev to cur, and the rectangles."""
+    out = bytearray()
+    rects = dirty_rects(prev, cur)
+    for x, y, w, h in rects:
+        new = cur[y:y + h, x:x + w]
+        raw = new.tobytes()
+        xor = rle_line((prev[y:y + h, x:x + w] ^ new).tobytes(), 1)
+        kind, data = (RECT_XOR, xor) if len(xor) < len(raw) else (RECT_RAW, raw)
+        out += RECT.pack(x, y, w, h, len(data), kind) + data
+    return bytes(out), rects
+
+
+def full_payload(cur, fmt):
+    lines, stride = pad_lines(cur.view(np.uint8))
+    h, w = cur.shape
+    return image_payload(w, h, stride, fmt, "qoi", [], qoi_pack(lines.tobytes(), fmt))
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("frames", nargs="*", help="images, shown in order")
+    ap.add_argument("--demo", type=int, metavar="N", help="send N generated frames instead")
+    link = ap.add_mutually_exclusive_group(required=True)
+    link.add_argument("--port", help="serial device of the board's UART")
+    link.add_argument("--loopback", action="store_true", help="talk to reload.c built for the host")
+    ap.add_argument("--baud", type=int, default=115200)
+    ap.add_argument("-f", "--format", choices=("rgb332", "rgb565"), default="rgb332")
+    ap.add_argument("--cc", default=os.environ.get("CC", "cc"), help="host compiler for --loopback")
+    ap.add_argument("--cflags", default="-O2")
+    args = ap.parse_args()
+    if bool(args.frames) == bool(args.demo):
+        ap.error("give either images or --demo")
+
+    frames = demo_frames(args.demo, args.format) if args.demo else file_frames(args.frames, args.format)
+    shown = None
+    if args.loopback:
+        shown = tempfile.NamedTemporaryFile(suffix=".raw", delete=False).name
+        link = Loopback(args.cc, args.cflags, shown)
+    else:
+        link = Serial(args.port, args.baud)
+
+    prev = None
+    sent = raw_total = qoi_total = update_bytes = 0
+    latencies, updates, fulls = [], 0, 0
+    try:
+        for n, cur in enumerate(frames):
+            start = time.monotonic()
+            if prev is None:
+                payload, kind = full_payload(cur, args.format), IMAGE
+            else:
+                payload, rects = update_payload(prev, cur)
+                kind = UPDATE
+                if len(payload) > FULL_CHECK:
+                    full = full_payload(cur, args.format)
+                    if len(full) < len(payload):
+                        payload, kind = full, IMAGE
+            encoded = time.monotonic()
+            status = send(link, kind, payload, timeout=5 + (len(payload) + FRAME_BYTES) * 10 / args.baud)
+            answered = time.monotonic()
+            if status != 0:
+                sys.exit("remote: frame %d: %s" % (n, "no reply" if status is None else STATUS[status]))
+            wire = (len(payload) + FRAME_BYTES) * 10 / args.baud
+            if n:
+                latencies.append((encoded - start) + wire + (answered - encoded))
+                update_bytes += len(payload) + FRAME_BYTES
+                updates += kind == UPDATE
+                fulls += kind == IMAGE
+            sent += len(payload) + FRAME_BYTES
+            raw_total += cur.nbytes
+            # For the report only, so not timed.
+            qoi_total += len(full_payload(cur, args.format)) + FRAME_BYTES
+            if args.demo is None or n < 3:
+                print("frame %3d: %-6s %7d bytes%s, encode %.1f ms, wire %.1f ms, device %.1f ms"
+                      % (n, "update" if kind == UPDATE else "image", len(payload) + FRAME_BYTES,
+                         " in %d rects" % len(rects) if kind == UPDATE else "",
+                         1000 * (encoded - start), 1000 * wire, 1000 * (answered - encoded)))
+            prev = cur
+    finally:
+        if args.loopback:
+            link.close()
+
+    count = n + 1
+    print("%d frames: %d bytes sent, against %d raw (%.1f%%) and %d as QOI images (%.1f%%)"
+          % (count, sent, raw_total, 100.0 * sent / raw_total, qoi_total, 100.0 * sent / qoi_total))
+    if latencies:
+        print("after the first: %d updates, %d full frames; latency mean %.1f ms, max %.1f ms; "
+              "%.1f frames/s at %d baud" % (updates, fulls, 1000 * np.mean(latencies), 1000 * max(latencies),
+                                            len(latencies) / (update_bytes * 10 / args.baud), args.baud))
+    if shown:
+        with open(shown, "rb") as f:
+            got = f.read()
+        os.unlink(shown)
+        lines, _ = pad_lines(prev.view(np.uint8))
+        ok = got == lines.tobytes()
+        print("loopback: device framebuffer %s the last frame" % ("matches" if ok else "DIFFERS from"))
+        sys.exit(not ok)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,50 @@
+#!/usr/bin/env python3
+"""Test the video memory allocator in dvi_hstx/vmem.c on the host.
+
+    python3 tools/test_vmem.py [--cc clang] [--cflags "-O2"]
+
+Builds dvi_hstx/vmem_test.c against vmem.c with the host compiler and runs
+it: alignment, exhaustion, O(1) reset, mark/release and slot pools, then
+checks the usage line vmem_report() prints. Exits non-zero on failure.
+"""
+
+import argparse
+import os
+import re
+import shlex
+import shutil
+import subprocess
+import sys
+import tempfile
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+REPORT = re.compile(r"vmem report\s+\S+: +200 / +1000 bytes used, high water +300, 2 allocs, 1 failed$", re.M)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("--cc", default=os.environ.get("CC", "cc"))
+    ap.add_argument("--cflags", default="-O2 -Wall -Wextra -std=c11")
+    args = ap.parse_args()
+
+    src = os.path.join(ROOT, "dvi_hstx")
+    tmp = tempfile.mkdtemp(prefix="test_vmem.")
+    try:
+        exe = os.path.join(tmp, "test_vmem")
+        subprocess.run([args.cc] + shlex.split(args.cflags) +
+                       ["-I", src, os.path.join(src, "vmem_test.c"), os.path.join(src, "vmem.c"), "-o", exe],
+                       check=True)
+        run = subprocess.run([exe], capture_output=True, text=True)
+    finally:
+        shutil.rmtree(tmp)
+    sys.stdout.write(run.stdout)
+    ok = run.returncode == 0
+    if not REPORT.search(run.stdout):
+        print("FAIL vmem_report(): unexpected usage line")
+        ok = False
+    sys.exit(0 if ok else 1)
+
+
+if __name__ == "__main__":
+    main()
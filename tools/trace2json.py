@@ -0,0 +1,133 @@
+#!/usr/bin/env python3
+"""Convert a trace_dump() capture into Chrome trace JSON.
+
+Capture the UART output of a DVI_TRACE=1 build after sending 't', then:
+
+    python3 tools/trace2json.py capture.txt -o trace.json
+
+Open trace.json in chrome://tracing or https://ui.perfetto.dev. Lines that
+are not part of the dump (normal printf output) are ignored, so the whole
+serial log can be passed in.
+"""
+
+import argparse
+import json
+import sys
+
+# Must match trace_event_id_t in trace.h.
+EV_IRQ_ENTER = 0
+EV_IRQ_EXIT = 1
+EV_VBLANK = 2
+EV_BUFFER_SWAP = 3
+EV_TASK_BEGIN = 4
+EV_TASK_END = 5
+EV_MARK = 6
+
+# Must match the TRACE_TASK_* ids in trace.h.
+TASK_NAMES = {0: "main_loop", 1: "render"}
+
+
+def parse_dump(lines):
+    """Return (clk_hz, now, events) for the last complete dump in lines.
+
+    events is a list of (core, timestamp, id, arg) in dump order.
+    """
+    clk_hz = None
+    now = None
+    events = None
+    current = None
+    for line in lines:
+        line = line.strip()
+        if line.startswith("# trace v1"):
+            fields = dict(f.split("=", 1) for f in line.split()[3:] if "=" in f)
+            clk_hz = int(fields["clk_hz"])
+            now = int(fields["now"], 16)
+            current = []
+        elif line.startswith("# end") and current is not None:
+            events = current
+            current = None
+        elif line.startswith("E ") and current is not None:
+            _, core, ts, ev, arg = line.split()
+            current.append((int(core), int(ts, 16), int(ev), int(arg)))
+    if events is None:
+        raise ValueError("no complete trace dump found")
+    return clk_hz, now, events
+
+
+def unwrap(now, events):
+    """Extend the 32-bit cycle timestamps to 64 bits.
+
+    Walking each core's events newest first, every timestamp is the latest
+    64-bit time not after its successor (or the dump time) with matching low
+    bits. This is exact as long as no two consecutive events on a core are
+    more than 2^32 cycles apart.
+    """
+    out = [None] * len(events)
+    bound = {}
+    for i in range(len(events) - 1, -1, -1):
+        core, ts, ev, arg = events[i]
+        upper = bound.get(core, now)
+        full = (upper & ~0xffffffff) | ts
+        if full > upper:
+            full -= 1 << 32
+        bound[core] = full
+        out[i] = (core, full, ev, arg)
+    return out
+
+
+def to_chrome(clk_hz, now, events, task_names):
+    events = unwrap(now, events)
+    t0 = min(e[1] for e in events) if events else 0
+    trace = []
+    for core in sorted({e[0] for e in events}):
+        trace.append({"name": "thread_name", "ph": "M", "pid": 0, "tid": core,
+                      "args": {"name": "core %d" % core}})
+    for core, ts, ev, arg in events:
+        us = (ts - t0) * 1e6 / clk_hz
+        rec = {"pid": 0, "tid": core, "ts": us}
+        if ev == EV_IRQ_ENTER:
+            rec.update(name="dma_irq", ph="B", args={"scanline": arg})
+        elif ev == EV_IRQ_EXIT:
+            rec.update(name="dma_irq", ph="E")
+        elif ev in (EV_TASK_BEGIN, EV_TASK_END):
+            rec.update(name=task_names.get(arg, "task %d" % arg),
+                       ph="B" if ev == EV_TASK_BEGIN else "E")
+        elif ev == EV_VBLANK:
+            rec.update(name="vblank", ph="i", s="g", args={"frame": arg})
+        elif ev == EV_BUFFER_SWAP:
+            rec.update(name="buffer_swap", ph="i", s="p", args={"buffer": arg})
+        elif ev == EV_MARK:
+            rec.update(name="mark", ph="i", s="t", args={"arg": arg})
+        else:
+            rec.update(name="event %d" % ev, ph="i", s="t", args={"arg": arg})
+        trace.append(rec)
+    # Chrome expects B/E pairs in time order within a thread.
+    trace.sort(key=lambda r: (r.get("ts", -1), r["tid"]))
+    return {"traceEvents": trace, "displayTimeUnit": "ns"}
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("dump", nargs="?", help="captured UART log (default: stdin)")
+    ap.add_argument("-o", "--output", help="output JSON file (default: stdout)")
+    ap.add_argument("--task", action="append", default=[], metavar="ID=NAME",
+                    help="name an application task id, may be repeated")
+    args = ap.parse_args()
+
+    task_names = dict(TASK_NAMES)
+    for t in args.task:
+        tid, name = t.split("=", 1)
+        task_names[int(tid, 0)] = name
+
+    src = open(args.dump) if args.dump else sys.stdin
+    with src:
+        clk_hz, now, events = parse_dump(src)
+    out = to_chrome(clk_hz, now, events, task_names)
+    dst = open(args.output, "w") if args.output else sys.stdout
+    with dst:
+        json.dump(out, dst, indent=1)
+        dst.write("\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,55 @@
+// UART receive ring, see uart_rx.h.
+
+#include "uart_rx.h"
+#include "hardware/irq.h"
+
+static_assert((UART_RX_RING_SIZE & (UART_RX_RING_SIZE - 1)) == 0, "UART_RX_RING_SIZE must be a power of two");
+
+static uart_inst_t *rx_uart;
+static uint8_t ring[UART_RX_RING_SIZE];
+// Free-running; the IRQ only writes head and core 0 only writes tail.
+static volatile uint32_t head, tail;
+static volatile uint32_t dropped;
+
+static void __not_in_flash_func(uart_rx_irq)(void)
+{
+    uart_hw_t *hw = uart_get_hw(rx_uart);
+    uint32_t h = head;
+    while (!(hw->fr & UART_UARTFR_RXFE_BITS))
+    {
+        uint32_t dr = hw->dr;
+        if (dr & UART_UARTDR_OE_BITS)
+            ++dropped;
+        if (h - tail == UART_RX_RING_SIZE)
+            ++dropped;
+        else
+            ring[h++ % UART_RX_RING_SIZE] = (uint8_t)dr;
+    }
+    head = h;
+}
+
+void uart_rx_init(uart_inst_t *uart)
+{
+    rx_uart = uart;
+    uint irq = uart_get_index(uart) ? UART1_IRQ : UART0_IRQ;
+    irq_set_exclusive_handler(irq, uart_rx_irq);
+    irq_set_enabled(irq, true);
+    uart_set_irqs_enabled(uart, true, false);
+}
+
+size_t uart_rx_read(uint8_t *buf, size_t n)
+{
+    uint32_t t = tail;
+    uint32_t avail = head - t;
+    if (n > avail)
+        n = avail;
+    for (size_t i = 0; i < n; ++i)
+        buf[i] = ring[(t + i) % UART_RX_RING_SIZE];
+    tail = t + n;
+    return n;
+}
+
+uint32_t uart_rx_dropped(void)
+{
+    return dropped;
+}
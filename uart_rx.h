@@ -0,0 +1,38 @@
+// Interrupt-driven UART receive into a ring buffer, so bytes arriving
+// while core 0 is busy (drawing a screenful of terminal output, say) are
+// kept instead of overrunning the UART's 32-byte FIFO.
+//
+// The IRQ empties the FIFO into the ring on its receive and timeout
+// interrupts; uart_rx_read() takes bytes out on core 0. Bytes that find the
+// ring full, and bytes the FIFO lost before the IRQ ran, are counted rather
+// than reported. Transmit is untouched, so printf keeps working on the same
+// UART; stdio reads of it get nothing once the ring owns the receiver.
+
+#ifndef _UART_RX_H
+#define _UART_RX_H
+
+#include "hardware/uart.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// A power of two. At 115200 baud, 8 KB is 0.7 s of continuous input.
+#ifndef UART_RX_RING_SIZE
+#define UART_RX_RING_SIZE 8192
+#endif
+
+// Take over receive on uart, an initialised UART, on the calling core.
+void uart_rx_init(uart_inst_t *uart);
+
+// Copy up to n received bytes to buf, returning how many.
+size_t uart_rx_read(uint8_t *buf, size_t n);
+
+// Bytes lost so far to a full ring or a FIFO overrun.
+uint32_t uart_rx_dropped(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif